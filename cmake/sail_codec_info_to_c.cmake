@@ -0,0 +1,315 @@
+# Intended to be included by the combined codecs library. Converts a codec info file
+# into static C definitions, so SAIL doesn't need to parse codec info files in runtime.
+#
+# Usage:
+#
+#   sail_codec_info_to_c(CODEC png FILE sail-codec-png.codec.info PRIORITY png_priority DEFINITIONS png_definitions)
+#
+# Sets the PRIORITY variable to the codec priority (for example, HIGHEST) and the DEFINITIONS
+# variable to C definitions of a 'static const struct sail_codec_info <CODEC>_codec_info' object.
+#
+# Codec info errors are reported at configure time. Unknown pixel formats, compressions,
+# and codec features are reported at compile time.
+#
+function(sail_codec_info_to_c)
+    cmake_parse_arguments(SAIL_CODEC_INFO "" "CODEC;FILE;PRIORITY;DEFINITIONS" "" ${ARGN})
+
+    set(prefix ${SAIL_CODEC_INFO_CODEC})
+
+    # Parse the codec info file the same way as the INIH parser does. Every found value
+    # is stored in the '<section>/<key>' variable. Empty values are ignored.
+    #
+    set(known_keys codec/layout codec/version codec/priority codec/name codec/description
+                   codec/magic-numbers codec/extensions codec/mime-types
+                   load-features/features load-features/tuning
+                   save-features/features save-features/pixel-formats save-features/compressions
+                   save-features/default-compression save-features/compression-level-min
+                   save-features/compression-level-max save-features/compression-level-default
+                   save-features/compression-level-step save-features/tuning)
+
+    file(READ ${SAIL_CODEC_INFO_FILE} contents)
+
+    set(section "")
+
+    while (NOT contents STREQUAL "")
+        string(FIND "${contents}" "\n" line_end)
+
+        if (line_end EQUAL -1)
+            set(line "${contents}")
+            set(contents "")
+        else()
+            string(SUBSTRING "${contents}" 0 ${line_end} line)
+            math(EXPR line_end "${line_end} + 1")
+            string(SUBSTRING "${contents}" ${line_end} -1 contents)
+        endif()
+
+        string(STRIP "${line}" line)
+
+        if (line STREQUAL "" OR line MATCHES "^[#;]")
+            continue()
+        elseif (line MATCHES "^\\[(.*)\\]$")
+            set(section "${CMAKE_MATCH_1}")
+        elseif (line MATCHES "^([^=:]+)[=:](.*)$")
+            string(STRIP "${CMAKE_MATCH_1}" key)
+            string(STRIP "${CMAKE_MATCH_2}" value)
+
+            if (NOT "${section}/${key}" IN_LIST known_keys)
+                message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Unsupported codec info key '${key}' in [${section}]")
+            endif()
+
+            set("${section}/${key}" "${value}")
+        else()
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Failed to parse line '${line}'")
+        endif()
+    endwhile()
+
+    # Validate the codec info like SAIL does in runtime for codecs loaded from disk
+    #
+    foreach (key codec/layout codec/version codec/priority codec/name codec/description)
+        if ("${${key}}" STREQUAL "")
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: '${key}' is empty")
+        endif()
+    endforeach()
+
+    if (NOT "${codec/layout}" MATCHES "^[0-9]+$")
+        message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Invalid codec layout '${codec/layout}'")
+    endif()
+
+    if (NOT "${codec/priority}" MATCHES "^(HIGHEST|HIGH|MEDIUM|LOW|LOWEST)$")
+        message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Failed to parse codec priority '${codec/priority}'")
+    endif()
+
+    if ("${codec/name}" MATCHES "[a-z]")
+        message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has lowercase letters in its name")
+    endif()
+
+    if ("${codec/magic-numbers}" STREQUAL "" AND "${codec/extensions}" STREQUAL "" AND "${codec/mime-types}" STREQUAL "")
+        message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has no identification method (magic number or extension or mime type)")
+    endif()
+
+    foreach (magic_number IN LISTS codec/magic-numbers)
+        string(REGEX MATCHALL "[^ \t]+" magic_number_bytes "${magic_number}")
+        list(LENGTH magic_number_bytes magic_number_length)
+
+        foreach (magic_number_byte IN LISTS magic_number_bytes)
+            if (NOT magic_number_byte MATCHES "^(\\?.?|[0-9a-fA-F][0-9a-fA-F]?)$")
+                set(magic_number_length 0)
+            endif()
+        endforeach()
+
+        if (magic_number_length EQUAL 0 OR magic_number_length GREATER SAIL_MAGIC_BUFFER_SIZE)
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Magic number '${magic_number}' is invalid or too long")
+        endif()
+    endforeach()
+
+    if (NOT "${save-features/features}" STREQUAL "")
+        if ("${save-features/pixel-formats}" STREQUAL "")
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec is able to save images, but output pixel formats are not specified")
+        endif()
+
+        if ("${save-features/compressions}" STREQUAL "")
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has empty compressions list")
+        endif()
+    endif()
+
+    set(has_compression_level FALSE)
+
+    foreach (level min max default step)
+        if (NOT "${save-features/compression-level-${level}}" STREQUAL "")
+            set(has_compression_level TRUE)
+
+            if (NOT "${save-features/compression-level-${level}}" MATCHES "^[-+]?[0-9]+(\\.[0-9]*)?$")
+                message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: Invalid compression level '${save-features/compression-level-${level}}'")
+            endif()
+        else()
+            set("save-features/compression-level-${level}" 0)
+        endif()
+    endforeach()
+
+    if (has_compression_level)
+        if (save-features/compression-level-min GREATER save-features/compression-level-max)
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has incorrect compression levels")
+        endif()
+
+        list(LENGTH save-features/compressions compressions_length)
+
+        if (compressions_length GREATER 1 AND (NOT save-features/compression-level-min EQUAL 0 OR NOT save-features/compression-level-max EQUAL 0))
+            message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has more than two compression types and non-zero compression levels which is unsupported")
+        endif()
+    endif()
+
+    if (NOT "${save-features/compressions}" STREQUAL "" AND "${save-features/default-compression}" STREQUAL "")
+        message(FATAL_ERROR "${SAIL_CODEC_INFO_FILE}: ${codec/name} codec has UNKNOWN default compression")
+    endif()
+
+    # Generate definitions
+    #
+    set(definitions "/* ${codec/name} */\n")
+
+    _sail_codec_info_string_node_chain(codec/magic-numbers ${prefix}_magic_numbers TRUE)
+    _sail_codec_info_string_node_chain(codec/extensions    ${prefix}_extensions    TRUE)
+    _sail_codec_info_string_node_chain(codec/mime-types    ${prefix}_mime_types    TRUE)
+
+    _sail_codec_info_string_node_chain(load-features/tuning ${prefix}_load_tuning FALSE)
+    _sail_codec_info_flags(load-features/features load_features)
+
+    _sail_codec_info_enum_array(save-features/pixel-formats ${prefix}_pixel_formats SailPixelFormat SAIL_PIXEL_FORMAT_)
+    _sail_codec_info_enum_array(save-features/compressions  ${prefix}_compressions  SailCompression SAIL_COMPRESSION_)
+    _sail_codec_info_string_node_chain(save-features/tuning ${prefix}_save_tuning FALSE)
+    _sail_codec_info_flags(save-features/features save_features)
+
+    if ("${save-features/default-compression}" STREQUAL "")
+        set(default_compression "SAIL_COMPRESSION_UNKNOWN")
+    else()
+        string(REPLACE "-" "_" default_compression "SAIL_COMPRESSION_${save-features/default-compression}")
+    endif()
+
+    if (has_compression_level)
+        string(APPEND definitions "static const struct sail_compression_level ${prefix}_compression_level = {
+    .min_level     = ${save-features/compression-level-min},
+    .max_level     = ${save-features/compression-level-max},
+    .default_level = ${save-features/compression-level-default},
+    .step          = ${save-features/compression-level-step}
+};
+")
+        set(compression_level "(struct sail_compression_level *)&${prefix}_compression_level")
+    else()
+        set(compression_level "NULL")
+    endif()
+
+    _sail_codec_info_c_string("${codec/version}"     version)
+    _sail_codec_info_c_string("${codec/name}"        name)
+    _sail_codec_info_c_string("${codec/description}" description)
+
+    string(APPEND definitions "static const struct sail_load_features ${prefix}_load_features = {
+    .features = ${load_features},
+    .tuning   = ${${prefix}_load_tuning}
+};
+static const struct sail_save_features ${prefix}_save_features = {
+    .pixel_formats        = ${${prefix}_pixel_formats},
+    .pixel_formats_length = ${${prefix}_pixel_formats_length},
+    .features             = ${save_features},
+    .compressions         = ${${prefix}_compressions},
+    .compressions_length  = ${${prefix}_compressions_length},
+    .default_compression  = ${default_compression},
+    .compression_level    = ${compression_level},
+    .tuning               = ${${prefix}_save_tuning}
+};
+static const struct sail_codec_info ${prefix}_codec_info = {
+    .path              = NULL,
+    .layout            = ${codec/layout},
+    .priority          = SAIL_CODEC_PRIORITY_${codec/priority},
+    .version           = ${version},
+    .name              = ${name},
+    .description       = ${description},
+    .magic_number_node = ${${prefix}_magic_numbers},
+    .extension_node    = ${${prefix}_extensions},
+    .mime_type_node    = ${${prefix}_mime_types},
+    .load_features     = (struct sail_load_features *)&${prefix}_load_features,
+    .save_features     = (struct sail_save_features *)&${prefix}_save_features
+};
+
+")
+
+    set(${SAIL_CODEC_INFO_PRIORITY} ${codec/priority} PARENT_SCOPE)
+    set(${SAIL_CODEC_INFO_DEFINITIONS} "${definitions}" PARENT_SCOPE)
+endfunction()
+
+# Converts VALUE into a C string literal. The literal is cast to 'char *' as SAIL structures
+# hold non-const strings.
+#
+function(_sail_codec_info_c_string VALUE OUTPUT)
+    string(REPLACE "\\" "\\\\" value "${VALUE}")
+    string(REPLACE "\"" "\\\"" value "${value}")
+
+    set(${OUTPUT} "(char *)\"${value}\"" PARENT_SCOPE)
+endfunction()
+
+# The below macros append to the 'definitions' variable of sail_codec_info_to_c()
+# and set the expression to reference the generated object.
+
+# Generates a static string node chain. Sets NAME to a pointer to the chain or NULL.
+#
+macro(_sail_codec_info_string_node_chain KEY NAME TO_LOWER)
+    set(_strings "")
+
+    foreach (_string IN LISTS ${KEY})
+        if (NOT _string STREQUAL "")
+            if (${TO_LOWER})
+                string(TOLOWER "${_string}" _string)
+            endif()
+
+            list(APPEND _strings "${_string}")
+        endif()
+    endforeach()
+
+    list(LENGTH _strings _length)
+
+    if (_length EQUAL 0)
+        set(${NAME} "NULL")
+    else()
+        string(APPEND definitions "static const struct sail_string_node ${NAME}[] = {\n")
+        set(_index 0)
+
+        foreach (_string IN LISTS _strings)
+            math(EXPR _index "${_index} + 1")
+            _sail_codec_info_c_string("${_string}" _string)
+
+            if (_index EQUAL _length)
+                string(APPEND definitions "    { ${_string}, NULL }\n")
+            else()
+                string(APPEND definitions "    { ${_string}, (struct sail_string_node *)&${NAME}[${_index}] },\n")
+            endif()
+        endforeach()
+
+        string(APPEND definitions "};\n")
+        set(${NAME} "(struct sail_string_node *)${NAME}")
+    endif()
+endmacro()
+
+# Generates a static enum array. Sets NAME to a pointer to the array or NULL,
+# and NAME_length to the array length.
+#
+macro(_sail_codec_info_enum_array KEY NAME ENUM ENUM_PREFIX)
+    set(_values "")
+    set(_index 0)
+
+    foreach (_string IN LISTS ${KEY})
+        if (NOT _string STREQUAL "")
+            string(REPLACE "-" "_" _string "${ENUM_PREFIX}${_string}")
+            math(EXPR _index "${_index} + 1")
+            string(APPEND _values "    ${_string},\n")
+        endif()
+    endforeach()
+
+    set(${NAME}_length ${_index})
+
+    if (_index EQUAL 0)
+        set(${NAME} "NULL")
+    else()
+        string(APPEND definitions "static const enum ${ENUM} ${NAME}[] = {\n${_values}};\n")
+        set(${NAME} "(enum ${ENUM} *)${NAME}")
+    endif()
+endmacro()
+
+# Converts a list of codec features into an OR-ed C expression.
+#
+macro(_sail_codec_info_flags KEY OUTPUT)
+    set(${OUTPUT} "")
+
+    foreach (_string IN LISTS ${KEY})
+        if (NOT _string STREQUAL "")
+            string(REPLACE "-" "_" _string "SAIL_CODEC_FEATURE_${_string}")
+
+            if ("${${OUTPUT}}" STREQUAL "")
+                set(${OUTPUT} "${_string}")
+            else()
+                set(${OUTPUT} "${${OUTPUT}} | ${_string}")
+            endif()
+        endif()
+    endforeach()
+
+    if ("${${OUTPUT}}" STREQUAL "")
+        set(${OUTPUT} "0")
+    endif()
+endmacro()
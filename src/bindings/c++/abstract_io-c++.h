@@ -147,6 +147,23 @@ public:
      */
     virtual sail_status_t eof(bool *result) = 0;
 
+    /*
+     * Assigns a pointer to the unread contents of the underlying I/O object and its size
+     * without copying. The data is owned by the I/O object and stays valid until it's closed.
+     * I/O streams that support borrowing MUST report SAIL_IO_FEATURE_BORROWABLE in features().
+     *
+     * The default implementation returns SAIL_ERROR_NOT_IMPLEMENTED.
+     *
+     * Returns SAIL_OK on success.
+     */
+    virtual sail_status_t borrow(const void **data, std::size_t *data_size)
+    {
+        (void)data;
+        (void)data_size;
+
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    }
+
     /*
      * Finds and returns a first codec info object that can theoretically read the underlying
      * I/O stream into a valid image.
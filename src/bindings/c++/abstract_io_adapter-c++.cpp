@@ -114,6 +114,15 @@ static sail_status_t wrapped_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+static sail_status_t wrapped_borrow(void *stream, const void **data, size_t *data_size) {
+
+    sail::abstract_io &abstract_io = *reinterpret_cast<sail::abstract_io *&>(stream);
+
+    SAIL_TRY(abstract_io.borrow(data, data_size));
+
+    return SAIL_OK;
+}
+
 class SAIL_HIDDEN abstract_io_adapter::pimpl
 {
 public:
@@ -132,6 +141,7 @@ public:
         sail_io.flush          = wrapped_flush;
         sail_io.close          = wrapped_close;
         sail_io.eof            = wrapped_eof;
+        sail_io.borrow         = wrapped_borrow;
     }
 
     sail::abstract_io &abstract_io;
@@ -49,6 +49,7 @@ namespace sail
 class SAIL_EXPORT conversion_options
 {
     friend class image;
+    friend class row_converter;
 
 public:
     /*
@@ -112,6 +113,11 @@ public:
      */
     sail_rgb24_t background24() const;
 
+    /*
+     * Returns the number of threads to convert images with. 0 or 1 means the calling thread.
+     */
+    unsigned threads() const;
+
     /*
      * Sets new or-ed SailConversionOption-s. If zero, SAIL_CONVERSION_OPTION_DROP_ALPHA is assumed.
      */
@@ -129,6 +135,12 @@ public:
      */
     void set_background(const sail_rgb24_t &rgb24);
 
+    /*
+     * Sets the number of threads to convert images with, including the calling thread.
+     * 0 or 1 converts in the calling thread. Small images are always converted in the calling thread.
+     */
+    void set_threads(unsigned threads);
+
 private:
     sail_status_t to_sail_conversion_options(sail_conversion_options **conversion_options) const;
 
@@ -379,6 +379,23 @@ sail_status_t image::convert(SailPixelFormat pixel_format, const conversion_opti
         sail_img->palette->pixel_format = d->palette.pixel_format();
     }
 
+    /*
+     * Convert owned pixels in place when the output fits to avoid allocating a second buffer.
+     * Indexed images are not updated in place as a broken palette index would leave them
+     * partially converted.
+     */
+    if (!d->shallow_pixels
+            && !sail_is_indexed(d->sail_image->pixel_format)
+            && sail_greater_equal_bits_per_pixel(d->sail_image->pixel_format, pixel_format)) {
+        SAIL_TRY(sail_update_image_with_options(sail_img, pixel_format, sail_conversion_options));
+
+        d->sail_image->bytes_per_line = sail_img->bytes_per_line;
+        d->sail_image->pixel_format   = sail_img->pixel_format;
+        d->pixels_size                = sail_img->height * sail_img->bytes_per_line;
+
+        return SAIL_OK;
+    }
+
     sail_image *sail_image_output = nullptr;
     SAIL_TRY(sail_convert_image_with_options(sail_img, pixel_format, sail_conversion_options, &sail_image_output));
 
@@ -350,7 +350,9 @@ public:
      * Converts the image to the specified pixel format. Use can_convert() to quickly check if the conversion
      * can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. When the output pixels are not larger than
+     * the input pixels, non-indexed pixels owned by the image are converted in place without
+     * allocating a new buffer.
      *
      * Drops the input alpha channel if the output alpha channel doesn't exist. For example,
      * when converting RGBA pixels to RGB. If you need to control this behavior,
@@ -370,7 +372,9 @@ public:
      * Converts the image to the specified pixel format using the specified conversion options.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. When the output pixels are not larger than
+     * the input pixels, non-indexed pixels owned by the image are converted in place without
+     * allocating a new buffer.
      *
      * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
      * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
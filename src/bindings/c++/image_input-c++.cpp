@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <cstring>
 #include <memory>
 
 #include "sail-c++.h"
@@ -166,6 +167,15 @@ sail_status_t image_input::next_frame(sail::image *image)
     *image = sail::image(sail_image);
     sail_image->pixels = nullptr;
 
+    /* Convert images the codec couldn't output in the requested pixel format. */
+    const SailPixelFormat output_pixel_format = d->override_load_options
+                                                    ? d->load_options.output_pixel_format()
+                                                    : SAIL_PIXEL_FORMAT_UNKNOWN;
+
+    if (output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN && image->pixel_format() != output_pixel_format) {
+        SAIL_TRY(image->convert(output_pixel_format));
+    }
+
     return SAIL_OK;
 }
 
@@ -179,6 +189,47 @@ image image_input::next_frame()
     return image;
 }
 
+sail_status_t image_input::next_frame(sail::image *image, void *buffer, std::size_t buffer_length)
+{
+    if (d->state == nullptr) {
+        SAIL_TRY(d->start());
+    }
+
+    sail_image *sail_image = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_image(sail_image);
+    );
+
+    SAIL_TRY(sail_load_next_frame_into_buffer(d->state, buffer, buffer_length, &sail_image));
+
+    *image = sail::image(sail_image);
+    image->set_shallow_pixels(buffer);
+
+    /* Convert images the codec couldn't output in the requested pixel format back into the buffer. */
+    const SailPixelFormat output_pixel_format = d->override_load_options
+                                                    ? d->load_options.output_pixel_format()
+                                                    : SAIL_PIXEL_FORMAT_UNKNOWN;
+
+    if (output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN && image->pixel_format() != output_pixel_format) {
+        sail::image converted_image;
+        SAIL_TRY(image->convert_to(output_pixel_format, &converted_image));
+
+        if (converted_image.pixels_size() > buffer_length) {
+            SAIL_LOG_ERROR("The buffer of %lu bytes is too small to hold the converted frame of %u bytes",
+                           static_cast<unsigned long>(buffer_length), converted_image.pixels_size());
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+
+        std::memcpy(buffer, converted_image.pixels(), converted_image.pixels_size());
+        converted_image.set_shallow_pixels(buffer);
+
+        *image = std::move(converted_image);
+    }
+
+    return SAIL_OK;
+}
+
 sail_status_t image_input::finish()
 {
     sail_status_t saved_status = SAIL_OK;
@@ -105,6 +105,8 @@ public:
 
     /*
      * Continues loading the image. Assigns the loaded image to the 'image' argument.
+     * If the load options request an output pixel format the codec couldn't produce,
+     * converts the image into it.
      *
      * Returns SAIL_OK on success.
      * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
@@ -118,6 +120,20 @@ public:
      */
     image next_frame();
 
+    /*
+     * Continues loading the image into the specified caller-owned buffer instead of allocating
+     * a new one. Assigns the loaded image to the 'image' argument. The image pixels point to the buffer,
+     * so the buffer must remain valid as long as the image exists. See sail_load_next_frame_into_buffer().
+     *
+     * Like next_frame(sail::image*), converts the frame to the requested output pixel format
+     * when the codec ignores it. The converted frame must also fit into the buffer.
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+     * Returns SAIL_ERROR_INVALID_ARGUMENT when the buffer is too small to hold the frame.
+     */
+    sail_status_t next_frame(sail::image *image, void *buffer, std::size_t buffer_length);
+
     /*
      * Finishes loading and closes the I/O stream. Call to finish() is optional.
      *
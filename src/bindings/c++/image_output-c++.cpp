@@ -99,7 +99,7 @@ image_output::image_output(void *buffer, std::size_t buffer_length, const sail::
 }
 
 image_output::image_output(sail::arbitrary_data *arbitrary_data, const sail::codec_info &codec_info)
-    : image_output(arbitrary_data->data(), arbitrary_data->size(), codec_info)
+    : d(new pimpl(new io_arbitrary_data(*arbitrary_data), codec_info))
 {
 }
 
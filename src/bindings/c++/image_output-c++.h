@@ -68,7 +68,10 @@ public:
     image_output(void *buffer, std::size_t buffer_length, const sail::codec_info &codec_info);
 
     /*
-     * Constructs a new image output to the specified memory buffer.
+     * Constructs a new image output to the specified arbitrary data. The data is cleared
+     * and grows automatically while saving, so there is no need to preallocate it.
+     * Its capacity is kept, so reserve() can be used as a size hint. After finish()
+     * the data holds exactly the encoded image.
      */
     image_output(sail::arbitrary_data *arbitrary_data, const sail::codec_info &codec_info);
 
@@ -0,0 +1,176 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "sail-c++.h"
+#include "sail.h"
+
+namespace sail
+{
+
+io_arbitrary_data::io_arbitrary_data(sail::arbitrary_data &arbitrary_data)
+    : m_arbitrary_data(arbitrary_data)
+    , m_pos(0)
+{
+    m_arbitrary_data.clear();
+}
+
+std::uint64_t io_arbitrary_data::id() const
+{
+    return SAIL_ARBITRARY_DATA_IO_ID;
+}
+
+int io_arbitrary_data::features() const
+{
+    return SAIL_IO_FEATURE_SEEKABLE;
+}
+
+sail_status_t io_arbitrary_data::tolerant_read(void *buf, std::size_t size_to_read, std::size_t *read_size)
+{
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    *read_size = 0;
+
+    if (m_pos >= m_arbitrary_data.size()) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+    }
+
+    const std::size_t actual_size_to_read = std::min(size_to_read, m_arbitrary_data.size() - m_pos);
+
+    std::memcpy(buf, m_arbitrary_data.data() + m_pos, actual_size_to_read);
+    m_pos += actual_size_to_read;
+
+    *read_size = actual_size_to_read;
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::strict_read(void *buf, std::size_t size_to_read)
+{
+    std::size_t read_size;
+
+    SAIL_TRY(tolerant_read(buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::tolerant_write(const void *buf, std::size_t size_to_write, std::size_t *written_size)
+{
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(written_size);
+
+    const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(buf);
+
+    if (m_pos == m_arbitrary_data.size()) {
+        /* Appending is the common case. Avoid zero-filling the new bytes before copying. */
+        m_arbitrary_data.insert(m_arbitrary_data.end(), data, data + size_to_write);
+    } else {
+        if (m_pos + size_to_write > m_arbitrary_data.size()) {
+            m_arbitrary_data.resize(m_pos + size_to_write);
+        }
+
+        std::memcpy(m_arbitrary_data.data() + m_pos, data, size_to_write);
+    }
+
+    m_pos += size_to_write;
+    *written_size = size_to_write;
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::strict_write(const void *buf, std::size_t size_to_write)
+{
+    std::size_t written_size;
+
+    SAIL_TRY(tolerant_write(buf, size_to_write, &written_size));
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::seek(long offset, int whence)
+{
+    long base;
+
+    switch (whence) {
+        case SEEK_SET: base = 0;                                          break;
+        case SEEK_CUR: base = static_cast<long>(m_pos);                   break;
+        case SEEK_END: base = static_cast<long>(m_arbitrary_data.size()); break;
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    if (offset < -base) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    /* Seeking past the end is allowed. The gap is zero-filled on the next write. */
+    m_pos = static_cast<std::size_t>(base + offset);
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::tell(std::size_t *offset)
+{
+    SAIL_CHECK_PTR(offset);
+
+    *offset = m_pos;
+
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::flush()
+{
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::close()
+{
+    return SAIL_OK;
+}
+
+sail_status_t io_arbitrary_data::eof(bool *result)
+{
+    SAIL_CHECK_PTR(result);
+
+    *result = m_pos >= m_arbitrary_data.size();
+
+    return SAIL_OK;
+}
+
+sail::codec_info io_arbitrary_data::codec_info()
+{
+    return sail::codec_info::from_magic_number(m_arbitrary_data.data(), m_arbitrary_data.size());
+}
+
+}
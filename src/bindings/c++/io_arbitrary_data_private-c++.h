@@ -0,0 +1,82 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IO_ARBITRARY_DATA_PRIVATE_CPP_H
+#define SAIL_IO_ARBITRARY_DATA_PRIVATE_CPP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+
+    #include "abstract_io-c++.h"
+    #include "arbitrary_data-c++.h"
+#else
+    INTERNAL ERROR: For internal use only
+#endif
+
+namespace sail
+{
+
+/*
+ * SAIL_ARBITRARY_DATA_IO_ID = sail_string_hash("sail-arbitrary-data-io-id")
+ */
+static const std::uint64_t SAIL_ARBITRARY_DATA_IO_ID = UINT64_C(5465630355716767345);
+
+/*
+ * Write I/O stream into a growing arbitrary data vector. The vector is cleared on construction
+ * but keeps its capacity, so reserve() can be used as a size hint. Grows with the usual
+ * geometric vector growth and ends up exactly as large as the written data.
+ */
+class SAIL_HIDDEN io_arbitrary_data : public abstract_io
+{
+public:
+    explicit io_arbitrary_data(sail::arbitrary_data &arbitrary_data);
+
+    std::uint64_t id() const override;
+    int features() const override;
+
+    sail_status_t tolerant_read(void *buf, std::size_t size_to_read, std::size_t *read_size) override;
+    sail_status_t strict_read(void *buf, std::size_t size_to_read) override;
+    sail_status_t tolerant_write(const void *buf, std::size_t size_to_write, std::size_t *written_size) override;
+    sail_status_t strict_write(const void *buf, std::size_t size_to_write) override;
+    sail_status_t seek(long offset, int whence) override;
+    sail_status_t tell(std::size_t *offset) override;
+    sail_status_t flush() override;
+    sail_status_t close() override;
+    sail_status_t eof(bool *result) override;
+
+    sail::codec_info codec_info() override;
+
+private:
+    sail::arbitrary_data &m_arbitrary_data;
+    std::size_t m_pos;
+};
+
+}
+
+#endif
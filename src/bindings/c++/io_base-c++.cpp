@@ -106,4 +106,15 @@ sail_status_t io_base::eof(bool *result)
     return SAIL_OK;
 }
 
+sail_status_t io_base::borrow(const void **data, std::size_t *data_size)
+{
+    if (d->sail_io->borrow == nullptr) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    SAIL_TRY(d->sail_io->borrow(d->sail_io->stream, data, data_size));
+
+    return SAIL_OK;
+}
+
 }
@@ -155,6 +155,15 @@ public:
      */
     sail_status_t eof(bool *result) override;
 
+    /*
+     * Assigns a pointer to the unread contents of the underlying I/O object and its size
+     * without copying. Returns SAIL_ERROR_NOT_IMPLEMENTED if the underlying I/O object
+     * doesn't support borrowing.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t borrow(const void **data, std::size_t *data_size) override;
+
 protected:
     class pimpl;
     const std::unique_ptr<pimpl> d;
@@ -65,6 +65,7 @@ load_options& load_options::operator=(const sail::load_options &load_options)
 {
     set_options(load_options.options());
     set_tuning(load_options.tuning());
+    set_output_pixel_format(load_options.output_pixel_format());
 
     return *this;
 }
@@ -100,6 +101,11 @@ const sail::tuning& load_options::tuning() const
     return d->tuning;
 }
 
+SailPixelFormat load_options::output_pixel_format() const
+{
+    return d->sail_load_options->output_pixel_format;
+}
+
 void load_options::set_options(int options)
 {
     d->sail_load_options->options = options;
@@ -110,6 +116,11 @@ void load_options::set_tuning(const sail::tuning &tuning)
     d->tuning = tuning;
 }
 
+void load_options::set_output_pixel_format(SailPixelFormat output_pixel_format)
+{
+    d->sail_load_options->output_pixel_format = output_pixel_format;
+}
+
 load_options::load_options(const sail_load_options *ro)
     : load_options()
 {
@@ -120,6 +131,7 @@ load_options::load_options(const sail_load_options *ro)
 
     set_options(ro->options);
     set_tuning(utils_private::c_tuning_to_cpp_tuning(ro->tuning));
+    set_output_pixel_format(ro->output_pixel_format);
 }
 
 sail_status_t load_options::to_sail_load_options(sail_load_options **load_options) const
@@ -130,7 +142,8 @@ sail_status_t load_options::to_sail_load_options(sail_load_options **load_option
 
     SAIL_TRY(sail_alloc_load_options(&load_options_local));
 
-    load_options_local->options = d->sail_load_options->options;
+    load_options_local->options             = d->sail_load_options->options;
+    load_options_local->output_pixel_format = d->sail_load_options->output_pixel_format;
 
     SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&load_options_local->tuning),
                         /* cleanup */ sail_destroy_load_options(load_options_local));
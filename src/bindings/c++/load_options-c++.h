@@ -118,6 +118,12 @@ public:
      */
     const sail::tuning& tuning() const;
 
+    /*
+     * Returns the pixel format to output loaded images in, or SAIL_PIXEL_FORMAT_UNKNOWN
+     * to output the codec's native pixel format.
+     */
+    SailPixelFormat output_pixel_format() const;
+
     /*
      * Sets new or-ed manipulation options for loading operations. See SailOption.
      */
@@ -128,6 +134,13 @@ public:
      */
     void set_tuning(const sail::tuning &tuning);
 
+    /*
+     * Sets the pixel format to output loaded images in. Codecs that can produce it while decoding
+     * do so. Images loaded by other codecs are converted by image_input after loading.
+     * SAIL_PIXEL_FORMAT_UNKNOWN outputs the codec's native pixel format.
+     */
+    void set_output_pixel_format(SailPixelFormat output_pixel_format);
+
 private:
     /*
      * Makes a deep copy of the specified load options and stores the pointer for further use.
@@ -51,6 +51,7 @@ namespace sail
 class SAIL_EXPORT palette
 {
     friend class image;
+    friend class row_converter;
 
 public:
     /*
@@ -0,0 +1,122 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sail-c++.h"
+#include "sail-manip.h"
+
+namespace sail
+{
+
+class SAIL_HIDDEN row_converter::pimpl
+{
+public:
+    pimpl()
+        : converter(nullptr)
+    {
+    }
+    ~pimpl()
+    {
+        sail_destroy_row_converter(converter);
+    }
+
+    sail_row_converter *converter;
+};
+
+row_converter::row_converter()
+    : d(new pimpl)
+{
+}
+
+row_converter::row_converter(SailPixelFormat input_pixel_format, SailPixelFormat output_pixel_format)
+    : row_converter(input_pixel_format, output_pixel_format, sail::palette{}, conversion_options{})
+{
+}
+
+row_converter::row_converter(SailPixelFormat input_pixel_format, SailPixelFormat output_pixel_format,
+                             const sail::palette &palette, const conversion_options &options)
+    : row_converter()
+{
+    sail_palette *sail_palette = nullptr;
+    sail_conversion_options *sail_conversion_options = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_palette(sail_palette);
+        sail_destroy_conversion_options(sail_conversion_options);
+    );
+
+    if (palette.is_valid()) {
+        SAIL_TRY_OR_EXECUTE(palette.to_sail_palette(&sail_palette),
+                            /* on error */ return);
+    }
+
+    SAIL_TRY_OR_EXECUTE(options.to_sail_conversion_options(&sail_conversion_options),
+                        /* on error */ return);
+
+    SAIL_TRY_OR_EXECUTE(sail_alloc_row_converter(input_pixel_format, output_pixel_format,
+                                                 sail_palette, sail_conversion_options,
+                                                 &d->converter),
+                        /* on error */ return);
+}
+
+row_converter::row_converter(row_converter &&rc) noexcept
+{
+    *this = std::move(rc);
+}
+
+row_converter& row_converter::operator=(row_converter &&rc) noexcept
+{
+    d = std::move(rc.d);
+
+    return *this;
+}
+
+row_converter::~row_converter()
+{
+}
+
+bool row_converter::is_valid() const
+{
+    return d->converter != nullptr;
+}
+
+sail_status_t row_converter::convert(unsigned width, unsigned rows,
+                                     const void *input, unsigned input_bytes_per_line,
+                                     void *output, unsigned output_bytes_per_line) const
+{
+    SAIL_TRY(sail_convert_rows(d->converter, width, rows,
+                               input, input_bytes_per_line,
+                               output, output_bytes_per_line));
+
+    return SAIL_OK;
+}
+
+sail_status_t row_converter::convert(unsigned width, const void *input, void *output) const
+{
+    SAIL_TRY(sail_convert_row(d->converter, width, input, output));
+
+    return SAIL_OK;
+}
+
+}
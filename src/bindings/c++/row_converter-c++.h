@@ -0,0 +1,126 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROW_CONVERTER_CPP_H
+#define SAIL_ROW_CONVERTER_CPP_H
+
+#include <memory>
+
+#ifdef SAIL_BUILD
+    #include "common.h"
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/common.h>
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+namespace sail
+{
+
+class conversion_options;
+class palette;
+
+/*
+ * Converts rows between caller buffers from one pixel format to another. Allows to convert
+ * images while loading or saving them row by row without a full-size intermediate image.
+ */
+class SAIL_EXPORT row_converter
+{
+public:
+    /*
+     * Constructs an invalid row converter.
+     */
+    row_converter();
+
+    /*
+     * Constructs a new row converter from the input pixel format to the output pixel format.
+     * The row converter is invalid if the conversion is not supported.
+     */
+    row_converter(SailPixelFormat input_pixel_format, SailPixelFormat output_pixel_format);
+
+    /*
+     * Constructs a new row converter from the input pixel format to the output pixel format.
+     * The palette must be valid for indexed input pixel formats. The options control
+     * the conversion behavior. The row converter is invalid if the conversion is not supported.
+     */
+    row_converter(SailPixelFormat input_pixel_format, SailPixelFormat output_pixel_format,
+                  const sail::palette &palette, const conversion_options &options);
+
+    /*
+     * Disables copying row converters.
+     */
+    row_converter(const row_converter &rc) = delete;
+    row_converter& operator=(const row_converter &rc) = delete;
+
+    /*
+     * Moves the row converter.
+     */
+    row_converter(row_converter &&rc) noexcept;
+
+    /*
+     * Moves the row converter.
+     */
+    row_converter& operator=(row_converter &&rc) noexcept;
+
+    /*
+     * Destroys the row converter.
+     */
+    ~row_converter();
+
+    /*
+     * Returns true if the row converter can convert rows.
+     */
+    bool is_valid() const;
+
+    /*
+     * Converts the specified number of rows of the specified width from the input buffer
+     * to the output buffer. Rows in the buffers are separated by the specified strides.
+     *
+     * The input and output buffers may be the same if the output pixel format is not larger
+     * than the input pixel format, and the strides are equal.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t convert(unsigned width, unsigned rows,
+                          const void *input, unsigned input_bytes_per_line,
+                          void *output, unsigned output_bytes_per_line) const;
+
+    /*
+     * Converts a single row of the specified width from the input buffer to the output buffer.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t convert(unsigned width, const void *input, void *output) const;
+
+private:
+    class pimpl;
+    std::unique_ptr<pimpl> d;
+};
+
+}
+
+#endif
@@ -55,6 +55,7 @@
     #include "image-c++.h"
     #include "image_input-c++.h"
     #include "image_output-c++.h"
+    #include "io_arbitrary_data_private-c++.h"
     #include "io_base-c++.h"
     #include "io_base_p-c++.h"
     #include "io_file-c++.h"
@@ -66,6 +67,7 @@
     #include "ostream-c++.h"
     #include "palette-c++.h"
     #include "resolution-c++.h"
+    #include "row_converter-c++.h"
     #include "save_features-c++.h"
     #include "save_options-c++.h"
     #include "source_image-c++.h"
@@ -103,6 +105,7 @@
     #include <sail-c++/ostream-c++.h>
     #include <sail-c++/palette-c++.h>
     #include <sail-c++/resolution-c++.h>
+    #include <sail-c++/row_converter-c++.h>
     #include <sail-c++/source_image-c++.h>
     #include <sail-c++/save_features-c++.h>
     #include <sail-c++/save_options-c++.h>
@@ -50,6 +50,7 @@ sail_status_t sail_alloc_io(struct sail_io **io) {
     (*io)->flush          = NULL;
     (*io)->close          = NULL;
     (*io)->eof            = NULL;
+    (*io)->borrow         = NULL;
 
     return SAIL_OK;
 }
@@ -85,6 +86,11 @@ sail_status_t sail_check_io_valid(const struct sail_io *io)
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_IO);
     }
 
+    if ((io->features & SAIL_IO_FEATURE_BORROWABLE) && io->borrow == NULL) {
+        SAIL_LOG_ERROR("Borrowable I/O object has no borrow callback");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_IO);
+    }
+
     return SAIL_OK;
 }
 
@@ -167,6 +173,27 @@ sail_status_t sail_alloc_data_from_io_contents(struct sail_io *io, void **data,
     return SAIL_OK;
 }
 
+sail_status_t sail_alloc_or_borrow_data_from_io_contents(struct sail_io *io, const void **data, size_t *data_size,
+                                                          void **allocated_data) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+    SAIL_CHECK_PTR(allocated_data);
+
+    if (io->features & SAIL_IO_FEATURE_BORROWABLE) {
+        SAIL_TRY(io->borrow(io->stream, data, data_size));
+        *allocated_data = NULL;
+    } else {
+        void *data_local;
+        SAIL_TRY(sail_alloc_data_from_io_contents(io, &data_local, data_size));
+        *data           = data_local;
+        *allocated_data = data_local;
+    }
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_read_string_from_io(struct sail_io *io, char *str, size_t str_size) {
 
     SAIL_CHECK_PTR(io);
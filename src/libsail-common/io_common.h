@@ -115,6 +115,17 @@ typedef sail_status_t (*sail_io_close_t)(void *stream);
  */
 typedef sail_status_t (*sail_io_eof_t)(void *stream, bool *result);
 
+/*
+ * Assigns a pointer to the contiguous bytes of the underlying I/O object starting from the current
+ * I/O position until the end of the stream, and the number of these bytes. Doesn't change the I/O position.
+ * The bytes are valid until the I/O object is closed. They MUST NOT be modified.
+ *
+ * Available only when the I/O object has the SAIL_IO_FEATURE_BORROWABLE feature.
+ *
+ * Returns SAIL_OK on success.
+ */
+typedef sail_status_t (*sail_io_borrow_t)(void *stream, const void **data, size_t *data_size);
+
 /*
  * Well-known I/O ids used in libsail for file and memory I/O classes.
  *
@@ -135,6 +146,13 @@ enum SailIoFeature {
      * must return SAIL_ERROR_NOT_IMPLEMENTED.
      */
     SAIL_IO_FEATURE_SEEKABLE = 1 << 0,
+
+    /*
+     * The I/O object is backed by contiguous bytes in memory, for example, a memory buffer
+     * or a memory-mapped file. The borrow callback must be set when this flag is on.
+     * Codecs that need the whole image in memory use the bytes directly instead of copying them.
+     */
+    SAIL_IO_FEATURE_BORROWABLE = 1 << 1,
 };
 
 /*
@@ -207,6 +225,12 @@ struct sail_io {
      * EOF callback.
      */
     sail_io_eof_t eof;
+
+    /*
+     * Optional borrow callback. Must be set when the SAIL_IO_FEATURE_BORROWABLE feature is on.
+     * Can be NULL otherwise.
+     */
+    sail_io_borrow_t borrow;
 };
 
 typedef struct sail_io sail_io_t;
@@ -263,6 +287,20 @@ SAIL_EXPORT sail_status_t sail_io_contents_into_data(struct sail_io *io, void *d
  */
 SAIL_EXPORT sail_status_t sail_alloc_data_from_io_contents(struct sail_io *io, void **data, size_t *data_size);
 
+/*
+ * Provides the contents of the specified I/O stream from the current position until EOF
+ * in memory. Doesn't change the I/O position.
+ *
+ * If the I/O object has the SAIL_IO_FEATURE_BORROWABLE feature, the underlying bytes are borrowed
+ * without copying, and 'allocated_data' is set to NULL. Otherwise, the stream is read into a new
+ * memory buffer like sail_alloc_data_from_io_contents() does, and 'allocated_data' is set to it.
+ * In both cases 'data' points to the contents. The caller must free 'allocated_data' with sail_free().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_or_borrow_data_from_io_contents(struct sail_io *io, const void **data, size_t *data_size,
+                                                                      void **allocated_data);
+
 /*
  * Reads a string ended with '\n' from the I/O stream. Trailing new line characters
  * are not stripped. The string buffer size must be >= 2 to hold at least "\n".
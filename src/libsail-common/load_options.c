@@ -39,6 +39,8 @@ sail_status_t sail_alloc_load_options(struct sail_load_options **load_options) {
     (*load_options)->options = 0;
     (*load_options)->tuning  = NULL;
 
+    (*load_options)->output_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
+
     return SAIL_OK;
 }
 
@@ -82,7 +84,8 @@ sail_status_t sail_copy_load_options(const struct sail_load_options *source, str
     struct sail_load_options *target_local;
     SAIL_TRY(sail_alloc_load_options(&target_local));
 
-    target_local->options = source->options;
+    target_local->options             = source->options;
+    target_local->output_pixel_format = source->output_pixel_format;
 
     if (source->tuning != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_hash_map(source->tuning, &target_local->tuning),
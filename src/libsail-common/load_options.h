@@ -27,9 +27,11 @@
 #define SAIL_LOAD_OPTIONS_H
 
 #ifdef SAIL_BUILD
+    #include "common.h"
     #include "error.h"
     #include "export.h"
 #else
+    #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
 #endif
@@ -64,6 +66,21 @@ struct sail_load_options {
      * or forward compatible.
      */
     struct sail_hash_map *tuning;
+
+    /*
+     * Pixel format to output loaded images in, or SAIL_PIXEL_FORMAT_UNKNOWN to output
+     * the codec's native pixel format.
+     *
+     * Codecs that can produce the requested pixel format while decoding do so, which saves
+     * a separate conversion pass and a second pixel buffer. Codecs that cannot, or don't support
+     * the requested pixel format for the particular image, output their native pixel format.
+     * Always check the pixel format of the loaded images and convert them with sail-manip
+     * if necessary. Codec-native conversions may differ from sail-manip conversions by 1
+     * in a color component due to different rounding.
+     *
+     * The supported output pixel formats of every codec are documented in FORMATS.md.
+     */
+    enum SailPixelFormat output_pixel_format;
 };
 
 typedef struct sail_load_options sail_load_options_t;
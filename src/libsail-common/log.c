@@ -191,6 +191,11 @@ void sail_log(enum SailLogLevel level, const char *file, int line, const char *f
     va_end(args);
 }
 
+bool sail_log_enabled(enum SailLogLevel level) {
+
+    return level <= sail_max_log_level;
+}
+
 void sail_set_log_barrier(enum SailLogLevel max_level) {
 
     sail_max_log_level = max_level;
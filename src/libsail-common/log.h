@@ -27,6 +27,7 @@
 #define SAIL_LOG_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 
 #ifdef SAIL_BUILD
     #include "export.h"
@@ -56,6 +57,12 @@ typedef void (*sail_logger)(enum SailLogLevel level, const char *file, int line,
 
 SAIL_EXPORT void sail_log(enum SailLogLevel level, const char *file, int line, const char *format, ...);
 
+/*
+ * Returns true if messages of the specified log level pass the log barrier. Use it to skip
+ * building expensive log messages that would be filtered out anyway.
+ */
+SAIL_EXPORT bool sail_log_enabled(enum SailLogLevel level);
+
 /*
  * Sets a maximum log level barrier. Only messages of the specified log level or lower will be displayed.
  *
@@ -25,15 +25,121 @@
 
 #include "config.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sail-common.h"
 
+static void* default_malloc(void *user_data, size_t size) {
+
+    (void)user_data;
+
+    return malloc(size);
+}
+
+static void* default_realloc(void *user_data, void *ptr, size_t size) {
+
+    (void)user_data;
+
+    return realloc(ptr, size);
+}
+
+static void* default_calloc(void *user_data, size_t nmemb, size_t size) {
+
+    (void)user_data;
+
+    return calloc(nmemb, size);
+}
+
+static void default_free(void *user_data, void *ptr) {
+
+    (void)user_data;
+
+    free(ptr);
+}
+
+static struct sail_allocator global_allocator = {
+    default_malloc,
+    default_realloc,
+    default_calloc,
+    default_free,
+    NULL
+};
+
+static SAIL_THREAD_LOCAL struct sail_allocator thread_allocator;
+static SAIL_THREAD_LOCAL bool thread_allocator_set = false;
+
+/* Nesting depth of sail_private_begin_global_allocation() calls. */
+static SAIL_THREAD_LOCAL unsigned global_allocation_depth = 0;
+
+static inline const struct sail_allocator* current_allocator(void) {
+
+    return (thread_allocator_set && global_allocation_depth == 0) ? &thread_allocator : &global_allocator;
+}
+
+static sail_status_t check_allocator_valid(const struct sail_allocator *allocator) {
+
+    SAIL_CHECK_PTR(allocator->malloc_func);
+    SAIL_CHECK_PTR(allocator->realloc_func);
+    SAIL_CHECK_PTR(allocator->free_func);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_set_allocator(const struct sail_allocator *allocator) {
+
+    if (allocator == NULL) {
+        global_allocator.malloc_func  = default_malloc;
+        global_allocator.realloc_func = default_realloc;
+        global_allocator.calloc_func  = default_calloc;
+        global_allocator.free_func    = default_free;
+        global_allocator.user_data    = NULL;
+
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(check_allocator_valid(allocator));
+
+    global_allocator = *allocator;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_set_thread_allocator(const struct sail_allocator *allocator) {
+
+    if (allocator == NULL) {
+        thread_allocator_set = false;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(check_allocator_valid(allocator));
+
+    thread_allocator     = *allocator;
+    thread_allocator_set = true;
+
+    return SAIL_OK;
+}
+
+void sail_private_begin_global_allocation(void) {
+
+    global_allocation_depth++;
+}
+
+void sail_private_end_global_allocation(void) {
+
+    if (global_allocation_depth > 0) {
+        global_allocation_depth--;
+    }
+}
+
 sail_status_t sail_malloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = malloc(size);
+    const struct sail_allocator *allocator = current_allocator();
+
+    void *ptr_local = allocator->malloc_func(allocator->user_data, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -48,7 +154,9 @@ sail_status_t sail_realloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = realloc(*ptr, size);
+    const struct sail_allocator *allocator = current_allocator();
+
+    void *ptr_local = allocator->realloc_func(allocator->user_data, *ptr, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -63,7 +171,24 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = calloc(nmemb, size);
+    const struct sail_allocator *allocator = current_allocator();
+
+    void *ptr_local;
+
+    if (allocator->calloc_func != NULL) {
+        ptr_local = allocator->calloc_func(allocator->user_data, nmemb, size);
+    } else {
+        /* Overflow check as calloc() does. */
+        if (size != 0 && nmemb > (size_t)-1 / size) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+
+        ptr_local = allocator->malloc_func(allocator->user_data, nmemb * size);
+
+        if (ptr_local != NULL) {
+            memset(ptr_local, 0, nmemb * size);
+        }
+    }
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -76,5 +201,7 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
 
 void sail_free(void *ptr) {
 
-    free(ptr);
+    const struct sail_allocator *allocator = current_allocator();
+
+    allocator->free_func(allocator->user_data, ptr);
 }
@@ -26,6 +26,8 @@
 #ifndef SAIL_MEMORY_H
 #define SAIL_MEMORY_H
 
+#include <stddef.h>
+
 #ifdef SAIL_BUILD
     #include "error.h"
     #include "export.h"
@@ -38,6 +40,80 @@
 extern "C" {
 #endif
 
+/*
+ * Custom memory allocator. All the memory allocated by SAIL, including image pixels, palettes,
+ * meta data, variants, and strings, goes through the installed allocator. The user data pointer
+ * is passed to every function as is.
+ *
+ * malloc_func, realloc_func, and free_func are mandatory. calloc_func is optional. When it's NULL,
+ * malloc_func is used followed by zeroing the allocated memory.
+ *
+ * The functions must follow the standard malloc(), realloc(), calloc(), and free() semantics.
+ * For example, realloc_func must behave like malloc_func when the pointer is NULL, and free_func
+ * must accept NULL pointers. The functions return NULL on failure.
+ */
+typedef void* (*sail_malloc_func)(void *user_data, size_t size);
+typedef void* (*sail_realloc_func)(void *user_data, void *ptr, size_t size);
+typedef void* (*sail_calloc_func)(void *user_data, size_t nmemb, size_t size);
+typedef void  (*sail_free_func)(void *user_data, void *ptr);
+
+struct sail_allocator {
+
+    sail_malloc_func malloc_func;
+    sail_realloc_func realloc_func;
+    sail_calloc_func calloc_func;
+    sail_free_func free_func;
+
+    void *user_data;
+};
+
+typedef struct sail_allocator sail_allocator_t;
+
+/*
+ * Sets a global memory allocator used by all threads that have no thread allocator set.
+ * The allocator structure is copied. Pass NULL to reset to the standard C library allocator.
+ *
+ * Memory allocated with one allocator must be freed with the same allocator. So it's essential
+ * to destroy all SAIL objects before switching allocators.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before initializing SAIL.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_allocator(const struct sail_allocator *allocator);
+
+/*
+ * Sets a memory allocator for the current thread only. It takes precedence over the global
+ * allocator. The allocator structure is copied. Pass NULL to fall back to the global allocator.
+ *
+ * Typical usage: per-request arenas or tracking allocators in decoding worker threads.
+ *
+ * Memory allocated with one allocator must be freed with the same allocator. So it's essential
+ * to destroy all SAIL objects created in the thread before switching allocators, and not to pass
+ * them to other threads with different allocators.
+ *
+ * The global SAIL context shared between threads, i.e. codec infos, codec lookup indexes, and
+ * lazily loaded codecs, is always allocated and freed with the global allocator. Thread allocators
+ * are still applied to everything else, so it's recommended to call sail_init() with no thread
+ * allocator set.
+ *
+ * Thread allocators are not inherited. Threads started by sail_parallel_for() use the global
+ * allocator even if the calling thread has a thread allocator set.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_thread_allocator(const struct sail_allocator *allocator);
+
+/*
+ * Private functions. Make the current thread ignore its thread allocator and use the global one
+ * until the matching sail_private_end_global_allocation() call. The calls can be nested.
+ *
+ * Used for objects shared between threads like the global SAIL context.
+ */
+SAIL_EXPORT void sail_private_begin_global_allocation(void);
+SAIL_EXPORT void sail_private_end_global_allocation(void);
+
 /*
  * Interface to malloc().
  *
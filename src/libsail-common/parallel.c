@@ -0,0 +1,226 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdbool.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#include "sail-common.h"
+
+#ifdef SAIL_WIN32
+    typedef CRITICAL_SECTION parallel_mutex_t;
+    typedef HANDLE parallel_thread_t;
+#else
+    typedef pthread_mutex_t parallel_mutex_t;
+    typedef pthread_t parallel_thread_t;
+#endif
+
+struct parallel_context {
+    sail_parallel_task_t task;
+    void *user_data;
+
+    parallel_mutex_t mutex;
+
+    /* Protected by the mutex. */
+    unsigned count;
+    unsigned next_index;
+    sail_status_t status;
+};
+
+/*
+ * Private functions.
+ */
+
+static void lock(struct parallel_context *context) {
+#ifdef SAIL_WIN32
+    EnterCriticalSection(&context->mutex);
+#else
+    pthread_mutex_lock(&context->mutex);
+#endif
+}
+
+static void unlock(struct parallel_context *context) {
+#ifdef SAIL_WIN32
+    LeaveCriticalSection(&context->mutex);
+#else
+    pthread_mutex_unlock(&context->mutex);
+#endif
+}
+
+/* Executes tasks until none are left or a task fails. */
+static void worker(struct parallel_context *context) {
+
+    for (;;) {
+        lock(context);
+
+        if (context->status != SAIL_OK || context->next_index >= context->count) {
+            unlock(context);
+            return;
+        }
+
+        const unsigned index = context->next_index++;
+
+        unlock(context);
+
+        const sail_status_t status = context->task(index, context->user_data);
+
+        if (status != SAIL_OK) {
+            lock(context);
+
+            if (context->status == SAIL_OK) {
+                context->status = status;
+            }
+
+            unlock(context);
+        }
+    }
+}
+
+#ifdef SAIL_WIN32
+static DWORD WINAPI thread_function(LPVOID arg) {
+    worker(arg);
+    return 0;
+}
+#else
+static void* thread_function(void *arg) {
+    worker(arg);
+    return NULL;
+}
+#endif
+
+static bool start_thread(parallel_thread_t *thread, struct parallel_context *context) {
+#ifdef SAIL_WIN32
+    *thread = CreateThread(NULL, 0, thread_function, context, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, thread_function, context) == 0;
+#endif
+}
+
+static void join_thread(parallel_thread_t thread) {
+#ifdef SAIL_WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+/*
+ * Public functions.
+ */
+
+unsigned sail_hardware_concurrency(void) {
+
+#ifdef SAIL_WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    return system_info.dwNumberOfProcessors > 0 ? (unsigned)system_info.dwNumberOfProcessors : 1;
+#else
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return processors > 0 ? (unsigned)processors : 1;
+#endif
+}
+
+sail_status_t sail_parallel_for(unsigned count, unsigned threads, sail_parallel_task_t task, void *user_data) {
+
+    SAIL_CHECK_PTR(task);
+
+    if (threads == 0) {
+        threads = sail_hardware_concurrency();
+    }
+
+    threads = SAIL_MIN(threads, count);
+
+    if (threads <= 1) {
+        for (unsigned index = 0; index < count; index++) {
+            SAIL_TRY(task(index, user_data));
+        }
+
+        return SAIL_OK;
+    }
+
+    struct parallel_context context;
+    context.task       = task;
+    context.user_data  = user_data;
+    context.count      = count;
+    context.next_index = 0;
+    context.status     = SAIL_OK;
+
+#ifdef SAIL_WIN32
+    InitializeCriticalSection(&context.mutex);
+#else
+    if ((errno = pthread_mutex_init(&context.mutex, NULL)) != 0) {
+        sail_print_errno("Failed to initialize mutex: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+
+    void *ptr;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(sizeof(parallel_thread_t) * (threads - 1), &ptr),
+                        /* on error */ ptr = NULL);
+    parallel_thread_t *thread_handles = ptr;
+
+    /* The calling thread is a worker too. Run fewer threads if some of them fail to start. */
+    unsigned started_threads = 0;
+
+    if (thread_handles != NULL) {
+        while (started_threads < threads - 1 && start_thread(&thread_handles[started_threads], &context)) {
+            started_threads++;
+        }
+    }
+
+    SAIL_LOG_TRACE("Running %u tasks on %u threads", count, started_threads + 1);
+
+    worker(&context);
+
+    for (unsigned i = 0; i < started_threads; i++) {
+        join_thread(thread_handles[i]);
+    }
+
+    sail_free(thread_handles);
+
+#ifdef SAIL_WIN32
+    DeleteCriticalSection(&context.mutex);
+#else
+    pthread_mutex_destroy(&context.mutex);
+#endif
+
+    if (context.status != SAIL_OK) {
+        SAIL_LOG_AND_RETURN(context.status);
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,75 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PARALLEL_H
+#define SAIL_PARALLEL_H
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Task function executed by sail_parallel_for(). 'index' is in the range [0, count).
+ * Tasks run concurrently and must not share mutable state without synchronization.
+ *
+ * Returns SAIL_OK on success.
+ */
+typedef sail_status_t (*sail_parallel_task_t)(unsigned index, void *user_data);
+
+/*
+ * Returns the number of logical processors available to the process. Returns 1 if the number
+ * cannot be detected.
+ */
+SAIL_EXPORT unsigned sail_hardware_concurrency(void);
+
+/*
+ * Executes the specified task 'count' times on up to 'threads' threads including the calling one,
+ * and waits for all of them to finish. Tasks are distributed dynamically, so a slow task doesn't
+ * stall the others. If 'threads' is 0, sail_hardware_concurrency() threads are used.
+ * If 'threads' or 'count' is 1, the tasks are executed serially on the calling thread.
+ *
+ * Once a task fails, the remaining tasks are not started, and the error of the first failed
+ * task is returned.
+ *
+ * Started threads don't inherit the thread allocator of the calling thread, see sail_set_thread_allocator().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_parallel_for(unsigned count, unsigned threads, sail_parallel_task_t task, void *user_data);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
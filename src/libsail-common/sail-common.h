@@ -50,6 +50,7 @@
     #include "meta_data.h"
     #include "meta_data_node.h"
     #include "palette.h"
+    #include "parallel.h"
     #include "pixel.h"
     #include "resolution.h"
     #include "save_features.h"
@@ -79,6 +80,7 @@
     #include <sail-common/meta_data.h>
     #include <sail-common/meta_data_node.h>
     #include <sail-common/palette.h>
+    #include <sail-common/parallel.h>
     #include <sail-common/pixel.h>
     #include <sail-common/resolution.h>
     #include <sail-common/save_features.h>
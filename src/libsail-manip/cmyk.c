@@ -25,6 +25,22 @@
 
 #include "sail-manip.h"
 
+/*
+ * Private functions.
+ */
+
+/* Same as (uint8_t)(value * k / 255.0 + 0.5) for all 8-bit values. */
+static inline uint8_t apply_black(uint8_t value, uint8_t k) {
+
+    const unsigned product = (unsigned)value * k + 128;
+
+    return (uint8_t)((product + (product >> 8)) >> 8);
+}
+
+/*
+ * Public functions.
+ */
+
 void convert_cmyk32_to_rgba32(uint8_t c, uint8_t m, uint8_t y, uint8_t k, sail_rgba32_t *rgba32) {
 
 #if 0
@@ -37,9 +53,32 @@ void convert_cmyk32_to_rgba32(uint8_t c, uint8_t m, uint8_t y, uint8_t k, sail_r
     *g = (uint8_t)((1-M) * (1-K) * 255);
     *b = (uint8_t)((1-Y) * (1-K) * 255);
 #else
-    rgba32->component1 = (uint8_t)((double)c * k / 255.0 + 0.5);
-    rgba32->component2 = (uint8_t)((double)m * k / 255.0 + 0.5);
-    rgba32->component3 = (uint8_t)((double)y * k / 255.0 + 0.5);
+    rgba32->component1 = apply_black(c, k);
+    rgba32->component2 = apply_black(m, k);
+    rgba32->component3 = apply_black(y, k);
     rgba32->component4 = 255;
 #endif
 }
+
+void convert_cmyk32_row_to_rgba_kind(const uint8_t *input, uint8_t *output, unsigned width,
+                                     unsigned output_pixel_size, int r, int g, int b, int a) {
+
+    for (unsigned column = 0; column < width; column++) {
+        /* Read the whole pixel first as the input and output may overlap. */
+        const uint8_t k = *(input+3);
+        const uint8_t red   = apply_black(*(input+0), k);
+        const uint8_t green = apply_black(*(input+1), k);
+        const uint8_t blue  = apply_black(*(input+2), k);
+
+        *(output+r) = red;
+        *(output+g) = green;
+        *(output+b) = blue;
+
+        if (a >= 0) {
+            *(output+a) = 255;
+        }
+
+        input  += 4;
+        output += output_pixel_size;
+    }
+}
@@ -41,4 +41,11 @@
  */
 SAIL_HIDDEN void convert_cmyk32_to_rgba32(uint8_t c, uint8_t m, uint8_t y, uint8_t k, sail_rgba32_t *rgba32);
 
+/*
+ * Converts a row of CMYK pixels into an RGB-like row with the specified output pixel size
+ * and component indexes. If 'a' is non-negative, the alpha component is set to 255.
+ */
+SAIL_HIDDEN void convert_cmyk32_row_to_rgba_kind(const uint8_t *input, uint8_t *output, unsigned width,
+                                                 unsigned output_pixel_size, int r, int g, int b, int a);
+
 #endif
@@ -36,6 +36,7 @@ sail_status_t sail_alloc_conversion_options(struct sail_conversion_options **opt
     (*options)->options      = SAIL_CONVERSION_OPTION_DROP_ALPHA;
     (*options)->background48 = (sail_rgb48_t){ 0, 0, 0 };
     (*options)->background24 = (sail_rgb24_t){ 0, 0, 0 };
+    (*options)->threads      = 1;
 
     return SAIL_OK;
 }
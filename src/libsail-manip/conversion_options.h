@@ -65,6 +65,14 @@ struct sail_conversion_options {
      * when options has SAIL_CONVERSION_OPTION_BLEND_ALPHA.
      */
     sail_rgb24_t background24;
+
+    /*
+     * Number of threads to convert images with, including the calling thread. The image is split
+     * into row bands converted concurrently. 0 or 1 converts in the calling thread. Use
+     * sail_hardware_concurrency() to utilize all the logical processors. Small images are always
+     * converted in the calling thread.
+     */
+    unsigned threads;
 };
 
 typedef struct sail_conversion_options sail_conversion_options_t;
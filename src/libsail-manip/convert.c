@@ -28,6 +28,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sail-common.h"
 
@@ -37,6 +38,12 @@
  * Private functions.
  */
 
+/* Minimum number of pixels in a band converted by a single thread. */
+#define CONVERSION_MIN_BAND_PIXELS (256 * 1024)
+
+/* Number of bands per thread in multi-threaded conversions. */
+#define CONVERSION_BANDS_PER_THREAD 4
+
 struct output_context {
     struct sail_image *image;
     int r;
@@ -44,6 +51,12 @@ struct output_context {
     int b;
     int a;
     const struct sail_conversion_options *options;
+    /* Rows [first_row, last_row) to convert. */
+    unsigned first_row;
+    unsigned last_row;
+    /* Prebuilt table of indexed or grayscale input colors, or NULL to build it on every conversion. */
+    const sail_rgba32_t *index_table;
+    unsigned index_table_length;
 };
 
 typedef void (*pixel_consumer_t)(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64);
@@ -125,43 +138,77 @@ static void pixel_consumer_ycbcr(const struct output_context *output_context, un
     }
 }
 
+struct output_pixel_format_info {
+    pixel_consumer_t pixel_consumer;
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
+/*
+ * Indexed by the output pixel format. Formats we cannot convert to have no pixel consumer.
+ * Grayscale and YCbCr consumers don't use the RGBA indexes.
+ */
+static const struct output_pixel_format_info OUTPUT_PIXEL_FORMATS[] = {
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]  = { pixel_consumer_gray8,  -1, -1, -1, -1 },
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE] = { pixel_consumer_gray16, -1, -1, -1, -1 },
+
+    [SAIL_PIXEL_FORMAT_BPP24_RGB] = { pixel_consumer_rgb24_kind, 0, 1, 2, -1 },
+    [SAIL_PIXEL_FORMAT_BPP24_BGR] = { pixel_consumer_rgb24_kind, 2, 1, 0, -1 },
+
+    [SAIL_PIXEL_FORMAT_BPP48_RGB] = { pixel_consumer_rgb48_kind, 0, 1, 2, -1 },
+    [SAIL_PIXEL_FORMAT_BPP48_BGR] = { pixel_consumer_rgb48_kind, 2, 1, 0, -1 },
+
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX] = { pixel_consumer_rgba32_kind, 0, 1, 2, -1 },
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX] = { pixel_consumer_rgba32_kind, 2, 1, 0, -1 },
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB] = { pixel_consumer_rgba32_kind, 1, 2, 3, -1 },
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR] = { pixel_consumer_rgba32_kind, 3, 2, 1, -1 },
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA] = { pixel_consumer_rgba32_kind, 0, 1, 2, 3  },
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA] = { pixel_consumer_rgba32_kind, 2, 1, 0, 3  },
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB] = { pixel_consumer_rgba32_kind, 1, 2, 3, 0  },
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR] = { pixel_consumer_rgba32_kind, 3, 2, 1, 0  },
+
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX] = { pixel_consumer_rgba64_kind, 0, 1, 2, -1 },
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX] = { pixel_consumer_rgba64_kind, 2, 1, 0, -1 },
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB] = { pixel_consumer_rgba64_kind, 1, 2, 3, -1 },
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR] = { pixel_consumer_rgba64_kind, 3, 2, 1, -1 },
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA] = { pixel_consumer_rgba64_kind, 0, 1, 2, 3  },
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA] = { pixel_consumer_rgba64_kind, 2, 1, 0, 3  },
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB] = { pixel_consumer_rgba64_kind, 1, 2, 3, 0  },
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR] = { pixel_consumer_rgba64_kind, 3, 2, 1, 0  },
+
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR] = { pixel_consumer_ycbcr, -1, -1, -1, -1 },
+};
+
+static const size_t OUTPUT_PIXEL_FORMATS_LENGTH = sizeof(OUTPUT_PIXEL_FORMATS) / sizeof(OUTPUT_PIXEL_FORMATS[0]);
+
+/* Returns NULL if the conversion to the pixel format is not supported. */
+static const struct output_pixel_format_info* find_output_pixel_format_info(enum SailPixelFormat output_pixel_format) {
+
+    if ((size_t)output_pixel_format >= OUTPUT_PIXEL_FORMATS_LENGTH) {
+        return NULL;
+    }
+
+    const struct output_pixel_format_info *info = &OUTPUT_PIXEL_FORMATS[output_pixel_format];
+
+    return (info->pixel_consumer != NULL) ? info : NULL;
+}
+
 static bool verify_and_construct_rgba_indexes_silent(enum SailPixelFormat output_pixel_format, pixel_consumer_t *pixel_consumer, int *r, int *g, int *b, int *a) {
 
-    switch (output_pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:  { *pixel_consumer = pixel_consumer_gray8;  *r = *g = *b = *a = -1; /* unused. */ break; }
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE: { *pixel_consumer = pixel_consumer_gray16; *r = *g = *b = *a = -1; /* unused. */ break; }
-
-        case SAIL_PIXEL_FORMAT_BPP24_RGB: { *pixel_consumer = pixel_consumer_rgb24_kind; *r = 0; *g = 1; *b = 2; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP24_BGR: { *pixel_consumer = pixel_consumer_rgb24_kind; *r = 2; *g = 1; *b = 0; *a = -1; break; }
-
-        case SAIL_PIXEL_FORMAT_BPP48_RGB: { *pixel_consumer = pixel_consumer_rgb48_kind; *r = 0; *g = 1; *b = 2; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP48_BGR: { *pixel_consumer = pixel_consumer_rgb48_kind; *r = 2; *g = 1; *b = 0; *a = -1; break; }
-
-        case SAIL_PIXEL_FORMAT_BPP32_RGBX: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 0; *g = 1; *b = 2; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP32_BGRX: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 2; *g = 1; *b = 0; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP32_XRGB: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 1; *g = 2; *b = 3; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP32_XBGR: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 3; *g = 2; *b = 1; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 0; *g = 1; *b = 2; *a = 3;  break; }
-        case SAIL_PIXEL_FORMAT_BPP32_BGRA: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 2; *g = 1; *b = 0; *a = 3;  break; }
-        case SAIL_PIXEL_FORMAT_BPP32_ARGB: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 1; *g = 2; *b = 3; *a = 0;  break; }
-        case SAIL_PIXEL_FORMAT_BPP32_ABGR: { *pixel_consumer = pixel_consumer_rgba32_kind; *r = 3; *g = 2; *b = 1; *a = 0;  break; }
-
-        case SAIL_PIXEL_FORMAT_BPP64_RGBX: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 0; *g = 1; *b = 2; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP64_BGRX: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 2; *g = 1; *b = 0; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP64_XRGB: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 1; *g = 2; *b = 3; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP64_XBGR: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 3; *g = 2; *b = 1; *a = -1; break; }
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 0; *g = 1; *b = 2; *a = 3;  break; }
-        case SAIL_PIXEL_FORMAT_BPP64_BGRA: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 2; *g = 1; *b = 0; *a = 3;  break; }
-        case SAIL_PIXEL_FORMAT_BPP64_ARGB: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 1; *g = 2; *b = 3; *a = 0;  break; }
-        case SAIL_PIXEL_FORMAT_BPP64_ABGR: { *pixel_consumer = pixel_consumer_rgba64_kind; *r = 3; *g = 2; *b = 1; *a = 0;  break; }
-
-        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: { *pixel_consumer = pixel_consumer_ycbcr; *r = *g = *b = *a = -1; /* unused. */ break; }
+    const struct output_pixel_format_info *info = find_output_pixel_format_info(output_pixel_format);
 
-        default: {
-            return false;
-        }
+    if (info == NULL) {
+        return false;
     }
 
+    *pixel_consumer = info->pixel_consumer;
+    *r = info->r;
+    *g = info->g;
+    *b = info->b;
+    *a = info->a;
+
     return true;
 }
 
@@ -175,126 +222,221 @@ static sail_status_t verify_and_construct_rgba_indexes_verbose(enum SailPixelFor
     }
 }
 
-static sail_status_t convert_from_bpp1_indexed_or_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/* Returns the largest index to validate a whole run of indexes with a single comparison. */
+static uint8_t find_max_index(const uint8_t *indexes, unsigned length) {
 
-    const bool is_indexed = image->pixel_format == SAIL_PIXEL_FORMAT_BPP1_INDEXED;
-    sail_rgba32_t rgba32;
+    uint8_t max_index = 0;
 
-    for (unsigned row = 0; row < image->height; row++) {
-        const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
+    for (unsigned i = 0; i < length; i++) {
+        if (indexes[i] > max_index) {
+            max_index = indexes[i];
+        }
+    }
 
-        for (unsigned column = 0; column < image->width;) {
-            unsigned bit_shift = 7;
-            unsigned bit_mask = 1 << 7;
-            const uint8_t byte = *scan_input++;
+    return max_index;
+}
 
-            while (bit_mask > 0 && column < image->width) {
-                const uint8_t index = (byte & bit_mask) >> bit_shift;
+/*
+ * Unpacks 1, 2, 4, or 8-bit indexes into bytes. Every input byte is read once, and the indexes
+ * it holds are extracted with constant shifts. Returns the largest unpacked index.
+ */
+static uint8_t unpack_indexes(const uint8_t *scan_input, unsigned width, unsigned bits_per_pixel, uint8_t *indexes) {
+
+    uint8_t *indexes_start = indexes;
+    const unsigned pixels_per_byte = 8 / bits_per_pixel;
+    const unsigned full_bytes = width / pixels_per_byte;
+    const unsigned remainder = width % pixels_per_byte;
+
+    switch (bits_per_pixel) {
+        case 1: {
+            for (unsigned i = 0; i < full_bytes; i++) {
+                const uint8_t byte = *scan_input++;
+
+                indexes[0] = (byte >> 7) & 1;
+                indexes[1] = (byte >> 6) & 1;
+                indexes[2] = (byte >> 5) & 1;
+                indexes[3] = (byte >> 4) & 1;
+                indexes[4] = (byte >> 3) & 1;
+                indexes[5] = (byte >> 2) & 1;
+                indexes[6] = (byte >> 1) & 1;
+                indexes[7] = byte & 1;
+                indexes += 8;
+            }
+            break;
+        }
+        case 2: {
+            for (unsigned i = 0; i < full_bytes; i++) {
+                const uint8_t byte = *scan_input++;
+
+                indexes[0] = (byte >> 6) & 3;
+                indexes[1] = (byte >> 4) & 3;
+                indexes[2] = (byte >> 2) & 3;
+                indexes[3] = byte & 3;
+                indexes += 4;
+            }
+            break;
+        }
+        case 4: {
+            for (unsigned i = 0; i < full_bytes; i++) {
+                const uint8_t byte = *scan_input++;
 
-                if (is_indexed) {
-                    SAIL_TRY(get_palette_rgba32(image->palette, index, &rgba32));
-                } else {
-                    spread_gray8_to_rgba32(index == 0 ? 0 : 255, &rgba32);
-                }
+                indexes[0] = byte >> 4;
+                indexes[1] = byte & 15;
+                indexes += 2;
+            }
+            break;
+        }
+        default: {
+            memcpy(indexes, scan_input, width);
+            return find_max_index(indexes, width);
+        }
+    }
 
-                pixel_consumer(output_context, row, column, &rgba32, NULL);
+    /* The last partial byte. */
+    if (remainder > 0) {
+        const uint8_t byte = *scan_input;
+        const unsigned mask = (1u << bits_per_pixel) - 1;
 
-                bit_shift--;
-                bit_mask >>= 1;
-                column++;
-            }
+        for (unsigned i = 0; i < remainder; i++) {
+            indexes[i] = (byte >> (8 - bits_per_pixel * (i + 1))) & mask;
         }
     }
 
-    return SAIL_OK;
+    return find_max_index(indexes_start, width);
 }
 
-static sail_status_t convert_from_bpp2_indexed_or_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/* Converts validated indexes into pixels. */
+typedef void (*index_row_kernel_t)(const uint8_t *indexes, unsigned length, const sail_rgba32_t *table, uint8_t *scan_output);
 
-    const bool is_indexed = image->pixel_format == SAIL_PIXEL_FORMAT_BPP2_INDEXED;
-    sail_rgba32_t rgba32;
-
-    for (unsigned row = 0; row < image->height; row++) {
-        const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
+static void copy_indexes_to_bpp24_rgb(const uint8_t *indexes, unsigned length, const sail_rgba32_t *table, uint8_t *scan_output) {
 
-        for (unsigned column = 0; column < image->width;) {
-            unsigned bit_shift = 6;
-            unsigned bit_mask = 3 << 6; /* 11000000 */
-            const uint8_t byte = *scan_input++;
+    for (unsigned i = 0; i < length; i++) {
+        const sail_rgba32_t *rgba32 = &table[indexes[i]];
 
-            while (bit_mask > 0 && column < image->width) {
-                const uint8_t index = (byte & bit_mask) >> bit_shift;
+        scan_output[0] = rgba32->component1;
+        scan_output[1] = rgba32->component2;
+        scan_output[2] = rgba32->component3;
+        scan_output += 3;
+    }
+}
 
-                if (is_indexed) {
-                    SAIL_TRY(get_palette_rgba32(image->palette, index, &rgba32));
-                } else {
-                    spread_gray8_to_rgba32(index * 85, &rgba32);
-                }
+static void copy_indexes_to_bpp32_rgba(const uint8_t *indexes, unsigned length, const sail_rgba32_t *table, uint8_t *scan_output) {
 
-                pixel_consumer(output_context, row, column, &rgba32, NULL);
+    for (unsigned i = 0; i < length; i++) {
+        const sail_rgba32_t *rgba32 = &table[indexes[i]];
 
-                bit_shift -= 2;
-                bit_mask >>= 2;
-                column++;
-            }
-        }
+        scan_output[0] = rgba32->component1;
+        scan_output[1] = rgba32->component2;
+        scan_output[2] = rgba32->component3;
+        scan_output[3] = rgba32->component4;
+        scan_output += 4;
     }
-
-    return SAIL_OK;
 }
 
-static sail_status_t convert_from_bpp4_indexed_or_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
-
-    const bool is_indexed = image->pixel_format == SAIL_PIXEL_FORMAT_BPP4_INDEXED;
-    sail_rgba32_t rgba32;
+/* Returns a kernel copying table entries as is, or NULL when the pixels need the generic consumer. */
+static index_row_kernel_t find_index_row_kernel(enum SailPixelFormat output_pixel_format, const struct sail_conversion_options *options) {
 
-    for (unsigned row = 0; row < image->height; row++) {
-        const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
+    switch (output_pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            /* Alpha blending modifies the colors. */
+            const bool blend_alpha = options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+            return blend_alpha ? NULL : copy_indexes_to_bpp24_rgb;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            return copy_indexes_to_bpp32_rgba;
+        }
+        default: {
+            return NULL;
+        }
+    }
+}
 
-        for (unsigned column = 0; column < image->width;) {
-            unsigned bit_shift = 4;
-            unsigned bit_mask = 15 << 4; /* 11110000 */
-            const uint8_t byte = *scan_input++;
+/* Returns the number of bits per index of 1, 2, 4, or 8-bit indexed and grayscale pixel formats, or 0. */
+static unsigned index_bits_per_pixel(enum SailPixelFormat pixel_format) {
 
-            while (bit_mask > 0 && column < image->width) {
-                const uint8_t index = (byte & bit_mask) >> bit_shift;
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE: return 1;
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE: return 2;
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE: return 4;
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: return 8;
+        default: return 0;
+    }
+}
 
-                if (is_indexed) {
-                    SAIL_TRY(get_palette_rgba32(image->palette, index, &rgba32));
-                } else {
-                    spread_gray8_to_rgba32(index * 17, &rgba32);
-                }
+/* Expands every possible index once, so the pixel loop does a single table load. */
+static sail_status_t build_index_table(const struct sail_palette *palette, unsigned bits_per_pixel, bool is_indexed, sail_rgba32_t table[256], unsigned *table_length) {
 
-                pixel_consumer(output_context, row, column, &rgba32, NULL);
+    if (is_indexed) {
+        SAIL_TRY(build_palette_rgba32_table(palette, 1u << bits_per_pixel, table, table_length));
+    } else {
+        *table_length = 1u << bits_per_pixel;
+        const unsigned scale = 255 / (*table_length - 1);
 
-                bit_shift -= 4;
-                bit_mask >>= 4;
-                column++;
-            }
+        for (unsigned i = 0; i < *table_length; i++) {
+            spread_gray8_to_rgba32((uint8_t)(i * scale), &table[i]);
         }
     }
 
     return SAIL_OK;
 }
 
-static sail_status_t convert_from_bpp8_indexed_or_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/* Number of indexes unpacked at once. A multiple of 8 to start every chunk on a byte boundary. */
+#define INDEXES_CHUNK_LENGTH 1024
 
-    const bool is_indexed = image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED;
-    sail_rgba32_t rgba32;
+static sail_status_t convert_from_indexed_or_grayscale(const struct sail_image *image, unsigned bits_per_pixel, bool is_indexed, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    sail_rgba32_t local_table[256];
+    const sail_rgba32_t *table;
+    unsigned table_length;
+
+    if (output_context->index_table != NULL) {
+        table        = output_context->index_table;
+        table_length = output_context->index_table_length;
+    } else {
+        SAIL_TRY(build_index_table(image->palette, bits_per_pixel, is_indexed, local_table, &table_length));
+        table = local_table;
+    }
 
-    for (unsigned row = 0; row < image->height; row++) {
+    const index_row_kernel_t index_row_kernel = find_index_row_kernel(output_context->image->pixel_format, output_context->options);
+    const unsigned output_pixel_size = sail_bits_per_pixel(output_context->image->pixel_format) / 8;
+
+    /* 8-bit indexes are read in place. Narrower ones are unpacked in chunks to avoid heap allocations. */
+    uint8_t unpacked[INDEXES_CHUNK_LENGTH];
+
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
+        uint8_t *scan_output = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row;
 
-        for (unsigned column = 0; column < image->width; column++) {
-            const uint8_t index = *scan_input++;
+        for (unsigned chunk_start = 0; chunk_start < image->width; chunk_start += INDEXES_CHUNK_LENGTH) {
+            const unsigned chunk_length = (image->width - chunk_start < INDEXES_CHUNK_LENGTH) ? image->width - chunk_start : INDEXES_CHUNK_LENGTH;
+            const uint8_t *indexes;
+            uint8_t max_index;
 
-            if (is_indexed) {
-                SAIL_TRY(get_palette_rgba32(image->palette, index, &rgba32));
+            if (bits_per_pixel == 8) {
+                indexes = scan_input + chunk_start;
+                max_index = find_max_index(indexes, chunk_length);
             } else {
-                spread_gray8_to_rgba32(index, &rgba32);
+                max_index = unpack_indexes(scan_input + chunk_start / 8 * bits_per_pixel, chunk_length, bits_per_pixel, unpacked);
+                indexes = unpacked;
             }
 
-            pixel_consumer(output_context, row, column, &rgba32, NULL);
+            /* Indexes missing in the palette. */
+            if (max_index >= table_length) {
+                SAIL_LOG_ERROR("Palette index %u is out of range [0; %u)", max_index, table_length);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            if (index_row_kernel != NULL) {
+                index_row_kernel(indexes, chunk_length, table, scan_output + (size_t)chunk_start * output_pixel_size);
+            } else {
+                for (unsigned i = 0; i < chunk_length; i++) {
+                    pixel_consumer(output_context, row, chunk_start + i, &table[indexes[i]], NULL);
+                }
+            }
         }
     }
 
@@ -305,7 +447,7 @@ static sail_status_t convert_from_bpp16_grayscale(const struct sail_image *image
 
     sail_rgba64_t rgba64;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -322,7 +464,7 @@ static sail_status_t convert_from_bpp16_grayscale_alpha(const struct sail_image
 
     sail_rgba32_t rgba32;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -340,7 +482,7 @@ static sail_status_t convert_from_bpp32_grayscale_alpha(const struct sail_image
 
     sail_rgba64_t rgba64;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -356,7 +498,7 @@ static sail_status_t convert_from_bpp32_grayscale_alpha(const struct sail_image
 
 static sail_status_t convert_from_bpp16_rgb555(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -372,7 +514,7 @@ static sail_status_t convert_from_bpp16_rgb555(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_bgr555(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -388,7 +530,7 @@ static sail_status_t convert_from_bpp16_bgr555(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_rgb565(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -404,7 +546,7 @@ static sail_status_t convert_from_bpp16_rgb565(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp16_bgr565(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -420,7 +562,7 @@ static sail_status_t convert_from_bpp16_bgr565(const struct sail_image *image, p
 
 static sail_status_t convert_from_bpp24_rgb_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -436,7 +578,7 @@ static sail_status_t convert_from_bpp24_rgb_kind(const struct sail_image *image,
 
 static sail_status_t convert_from_bpp48_rgb_kind(const struct sail_image *image, int ri, int gi, int bi, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -452,7 +594,7 @@ static sail_status_t convert_from_bpp48_rgb_kind(const struct sail_image *image,
 
 static sail_status_t convert_from_bpp32_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -468,7 +610,7 @@ static sail_status_t convert_from_bpp32_rgba_kind(const struct sail_image *image
 
 static sail_status_t convert_from_bpp64_rgba_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint16_t *scan_input = (uint16_t *)((uint8_t *)image->pixels + image->bytes_per_line * row);
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -486,7 +628,7 @@ static sail_status_t convert_from_bpp32_cmyk(const struct sail_image *image, pix
 
     sail_rgba32_t rgba32;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -504,7 +646,7 @@ static sail_status_t convert_from_bpp24_ycbcr(const struct sail_image *image, pi
 
     sail_rgba32_t rgba32;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -522,7 +664,7 @@ static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pix
 
     sail_rgba32_t rgba32;
 
-    for (unsigned row = 0; row < image->height; row++) {
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
         const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
 
         for (unsigned column = 0; column < image->width; column++) {
@@ -536,158 +678,168 @@ static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pix
     return SAIL_OK;
 }
 
-static sail_status_t conversion_impl(
-    const struct sail_image *image,
-    struct sail_image *image_output,
-    pixel_consumer_t pixel_consumer,
-    int r, /* Index of the RED component.   */
-    int g, /* Index of the GREEN component. */
-    int b, /* Index of the BLUE component.  */
-    int a, /* Index of the ALPHA component. */
-    const struct sail_conversion_options *options) {
+static void convert_with_row_kernel(const struct sail_image *image, row_kernel_t row_kernel, const struct output_context *output_context) {
 
-    const struct output_context output_context = { image_output, r, g, b, a, options };
+    for (unsigned row = output_context->first_row; row < output_context->last_row; row++) {
+        const uint8_t *scan_input = (uint8_t *)image->pixels + image->bytes_per_line * row;
+        uint8_t *scan_output = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row;
+
+        row_kernel(scan_input, scan_output, image->width);
+    }
+}
 
-    /* After adding a new input pixel format, also update the switch in sail_can_convert(). */
+/* Converts the rows specified in the output context. */
+static sail_status_t convert_rows(const struct sail_image *image,
+                                  pixel_consumer_t pixel_consumer,
+                                  row_kernel_t row_kernel,
+                                  const struct output_context *output_context) {
+
+    /* Fast path for common conversions. */
+    if (row_kernel != NULL) {
+        convert_with_row_kernel(image, row_kernel, output_context);
+        return SAIL_OK;
+    }
+
+    /* After adding a new input pixel format, also update CONVERTIBLE_INPUT_PIXEL_FORMATS. */
     switch (image->pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
         case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp1_indexed_or_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_indexed_or_grayscale(image, 1, image->pixel_format == SAIL_PIXEL_FORMAT_BPP1_INDEXED, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
         case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp2_indexed_or_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_indexed_or_grayscale(image, 2, image->pixel_format == SAIL_PIXEL_FORMAT_BPP2_INDEXED, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
         case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp4_indexed_or_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_indexed_or_grayscale(image, 4, image->pixel_format == SAIL_PIXEL_FORMAT_BPP4_INDEXED, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP8_INDEXED:
         case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp8_indexed_or_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_indexed_or_grayscale(image, 8, image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE: {
-            SAIL_TRY(convert_from_bpp16_grayscale(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_grayscale(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: {
-            SAIL_TRY(convert_from_bpp16_grayscale_alpha(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_grayscale_alpha(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: {
-            SAIL_TRY(convert_from_bpp32_grayscale_alpha(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_grayscale_alpha(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_RGB555: {
-            SAIL_TRY(convert_from_bpp16_rgb555(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_rgb555(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_BGR555: {
-            SAIL_TRY(convert_from_bpp16_bgr555(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_bgr555(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_RGB565: {
-            SAIL_TRY(convert_from_bpp16_rgb565(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_rgb565(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP16_BGR565: {
-            SAIL_TRY(convert_from_bpp16_bgr565(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp16_bgr565(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_RGB: {
-            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 0, 1, 2, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 0, 1, 2, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_BGR: {
-            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_rgb_kind(image, 2, 1, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP48_RGB: {
-            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 0, 1, 2, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 0, 1, 2, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP48_BGR: {
-            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp48_rgb_kind(image, 2, 1, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_RGBX: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_BGRX: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_XRGB: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_XBGR: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_ARGB: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_ABGR: {
-            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_RGBX: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_BGRX: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_XRGB: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_XBGR: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, -1, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 0, 1, 2, 3, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_BGRA: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 2, 1, 0, 3, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_ARGB: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 1, 2, 3, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
-            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp64_rgba_kind(image, 3, 2, 1, 0, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_CMYK: {
-            SAIL_TRY(convert_from_bpp32_cmyk(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_cmyk(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
-            SAIL_TRY(convert_from_bpp24_ycbcr(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp24_ycbcr(image, pixel_consumer, output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP32_YCCK: {
-            SAIL_TRY(convert_from_bpp32_ycck(image, pixel_consumer, &output_context));
+            SAIL_TRY(convert_from_bpp32_ycck(image, pixel_consumer, output_context));
             break;
         }
         default: {
@@ -699,6 +851,92 @@ static sail_status_t conversion_impl(
     return SAIL_OK;
 }
 
+struct band_context {
+    const struct sail_image *image;
+    pixel_consumer_t pixel_consumer;
+    row_kernel_t row_kernel;
+    const struct output_context *output_context;
+    unsigned rows_per_band;
+};
+
+static sail_status_t convert_band(unsigned index, void *user_data) {
+
+    const struct band_context *band_context = user_data;
+
+    /* Bands are independent as every row is written only from the same input row. */
+    struct output_context output_context = *band_context->output_context;
+    output_context.first_row = index * band_context->rows_per_band;
+    output_context.last_row  = output_context.first_row + band_context->rows_per_band;
+
+    if (output_context.last_row > band_context->image->height) {
+        output_context.last_row = band_context->image->height;
+    }
+
+    SAIL_TRY(convert_rows(band_context->image, band_context->pixel_consumer, band_context->row_kernel, &output_context));
+
+    return SAIL_OK;
+}
+
+static sail_status_t conversion_impl(
+    const struct sail_image *image,
+    struct sail_image *image_output,
+    pixel_consumer_t pixel_consumer,
+    row_kernel_t row_kernel,
+    int r, /* Index of the RED component.   */
+    int g, /* Index of the GREEN component. */
+    int b, /* Index of the BLUE component.  */
+    int a, /* Index of the ALPHA component. */
+    const struct sail_conversion_options *options,
+    const sail_rgba32_t *index_table, /* Prebuilt table of input colors or NULL. */
+    unsigned index_table_length) {
+
+    const struct output_context output_context = { image_output, r, g, b, a, options, 0, image->height, index_table, index_table_length };
+
+    /* Don't split small images as starting threads costs more than converting them. */
+    const unsigned threads = (options == NULL) ? 1 : options->threads;
+    const size_t pixels = (size_t)image->width * image->height;
+
+    if (threads <= 1 || image->height < 2 || pixels < CONVERSION_MIN_BAND_PIXELS * 2) {
+        SAIL_TRY(convert_rows(image, pixel_consumer, row_kernel, &output_context));
+        return SAIL_OK;
+    }
+
+    /* More bands than threads to balance the load when some threads are slower. */
+    size_t bands = (size_t)threads * CONVERSION_BANDS_PER_THREAD;
+
+    if (bands > pixels / CONVERSION_MIN_BAND_PIXELS) {
+        bands = pixels / CONVERSION_MIN_BAND_PIXELS;
+    }
+    if (bands > image->height) {
+        bands = image->height;
+    }
+
+    const unsigned rows_per_band = (unsigned)((image->height + bands - 1) / bands);
+    const unsigned bands_count = (image->height + rows_per_band - 1) / rows_per_band;
+
+    struct band_context band_context = { image, pixel_consumer, row_kernel, &output_context, rows_per_band };
+
+    SAIL_TRY(sail_parallel_for(bands_count, threads, convert_band, &band_context));
+
+    return SAIL_OK;
+}
+
+struct sail_row_converter {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    /* Indexed and grayscale input colors expanded once. */
+    sail_rgba32_t index_table[256];
+    unsigned index_table_length;
+    struct sail_conversion_options options;
+    bool has_options;
+    pixel_consumer_t pixel_consumer;
+    row_kernel_t row_kernel;
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
 /*
  * Public functions.
  */
@@ -734,7 +972,9 @@ sail_status_t sail_convert_image_with_options(const struct sail_image *image,
     SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
                         /* cleanup */ sail_destroy_image(image_local));
 
-    SAIL_TRY_OR_CLEANUP(conversion_impl(image, image_local, pixel_consumer, r, g, b, a, options),
+    const row_kernel_t row_kernel = find_row_kernel(image->pixel_format, output_pixel_format, options);
+
+    SAIL_TRY_OR_CLEANUP(conversion_impl(image, image_local, pixel_consumer, row_kernel, r, g, b, a, options, NULL, 0),
                         /* cleanup */ sail_destroy_image(image_local));
 
     *image_output = image_local;
@@ -771,135 +1011,286 @@ sail_status_t sail_update_image_with_options(struct sail_image *image,
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
     }
 
-    SAIL_TRY(conversion_impl(image, image, pixel_consumer, r, g, b, a, options));
+    /*
+     * Convert rows in place keeping the input row stride. Every output row fits into its input
+     * row, and every pixel is read before it's overwritten, so no second buffer is needed.
+     */
+    const row_kernel_t row_kernel = find_row_kernel(image->pixel_format, output_pixel_format, options);
+
+    SAIL_TRY(conversion_impl(image, image, pixel_consumer, row_kernel, r, g, b, a, options, NULL, 0));
+
+    /* Pack the rows with the new stride. Rows only move backwards, so iterate forward. */
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, output_pixel_format);
+
+    if (bytes_per_line < image->bytes_per_line) {
+        for (unsigned row = 1; row < image->height; row++) {
+            memmove((uint8_t *)image->pixels + (size_t)bytes_per_line * row,
+                    (uint8_t *)image->pixels + (size_t)image->bytes_per_line * row,
+                    bytes_per_line);
+        }
+
+        image->bytes_per_line = bytes_per_line;
+    }
 
     image->pixel_format = output_pixel_format;
 
     return SAIL_OK;
 }
 
-bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+sail_status_t sail_alloc_row_converter(enum SailPixelFormat input_pixel_format,
+                                       enum SailPixelFormat output_pixel_format,
+                                       const struct sail_palette *palette,
+                                       const struct sail_conversion_options *options,
+                                       struct sail_row_converter **row_converter) {
 
-    /* After adding a new input pixel format, also update the switch in conversion_impl(). */
-    switch (input_pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP8_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
-        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA:
-        case SAIL_PIXEL_FORMAT_BPP16_RGB555:
-        case SAIL_PIXEL_FORMAT_BPP16_BGR555:
-        case SAIL_PIXEL_FORMAT_BPP16_RGB565:
-        case SAIL_PIXEL_FORMAT_BPP16_BGR565:
-        case SAIL_PIXEL_FORMAT_BPP24_RGB:
-        case SAIL_PIXEL_FORMAT_BPP24_BGR:
-        case SAIL_PIXEL_FORMAT_BPP48_RGB:
-        case SAIL_PIXEL_FORMAT_BPP48_BGR:
-        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
-        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
-        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
-        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
-        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
-        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
-        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
-        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
-        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
-        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
-        case SAIL_PIXEL_FORMAT_BPP32_CMYK:
-        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
-            int r, g, b, a;
-            pixel_consumer_t pixel_consumer;
-            return verify_and_construct_rgba_indexes_silent(output_pixel_format, &pixel_consumer, &r, &g, &b, &a);
-        }
-        default: {
-            return false;
-        }
+    SAIL_CHECK_PTR(row_converter);
+
+    int r, g, b, a;
+    pixel_consumer_t pixel_consumer;
+    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &pixel_consumer, &r, &g, &b, &a));
+
+    if (!sail_can_convert(input_pixel_format, output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion from %s to %s is not currently supported",
+                        sail_pixel_format_to_string(input_pixel_format), sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (sail_is_indexed(input_pixel_format) && palette == NULL) {
+        SAIL_LOG_ERROR("Conversion from %s requires a palette", sail_pixel_format_to_string(input_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_row_converter), &ptr));
+    struct sail_row_converter *row_converter_local = ptr;
+
+    row_converter_local->input_pixel_format  = input_pixel_format;
+    row_converter_local->output_pixel_format = output_pixel_format;
+    row_converter_local->index_table_length  = 0;
+    row_converter_local->has_options         = options != NULL;
+    row_converter_local->pixel_consumer      = pixel_consumer;
+    row_converter_local->row_kernel          = find_row_kernel(input_pixel_format, output_pixel_format, options);
+    row_converter_local->r                   = r;
+    row_converter_local->g                   = g;
+    row_converter_local->b                   = b;
+    row_converter_local->a                   = a;
+
+    if (options != NULL) {
+        row_converter_local->options = *options;
+    }
+
+    const unsigned bits_per_pixel = index_bits_per_pixel(input_pixel_format);
+
+    if (bits_per_pixel > 0) {
+        SAIL_TRY_OR_CLEANUP(build_index_table(palette,
+                                              bits_per_pixel,
+                                              sail_is_indexed(input_pixel_format),
+                                              row_converter_local->index_table,
+                                              &row_converter_local->index_table_length),
+                            /* cleanup */ sail_destroy_row_converter(row_converter_local));
+    }
+
+    *row_converter = row_converter_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_row_converter(struct sail_row_converter *row_converter) {
+
+    if (row_converter == NULL) {
+        return;
+    }
+
+    sail_free(row_converter);
+}
+
+sail_status_t sail_convert_rows(const struct sail_row_converter *row_converter,
+                                unsigned width,
+                                unsigned rows,
+                                const void *input,
+                                unsigned input_bytes_per_line,
+                                void *output,
+                                unsigned output_bytes_per_line) {
+
+    SAIL_CHECK_PTR(row_converter);
+    SAIL_CHECK_PTR(input);
+    SAIL_CHECK_PTR(output);
+
+    if (width == 0) {
+        SAIL_LOG_ERROR("Cannot convert rows of zero width");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (input_bytes_per_line < sail_bytes_per_line(width, row_converter->input_pixel_format) ||
+            output_bytes_per_line < sail_bytes_per_line(width, row_converter->output_pixel_format)) {
+        SAIL_LOG_ERROR("Row strides %u and %u are too small for %u pixels", input_bytes_per_line, output_bytes_per_line, width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    if (rows == 0) {
+        return SAIL_OK;
     }
+
+    /* Wrap the caller buffers into images to reuse the image conversion routines. */
+    struct sail_image input_image = { 0 };
+    input_image.pixels         = (void *)input;
+    input_image.width          = width;
+    input_image.height         = rows;
+    input_image.bytes_per_line = input_bytes_per_line;
+    input_image.pixel_format   = row_converter->input_pixel_format;
+
+    struct sail_image output_image = { 0 };
+    output_image.pixels         = output;
+    output_image.width          = width;
+    output_image.height         = rows;
+    output_image.bytes_per_line = output_bytes_per_line;
+    output_image.pixel_format   = row_converter->output_pixel_format;
+
+    SAIL_TRY(conversion_impl(&input_image,
+                             &output_image,
+                             row_converter->pixel_consumer,
+                             row_converter->row_kernel,
+                             row_converter->r,
+                             row_converter->g,
+                             row_converter->b,
+                             row_converter->a,
+                             row_converter->has_options ? &row_converter->options : NULL,
+                             (index_bits_per_pixel(row_converter->input_pixel_format) > 0) ? row_converter->index_table : NULL,
+                             row_converter->index_table_length));
+
+    return SAIL_OK;
 }
 
-/* Sorted by priority. */
-static const enum SailPixelFormat GRAYSCALE_CANDIDATES[] = {
+sail_status_t sail_convert_row(const struct sail_row_converter *row_converter, unsigned width, const void *input, void *output) {
+
+    SAIL_CHECK_PTR(row_converter);
+
+    SAIL_TRY(sail_convert_rows(row_converter,
+                               width,
+                               1,
+                               input,
+                               sail_bytes_per_line(width, row_converter->input_pixel_format),
+                               output,
+                               sail_bytes_per_line(width, row_converter->output_pixel_format)));
+
+    return SAIL_OK;
+}
+
+/* Indexed by the input pixel format. After adding a new input pixel format, also update the switch in convert_rows(). */
+static const bool CONVERTIBLE_INPUT_PIXEL_FORMATS[] = {
+    [SAIL_PIXEL_FORMAT_BPP1_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP2_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP4_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP8_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE]       = true,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA] = true,
+    [SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA] = true,
+    [SAIL_PIXEL_FORMAT_BPP16_RGB555]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_BGR555]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_RGB565]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_BGR565]          = true,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_CMYK]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_YCCK]            = true,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]           = true,
+};
+
+static const size_t CONVERTIBLE_INPUT_PIXEL_FORMATS_LENGTH = sizeof(CONVERTIBLE_INPUT_PIXEL_FORMATS) / sizeof(CONVERTIBLE_INPUT_PIXEL_FORMATS[0]);
+
+bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    return (size_t)input_pixel_format < CONVERTIBLE_INPUT_PIXEL_FORMATS_LENGTH &&
+            CONVERTIBLE_INPUT_PIXEL_FORMATS[input_pixel_format] &&
+            find_output_pixel_format_info(output_pixel_format) != NULL;
+}
+
+/*
+ * Candidate output pixel formats indexed by the pixel format. Lower ranks are preferred.
+ * Pixel formats with the zero rank are not candidates.
+ */
+static const uint8_t GRAYSCALE_CANDIDATE_RANKS[] = {
 
     /* After adding a new output pixel format, also update this list. */
-    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
-    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
-
-    SAIL_PIXEL_FORMAT_BPP24_YCBCR,
-
-    SAIL_PIXEL_FORMAT_BPP24_RGB,
-    SAIL_PIXEL_FORMAT_BPP24_BGR,
-
-    SAIL_PIXEL_FORMAT_BPP48_RGB,
-    SAIL_PIXEL_FORMAT_BPP48_BGR,
-
-    SAIL_PIXEL_FORMAT_BPP32_RGBA,
-    SAIL_PIXEL_FORMAT_BPP32_BGRA,
-    SAIL_PIXEL_FORMAT_BPP32_ARGB,
-    SAIL_PIXEL_FORMAT_BPP32_ABGR,
-    SAIL_PIXEL_FORMAT_BPP32_RGBX,
-    SAIL_PIXEL_FORMAT_BPP32_BGRX,
-    SAIL_PIXEL_FORMAT_BPP32_XRGB,
-    SAIL_PIXEL_FORMAT_BPP32_XBGR,
-
-    SAIL_PIXEL_FORMAT_BPP64_RGBA,
-    SAIL_PIXEL_FORMAT_BPP64_BGRA,
-    SAIL_PIXEL_FORMAT_BPP64_ARGB,
-    SAIL_PIXEL_FORMAT_BPP64_ABGR,
-    SAIL_PIXEL_FORMAT_BPP64_RGBX,
-    SAIL_PIXEL_FORMAT_BPP64_BGRX,
-    SAIL_PIXEL_FORMAT_BPP64_XRGB,
-    SAIL_PIXEL_FORMAT_BPP64_XBGR,
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]  = 1,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE] = 2,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]     = 3,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]       = 4,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]       = 5,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]       = 6,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]       = 7,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]      = 8,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]      = 9,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]      = 10,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]      = 11,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]      = 12,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]      = 13,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]      = 14,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]      = 15,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]      = 16,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]      = 17,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]      = 18,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]      = 19,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]      = 20,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]      = 21,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]      = 22,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]      = 23,
 };
 
-static const size_t GRAYSCALE_CANDIDATES_LENGTH = sizeof(GRAYSCALE_CANDIDATES) / sizeof(GRAYSCALE_CANDIDATES[0]);
+static const size_t GRAYSCALE_CANDIDATE_RANKS_LENGTH = sizeof(GRAYSCALE_CANDIDATE_RANKS) / sizeof(GRAYSCALE_CANDIDATE_RANKS[0]);
 
-/* Sorted by priority. */
-static const enum SailPixelFormat INDEXED_OR_FULL_COLOR_CANDIDATES[] = {
+/* Same as above for indexed and full-color input pixel formats. */
+static const uint8_t INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS[] = {
 
     /* After adding a new output pixel format, also update this list. */
-    SAIL_PIXEL_FORMAT_BPP24_YCBCR,
-
-    SAIL_PIXEL_FORMAT_BPP24_RGB,
-    SAIL_PIXEL_FORMAT_BPP24_BGR,
-
-    SAIL_PIXEL_FORMAT_BPP48_RGB,
-    SAIL_PIXEL_FORMAT_BPP48_BGR,
-
-    SAIL_PIXEL_FORMAT_BPP32_RGBA,
-    SAIL_PIXEL_FORMAT_BPP32_BGRA,
-    SAIL_PIXEL_FORMAT_BPP32_ARGB,
-    SAIL_PIXEL_FORMAT_BPP32_ABGR,
-    SAIL_PIXEL_FORMAT_BPP32_RGBX,
-    SAIL_PIXEL_FORMAT_BPP32_BGRX,
-    SAIL_PIXEL_FORMAT_BPP32_XRGB,
-    SAIL_PIXEL_FORMAT_BPP32_XBGR,
-
-    SAIL_PIXEL_FORMAT_BPP64_RGBA,
-    SAIL_PIXEL_FORMAT_BPP64_BGRA,
-    SAIL_PIXEL_FORMAT_BPP64_ARGB,
-    SAIL_PIXEL_FORMAT_BPP64_ABGR,
-    SAIL_PIXEL_FORMAT_BPP64_RGBX,
-    SAIL_PIXEL_FORMAT_BPP64_BGRX,
-    SAIL_PIXEL_FORMAT_BPP64_XRGB,
-    SAIL_PIXEL_FORMAT_BPP64_XBGR,
-
-    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
-    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]     = 1,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]       = 2,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]       = 3,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]       = 4,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]       = 5,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]      = 6,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]      = 7,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]      = 8,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]      = 9,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]      = 10,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]      = 11,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]      = 12,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]      = 13,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]      = 14,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]      = 15,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]      = 16,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]      = 17,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]      = 18,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]      = 19,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]      = 20,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]      = 21,
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]  = 22,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE] = 23,
 };
 
-static const size_t INDEXED_OR_FULL_COLOR_CANDIDATES_LENGTH = sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES) / sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES[0]);
+static const size_t INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS_LENGTH = sizeof(INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS) / sizeof(INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS[0]);
 
 enum SailPixelFormat sail_closest_pixel_format(enum SailPixelFormat input_pixel_format,
                                                const enum SailPixelFormat pixel_formats[],
@@ -909,36 +1300,34 @@ enum SailPixelFormat sail_closest_pixel_format(enum SailPixelFormat input_pixel_
         return SAIL_PIXEL_FORMAT_UNKNOWN;
     }
 
-    const enum SailPixelFormat *candidates;
-    size_t candidates_length;
+    const uint8_t *ranks;
+    size_t ranks_length;
 
     if (sail_is_grayscale(input_pixel_format)) {
-        candidates = GRAYSCALE_CANDIDATES;
-        candidates_length = GRAYSCALE_CANDIDATES_LENGTH;
+        ranks = GRAYSCALE_CANDIDATE_RANKS;
+        ranks_length = GRAYSCALE_CANDIDATE_RANKS_LENGTH;
     } else {
-        candidates = INDEXED_OR_FULL_COLOR_CANDIDATES;
-        candidates_length = INDEXED_OR_FULL_COLOR_CANDIDATES_LENGTH;
+        ranks = INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS;
+        ranks_length = INDEXED_OR_FULL_COLOR_CANDIDATE_RANKS_LENGTH;
     }
 
-    size_t best_index_candidate = UINT_MAX;
-    size_t best_index_result = 0;
-    bool found = false;
+    enum SailPixelFormat best_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
+    unsigned best_rank = UINT_MAX;
 
-    /* O(n^2) (sic!). */
     for (size_t i = 0; i < pixel_formats_length; i++) {
-        for (size_t k = 0; k < candidates_length; k++) {
-            if (pixel_formats[i] == candidates[k]) {
-                if (k < best_index_candidate) {
-                    best_index_candidate = k;
-                    best_index_result = i;
-                    found = true;
-                    break;
-                }
-            }
+        if ((size_t)pixel_formats[i] >= ranks_length) {
+            continue;
+        }
+
+        const unsigned rank = ranks[pixel_formats[i]];
+
+        if (rank != 0 && rank < best_rank) {
+            best_rank = rank;
+            best_pixel_format = pixel_formats[i];
         }
     }
 
-    return found ? pixel_formats[best_index_result] : SAIL_PIXEL_FORMAT_UNKNOWN;
+    return best_pixel_format;
 }
 
 enum SailPixelFormat sail_closest_pixel_format_from_save_features(enum SailPixelFormat input_pixel_format, const struct sail_save_features *save_features) {
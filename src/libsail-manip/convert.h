@@ -44,6 +44,8 @@ extern "C" {
 
 struct sail_conversion_options;
 struct sail_image;
+struct sail_palette;
+struct sail_row_converter;
 struct sail_save_features;
 
 /*
@@ -267,6 +269,58 @@ SAIL_EXPORT sail_status_t sail_update_image_with_options(struct sail_image *imag
                                                          enum SailPixelFormat output_pixel_format,
                                                          const struct sail_conversion_options *options);
 
+/*
+ * Allocates a row converter from the input pixel format to the output pixel format. The row converter
+ * converts rows between caller buffers. It allows to convert images while loading or saving them
+ * row by row with a working set of a few rows instead of a full-size intermediate image.
+ *
+ * Palette must be specified for indexed input pixel formats. It's ignored otherwise. The palette
+ * and the options (which may be NULL) are copied, so they can be destroyed right after the call.
+ *
+ * Allowed input and output pixel formats are the same as in sail_convert_image().
+ *
+ * The row converter is not modified by conversions, so it can be shared between threads.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_row_converter(enum SailPixelFormat input_pixel_format,
+                                                   enum SailPixelFormat output_pixel_format,
+                                                   const struct sail_palette *palette,
+                                                   const struct sail_conversion_options *options,
+                                                   struct sail_row_converter **row_converter);
+
+/*
+ * Destroys the specified row converter. Does nothing if the row converter is NULL.
+ */
+SAIL_EXPORT void sail_destroy_row_converter(struct sail_row_converter *row_converter);
+
+/*
+ * Converts the specified number of rows of the specified width from the input buffer
+ * to the output buffer. Rows in the buffers are separated by the specified strides.
+ *
+ * The input and output buffers may be the same if the output pixel format is not larger
+ * than the input pixel format, and the strides are equal.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_rows(const struct sail_row_converter *row_converter,
+                                            unsigned width,
+                                            unsigned rows,
+                                            const void *input,
+                                            unsigned input_bytes_per_line,
+                                            void *output,
+                                            unsigned output_bytes_per_line);
+
+/*
+ * Converts a single row of the specified width from the input buffer to the output buffer.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_convert_row(const struct sail_row_converter *row_converter,
+                                           unsigned width,
+                                           const void *input,
+                                           void *output);
+
 /*
  * Returns true if the conversion or updating functions can convert or update from the input
  * pixel format to the output pixel format.
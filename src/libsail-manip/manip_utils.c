@@ -25,10 +25,59 @@
 
 #include "sail-manip.h"
 
-/* https://en.wikipedia.org/wiki/Grayscale */
-static const double R_TO_GRAY_COEFFICIENT = 0.299;
-static const double G_TO_GRAY_COEFFICIENT = 0.587;
-static const double B_TO_GRAY_COEFFICIENT = 0.114;
+/*
+ * Integer arithmetic is used instead of floating point, so the per-pixel functions below
+ * vectorize and don't convert between integers and doubles in the inner loops.
+ *
+ * Alpha blending computes value * opacity + background * (1 - opacity) exactly and truncates
+ * the result. The floating-point version it replaces could be 1 less due to rounding.
+ */
+
+/*
+ * https://en.wikipedia.org/wiki/Grayscale
+ *
+ * 0.299, 0.587, and 0.114 in the 16.16 fixed-point format. The sum of the coefficients is
+ * exactly 1.0, so white stays white. The truncated result differs from the truncated
+ * floating-point weighted sum by at most 1.
+ */
+#define R_TO_GRAY_COEFFICIENT 19595u
+#define G_TO_GRAY_COEFFICIENT 38470u
+#define B_TO_GRAY_COEFFICIENT 7471u
+
+static inline uint8_t rgb24_to_gray8(uint8_t r, uint8_t g, uint8_t b) {
+
+    return (uint8_t)((R_TO_GRAY_COEFFICIENT * r + G_TO_GRAY_COEFFICIENT * g + B_TO_GRAY_COEFFICIENT * b) >> 16);
+}
+
+static inline uint16_t rgb48_to_gray16(uint16_t r, uint16_t g, uint16_t b) {
+
+    /* The maximum sum is 65535 * 65536 which fits 32 bits. */
+    return (uint16_t)((R_TO_GRAY_COEFFICIENT * r + G_TO_GRAY_COEFFICIENT * g + B_TO_GRAY_COEFFICIENT * b) >> 16);
+}
+
+static inline uint8_t narrow16(uint16_t value) {
+
+    return (uint8_t)(value / 257);
+}
+
+/* 8-bit value blended with an 8-bit background. */
+static inline uint8_t blend8(uint8_t value, uint8_t background, uint8_t alpha) {
+
+    return (uint8_t)(((unsigned)value * alpha + (unsigned)background * (255u - alpha)) / 255u);
+}
+
+/* 8-bit value expanded to 16 bits and blended with a 16-bit background. */
+static inline uint16_t blend8_to_16(uint8_t value, uint16_t background, uint8_t alpha) {
+
+    return (uint16_t)(((uint32_t)value * 257u * alpha + (uint32_t)background * (255u - alpha)) / 255u);
+}
+
+/* 16-bit value blended with a 16-bit background. */
+static inline uint16_t blend16(uint16_t value, uint16_t background, uint16_t alpha) {
+
+    /* The maximum sum is 65535 * 65535 which fits 32 bits. */
+    return (uint16_t)(((uint32_t)value * alpha + (uint32_t)background * (65535u - alpha)) / 65535u);
+}
 
 sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned index, sail_rgba32_t *rgba32) {
 
@@ -65,6 +114,17 @@ sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned in
     return SAIL_OK;
 }
 
+sail_status_t build_palette_rgba32_table(const struct sail_palette *palette, unsigned max_length, sail_rgba32_t *table, unsigned *length) {
+
+    *length = (palette->color_count < max_length) ? palette->color_count : max_length;
+
+    for (unsigned i = 0; i < *length; i++) {
+        SAIL_TRY(get_palette_rgba32(palette, i, &table[i]));
+    }
+
+    return SAIL_OK;
+}
+
 void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32) {
 
     rgba32->component1 = rgba32->component2 = rgba32->component3 = value;
@@ -73,7 +133,7 @@ void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32) {
 
 void spread_gray16_to_rgba32(uint16_t value, sail_rgba32_t *rgba32) {
 
-    rgba32->component1 = rgba32->component2 = rgba32->component3 = (uint8_t)(value / 257.0);
+    rgba32->component1 = rgba32->component2 = rgba32->component3 = narrow16(value);
     rgba32->component4 = 255;
 }
 
@@ -94,18 +154,16 @@ void fill_gray8_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgb24_t rgb24;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgb24.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgb24.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgb24.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgb24.component1 = blend8(rgba32->component1, options->background24.component1, rgba32->component4);
+        rgb24.component2 = blend8(rgba32->component2, options->background24.component2, rgba32->component4);
+        rgb24.component3 = blend8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         rgb24.component1 = rgba32->component1;
         rgb24.component2 = rgba32->component2;
         rgb24.component3 = rgba32->component3;
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    *scan = rgb24_to_gray8(rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, const struct sail_conversion_options *options) {
@@ -113,18 +171,16 @@ void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgb24_t rgb24;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb24.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgb24.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgb24.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgb24.component1 = narrow16(blend16(rgba64->component1, options->background48.component1, rgba64->component4));
+        rgb24.component2 = narrow16(blend16(rgba64->component2, options->background48.component2, rgba64->component4));
+        rgb24.component3 = narrow16(blend16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        rgb24.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgb24.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgb24.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgb24.component1 = narrow16(rgba64->component1);
+        rgb24.component2 = narrow16(rgba64->component2);
+        rgb24.component3 = narrow16(rgba64->component3);
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    *scan = rgb24_to_gray8(rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -132,18 +188,16 @@ void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *
     sail_rgb48_t rgb48;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgb48.component1 = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend8_to_16(rgba32->component1, options->background48.component1, rgba32->component4);
+        rgb48.component2 = blend8_to_16(rgba32->component2, options->background48.component2, rgba32->component4);
+        rgb48.component3 = blend8_to_16(rgba32->component3, options->background48.component3, rgba32->component4);
     } else {
         rgb48.component1 = rgba32->component1 * 257;
         rgb48.component2 = rgba32->component2 * 257;
         rgb48.component3 = rgba32->component3 * 257;
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    *scan = rgb48_to_gray16(rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -151,28 +205,24 @@ void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t
     sail_rgb48_t rgb48;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb48.component1 = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend16(rgba64->component1, options->background48.component1, rgba64->component4);
+        rgb48.component2 = blend16(rgba64->component2, options->background48.component2, rgba64->component4);
+        rgb48.component3 = blend16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         rgb48.component1 = rgba64->component1;
         rgb48.component2 = rgba64->component2;
         rgb48.component3 = rgba64->component3;
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    *scan = rgb48_to_gray16(rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend8(rgba32->component1, options->background24.component1, rgba32->component4);
+        *(scan+g) = blend8(rgba32->component2, options->background24.component2, rgba32->component4);
+        *(scan+b) = blend8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -183,26 +233,22 @@ void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
 void fill_rgb24_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow16(blend16(rgba64->component1, options->background48.component1, rgba64->component4));
+        *(scan+g) = narrow16(blend16(rgba64->component2, options->background48.component2, rgba64->component4));
+        *(scan+b) = narrow16(blend16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow16(rgba64->component1);
+        *(scan+g) = narrow16(rgba64->component2);
+        *(scan+b) = narrow16(rgba64->component3);
     }
 }
 
 void fill_rgb48_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend8_to_16(rgba32->component1, options->background48.component1, rgba32->component4);
+        *(scan+g) = blend8_to_16(rgba32->component2, options->background48.component2, rgba32->component4);
+        *(scan+b) = blend8_to_16(rgba32->component3, options->background48.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1 * 257;
         *(scan+g) = rgba32->component2 * 257;
@@ -213,11 +259,9 @@ void fill_rgb48_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *s
 void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend16(rgba64->component1, options->background48.component1, rgba64->component4);
+        *(scan+g) = blend16(rgba64->component2, options->background48.component2, rgba64->component4);
+        *(scan+b) = blend16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -228,11 +272,9 @@ void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *
 void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend8(rgba32->component1, options->background24.component1, rgba32->component4);
+        *(scan+g) = blend8(rgba32->component2, options->background24.component2, rgba32->component4);
+        *(scan+b) = blend8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -247,30 +289,26 @@ void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *s
 void fill_rgba32_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow16(blend16(rgba64->component1, options->background48.component1, rgba64->component4));
+        *(scan+g) = narrow16(blend16(rgba64->component2, options->background48.component2, rgba64->component4));
+        *(scan+b) = narrow16(blend16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow16(rgba64->component1);
+        *(scan+g) = narrow16(rgba64->component2);
+        *(scan+b) = narrow16(rgba64->component3);
     }
 
     if (a >= 0) {
-        *(scan+a) = (uint8_t)(rgba64->component4 / 257.0);
+        *(scan+a) = narrow16(rgba64->component4);
     }
 }
 
 void fill_rgba64_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend8_to_16(rgba32->component1, options->background48.component1, rgba32->component4);
+        *(scan+g) = blend8_to_16(rgba32->component2, options->background48.component2, rgba32->component4);
+        *(scan+b) = blend8_to_16(rgba32->component3, options->background48.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1 * 257;
         *(scan+g) = rgba32->component2 * 257;
@@ -285,11 +323,9 @@ void fill_rgba64_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *
 void fill_rgba64_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend16(rgba64->component1, options->background48.component1, rgba64->component4);
+        *(scan+g) = blend16(rgba64->component2, options->background48.component2, rgba64->component4);
+        *(scan+b) = blend16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -306,11 +342,9 @@ void fill_ycbcr_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgba32_no_alpha.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgba32_no_alpha.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgba32_no_alpha.component1 = blend8(rgba32->component1, options->background24.component1, rgba32->component4);
+        rgba32_no_alpha.component2 = blend8(rgba32->component2, options->background24.component2, rgba32->component4);
+        rgba32_no_alpha.component3 = blend8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         rgba32_no_alpha = *rgba32;
     }
@@ -323,15 +357,13 @@ void fill_ycbcr_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgba32_no_alpha.component1 = narrow16(blend16(rgba64->component1, options->background48.component1, rgba64->component4));
+        rgba32_no_alpha.component2 = narrow16(blend16(rgba64->component2, options->background48.component2, rgba64->component4));
+        rgba32_no_alpha.component3 = narrow16(blend16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        rgba32_no_alpha.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgba32_no_alpha.component1 = narrow16(rgba64->component1);
+        rgba32_no_alpha.component2 = narrow16(rgba64->component2);
+        rgba32_no_alpha.component3 = narrow16(rgba64->component3);
     }
 
     convert_rgba32_to_ycbcr24(&rgba32_no_alpha, scan+0, scan+1, scan+2);
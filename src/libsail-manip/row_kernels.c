@@ -0,0 +1,336 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sail-common.h"
+
+#include "sail-manip.h"
+
+#include "row_kernels.h"
+#include "simd.h"
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Row templates. Every kernel below calls them with constant channel indexes, so after
+ * inlining the compiler generates a dedicated loop for every conversion without per-pixel
+ * function calls and branches. Missing input alpha is treated as opaque. Output alpha
+ * and X bytes are written at 'ao'.
+ */
+static inline void swizzle8_row(const uint8_t *input, uint8_t *output, unsigned width,
+                                unsigned input_size, int ri, int gi, int bi, int ai,
+                                unsigned output_size, int ro, int go, int bo, int ao) {
+
+    for (unsigned column = 0; column < width; column++) {
+        /* Read the whole pixel first as the input and output may overlap. */
+        const uint8_t r = input[ri];
+        const uint8_t g = input[gi];
+        const uint8_t b = input[bi];
+        const uint8_t a = (ai >= 0) ? input[ai] : 255;
+
+        output[ro] = r;
+        output[go] = g;
+        output[bo] = b;
+
+        if (ao >= 0) {
+            output[ao] = a;
+        }
+
+        input  += input_size;
+        output += output_size;
+    }
+}
+
+static inline void narrow16_row(const uint16_t *input, uint8_t *output, unsigned width,
+                                unsigned input_size, int ri, int gi, int bi, int ai,
+                                unsigned output_size, int ro, int go, int bo, int ao) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t r = (uint8_t)(input[ri] / 257);
+        const uint8_t g = (uint8_t)(input[gi] / 257);
+        const uint8_t b = (uint8_t)(input[bi] / 257);
+        const uint8_t a = (ai >= 0) ? (uint8_t)(input[ai] / 257) : 255;
+
+        output[ro] = r;
+        output[go] = g;
+        output[bo] = b;
+
+        if (ao >= 0) {
+            output[ao] = a;
+        }
+
+        input  += input_size;
+        output += output_size;
+    }
+}
+
+static inline void gray8_row(const uint8_t *input, uint8_t *output, unsigned width,
+                             unsigned output_size, int ro, int go, int bo, int ao) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t value = *input++;
+
+        output[ro] = value;
+        output[go] = value;
+        output[bo] = value;
+
+        if (ao >= 0) {
+            output[ao] = 255;
+        }
+
+        output += output_size;
+    }
+}
+
+#define DEFINE_SWIZZLE8_KERNEL(name, input_size, ri, gi, bi, ai, output_size, ro, go, bo, ao)        \
+    static void name(const void *input, void *output, unsigned width) {                              \
+        swizzle8_row(input, output, width, input_size, ri, gi, bi, ai, output_size, ro, go, bo, ao); \
+    }
+
+#define DEFINE_NARROW16_KERNEL(name, input_size, ri, gi, bi, ai, output_size, ro, go, bo, ao)        \
+    static void name(const void *input, void *output, unsigned width) {                              \
+        narrow16_row(input, output, width, input_size, ri, gi, bi, ai, output_size, ro, go, bo, ao); \
+    }
+
+#define DEFINE_GRAY8_KERNEL(name, output_size, ro, go, bo, ao)              \
+    static void name(const void *input, void *output, unsigned width) {    \
+        gray8_row(input, output, width, output_size, ro, go, bo, ao);      \
+    }
+
+#define DEFINE_YCBCR_KERNEL(name, output_size, ro, go, bo, ao)                                  \
+    static void name(const void *input, void *output, unsigned width) {                        \
+        convert_ycbcr24_row_to_rgba_kind(input, output, width, output_size, ro, go, bo, ao);   \
+    }
+
+#define DEFINE_YCCK_KERNEL(name, output_size, ro, go, bo, ao)                                   \
+    static void name(const void *input, void *output, unsigned width) {                        \
+        convert_ycck32_row_to_rgba_kind(input, output, width, output_size, ro, go, bo, ao);    \
+    }
+
+#define DEFINE_CMYK_KERNEL(name, output_size, ro, go, bo, ao)                                   \
+    static void name(const void *input, void *output, unsigned width) {                        \
+        convert_cmyk32_row_to_rgba_kind(input, output, width, output_size, ro, go, bo, ao);    \
+    }
+
+#define DEFINE_TO_YCBCR_KERNEL(name, input_size, ri, gi, bi)                                    \
+    static void name(const void *input, void *output, unsigned width) {                        \
+        convert_rgba_kind_row_to_ycbcr24(input, output, width, input_size, ri, gi, bi);        \
+    }
+
+/*                                            Input layout            Output layout */
+DEFINE_SWIZZLE8_KERNEL(rgb24_to_bgr24,        3, 0, 1, 2, -1,         3, 2, 1, 0, -1)
+DEFINE_SWIZZLE8_KERNEL(bgr24_to_rgb24,        3, 2, 1, 0, -1,         3, 0, 1, 2, -1)
+DEFINE_SWIZZLE8_KERNEL(rgb24_to_rgba32,       3, 0, 1, 2, -1,         4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(rgb24_to_bgra32,       3, 0, 1, 2, -1,         4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(rgb24_to_rgbx32,       3, 0, 1, 2, -1,         4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(bgr24_to_rgba32,       3, 2, 1, 0, -1,         4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(bgr24_to_bgra32,       3, 2, 1, 0, -1,         4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(bgr24_to_bgrx32,       3, 2, 1, 0, -1,         4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(rgba32_to_bgra32,      4, 0, 1, 2, 3,          4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(rgba32_to_argb32,      4, 0, 1, 2, 3,          4, 1, 2, 3, 0)
+DEFINE_SWIZZLE8_KERNEL(rgba32_to_abgr32,      4, 0, 1, 2, 3,          4, 3, 2, 1, 0)
+DEFINE_SWIZZLE8_KERNEL(bgra32_to_rgba32,      4, 2, 1, 0, 3,          4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(bgra32_to_argb32,      4, 2, 1, 0, 3,          4, 1, 2, 3, 0)
+DEFINE_SWIZZLE8_KERNEL(bgra32_to_abgr32,      4, 2, 1, 0, 3,          4, 3, 2, 1, 0)
+DEFINE_SWIZZLE8_KERNEL(argb32_to_rgba32,      4, 1, 2, 3, 0,          4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(argb32_to_bgra32,      4, 1, 2, 3, 0,          4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(abgr32_to_rgba32,      4, 3, 2, 1, 0,          4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(abgr32_to_bgra32,      4, 3, 2, 1, 0,          4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(rgbx32_to_rgba32,      4, 0, 1, 2, -1,         4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(rgbx32_to_bgra32,      4, 0, 1, 2, -1,         4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(bgrx32_to_rgba32,      4, 2, 1, 0, -1,         4, 0, 1, 2, 3)
+DEFINE_SWIZZLE8_KERNEL(bgrx32_to_bgra32,      4, 2, 1, 0, -1,         4, 2, 1, 0, 3)
+DEFINE_SWIZZLE8_KERNEL(rgba32_to_rgb24,       4, 0, 1, 2, 3,          3, 0, 1, 2, -1)
+DEFINE_SWIZZLE8_KERNEL(rgba32_to_bgr24,       4, 0, 1, 2, 3,          3, 2, 1, 0, -1)
+DEFINE_SWIZZLE8_KERNEL(bgra32_to_rgb24,       4, 2, 1, 0, 3,          3, 0, 1, 2, -1)
+DEFINE_SWIZZLE8_KERNEL(bgra32_to_bgr24,       4, 2, 1, 0, 3,          3, 2, 1, 0, -1)
+
+DEFINE_NARROW16_KERNEL(rgb48_to_rgb24,        3, 0, 1, 2, -1,         3, 0, 1, 2, -1)
+DEFINE_NARROW16_KERNEL(bgr48_to_bgr24,        3, 2, 1, 0, -1,         3, 2, 1, 0, -1)
+DEFINE_NARROW16_KERNEL(rgb48_to_rgba32,       3, 0, 1, 2, -1,         4, 0, 1, 2, 3)
+DEFINE_NARROW16_KERNEL(rgba64_to_rgba32,      4, 0, 1, 2, 3,          4, 0, 1, 2, 3)
+DEFINE_NARROW16_KERNEL(rgba64_to_bgra32,      4, 0, 1, 2, 3,          4, 2, 1, 0, 3)
+DEFINE_NARROW16_KERNEL(bgra64_to_bgra32,      4, 2, 1, 0, 3,          4, 2, 1, 0, 3)
+DEFINE_NARROW16_KERNEL(bgra64_to_rgba32,      4, 2, 1, 0, 3,          4, 0, 1, 2, 3)
+DEFINE_NARROW16_KERNEL(rgba64_to_rgb24,       4, 0, 1, 2, 3,          3, 0, 1, 2, -1)
+
+/*                                            Output layout */
+DEFINE_GRAY8_KERNEL(gray8_to_rgb24,           3, 0, 1, 2, -1)
+DEFINE_GRAY8_KERNEL(gray8_to_bgr24,           3, 2, 1, 0, -1)
+DEFINE_GRAY8_KERNEL(gray8_to_rgba32,          4, 0, 1, 2, 3)
+DEFINE_GRAY8_KERNEL(gray8_to_bgra32,          4, 2, 1, 0, 3)
+
+DEFINE_YCBCR_KERNEL(ycbcr24_to_rgb24,         3, 0, 1, 2, -1)
+DEFINE_YCBCR_KERNEL(ycbcr24_to_bgr24,         3, 2, 1, 0, -1)
+DEFINE_YCBCR_KERNEL(ycbcr24_to_rgba32,        4, 0, 1, 2, 3)
+DEFINE_YCBCR_KERNEL(ycbcr24_to_bgra32,        4, 2, 1, 0, 3)
+
+DEFINE_YCCK_KERNEL(ycck32_to_rgb24,           3, 0, 1, 2, -1)
+DEFINE_YCCK_KERNEL(ycck32_to_bgr24,           3, 2, 1, 0, -1)
+DEFINE_YCCK_KERNEL(ycck32_to_rgba32,          4, 0, 1, 2, 3)
+DEFINE_YCCK_KERNEL(ycck32_to_bgra32,          4, 2, 1, 0, 3)
+
+DEFINE_CMYK_KERNEL(cmyk32_to_rgb24,           3, 0, 1, 2, -1)
+DEFINE_CMYK_KERNEL(cmyk32_to_bgr24,           3, 2, 1, 0, -1)
+DEFINE_CMYK_KERNEL(cmyk32_to_rgba32,          4, 0, 1, 2, 3)
+DEFINE_CMYK_KERNEL(cmyk32_to_bgra32,          4, 2, 1, 0, 3)
+
+/*                                            Input layout */
+DEFINE_TO_YCBCR_KERNEL(rgb24_to_ycbcr24,      3, 0, 1, 2)
+DEFINE_TO_YCBCR_KERNEL(bgr24_to_ycbcr24,      3, 2, 1, 0)
+DEFINE_TO_YCBCR_KERNEL(rgba32_to_ycbcr24,     4, 0, 1, 2)
+DEFINE_TO_YCBCR_KERNEL(bgra32_to_ycbcr24,     4, 2, 1, 0)
+
+struct row_kernel_entry {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    row_kernel_t kernel;
+    /* The input alpha is dropped, so the kernel cannot be used when blending is requested. */
+    bool drops_alpha;
+};
+
+static const struct row_kernel_entry ROW_KERNELS[] = {
+
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP24_BGR,  rgb24_to_bgr24,    false },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP24_RGB,  bgr24_to_rgb24,    false },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_RGBA, rgb24_to_rgba32,   false },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_BGRA, rgb24_to_bgra32,   false },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_RGBX, rgb24_to_rgbx32,   false },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP32_RGBA, bgr24_to_rgba32,   false },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP32_BGRA, bgr24_to_bgra32,   false },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP32_BGRX, bgr24_to_bgrx32,   false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP32_BGRA, rgba32_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP32_ARGB, rgba32_to_argb32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP32_ABGR, rgba32_to_abgr32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP32_RGBA, bgra32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP32_ARGB, bgra32_to_argb32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP32_ABGR, bgra32_to_abgr32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB,      SAIL_PIXEL_FORMAT_BPP32_RGBA, argb32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB,      SAIL_PIXEL_FORMAT_BPP32_BGRA, argb32_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR,      SAIL_PIXEL_FORMAT_BPP32_RGBA, abgr32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR,      SAIL_PIXEL_FORMAT_BPP32_BGRA, abgr32_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX,      SAIL_PIXEL_FORMAT_BPP32_RGBA, rgbx32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX,      SAIL_PIXEL_FORMAT_BPP32_BGRA, rgbx32_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRX,      SAIL_PIXEL_FORMAT_BPP32_RGBA, bgrx32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRX,      SAIL_PIXEL_FORMAT_BPP32_BGRA, bgrx32_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP24_RGB,  rgba32_to_rgb24,   true  },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP24_BGR,  rgba32_to_bgr24,   true  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP24_RGB,  bgra32_to_rgb24,   true  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP24_BGR,  bgra32_to_bgr24,   true  },
+
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,       SAIL_PIXEL_FORMAT_BPP24_RGB,  rgb48_to_rgb24,    false },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,       SAIL_PIXEL_FORMAT_BPP24_BGR,  bgr48_to_bgr24,    false },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,       SAIL_PIXEL_FORMAT_BPP32_RGBA, rgb48_to_rgba32,   false },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP32_RGBA, rgba64_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP32_BGRA, rgba64_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA,      SAIL_PIXEL_FORMAT_BPP32_BGRA, bgra64_to_bgra32,  false },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA,      SAIL_PIXEL_FORMAT_BPP32_RGBA, bgra64_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP24_RGB,  rgba64_to_rgb24,   true  },
+
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP24_RGB,  gray8_to_rgb24,    false },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP24_BGR,  gray8_to_bgr24,    false },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP32_RGBA, gray8_to_rgba32,   false },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP32_BGRA, gray8_to_bgra32,   false },
+
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP24_RGB,  ycbcr24_to_rgb24,  false },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP24_BGR,  ycbcr24_to_bgr24,  false },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP32_RGBA, ycbcr24_to_rgba32, false },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP32_BGRA, ycbcr24_to_bgra32, false },
+
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP24_RGB,  ycck32_to_rgb24,   false },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP24_BGR,  ycck32_to_bgr24,   false },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP32_RGBA, ycck32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP32_BGRA, ycck32_to_bgra32,  false },
+
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP24_RGB,  cmyk32_to_rgb24,   false },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP24_BGR,  cmyk32_to_bgr24,   false },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP32_RGBA, cmyk32_to_rgba32,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP32_BGRA, cmyk32_to_bgra32,  false },
+
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP24_YCBCR, rgb24_to_ycbcr24,  false },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP24_YCBCR, bgr24_to_ycbcr24,  false },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP24_YCBCR, rgba32_to_ycbcr24, true  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP24_YCBCR, bgra32_to_ycbcr24, true  },
+};
+
+static const size_t ROW_KERNELS_LENGTH = sizeof(ROW_KERNELS) / sizeof(ROW_KERNELS[0]);
+
+/*
+ * Public functions.
+ */
+
+row_kernel_t find_row_kernel(enum SailPixelFormat input_pixel_format,
+                             enum SailPixelFormat output_pixel_format,
+                             const struct sail_conversion_options *options) {
+
+    const bool blend_alpha = options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+
+    /*
+     * Streams of small images usually repeat the same conversion, so remember the last lookup
+     * to skip scanning the tables again.
+     */
+    static SAIL_THREAD_LOCAL bool cached = false;
+    static SAIL_THREAD_LOCAL enum SailPixelFormat cached_input_pixel_format;
+    static SAIL_THREAD_LOCAL enum SailPixelFormat cached_output_pixel_format;
+    static SAIL_THREAD_LOCAL bool cached_blend_alpha;
+    static SAIL_THREAD_LOCAL row_kernel_t cached_kernel;
+
+    if (cached &&
+            cached_input_pixel_format == input_pixel_format &&
+            cached_output_pixel_format == output_pixel_format &&
+            cached_blend_alpha == blend_alpha) {
+        return cached_kernel;
+    }
+
+    row_kernel_t kernel = NULL;
+
+    for (size_t i = 0; i < ROW_KERNELS_LENGTH; i++) {
+        const struct row_kernel_entry *entry = &ROW_KERNELS[i];
+
+        if (entry->input_pixel_format == input_pixel_format && entry->output_pixel_format == output_pixel_format) {
+            if (!(entry->drops_alpha && blend_alpha)) {
+                /* SIMD kernels produce the same output, so prefer them when the CPU supports them. */
+                const row_kernel_t simd_kernel = find_simd_row_kernel(input_pixel_format, output_pixel_format);
+
+                kernel = (simd_kernel != NULL) ? simd_kernel : entry->kernel;
+            }
+
+            break;
+        }
+    }
+
+    cached                     = true;
+    cached_input_pixel_format  = input_pixel_format;
+    cached_output_pixel_format = output_pixel_format;
+    cached_blend_alpha         = blend_alpha;
+    cached_kernel              = kernel;
+
+    return kernel;
+}
@@ -0,0 +1,54 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROW_KERNELS_H
+#define SAIL_ROW_KERNELS_H
+
+#ifdef SAIL_BUILD
+    #include "export.h"
+    #include "pixel.h"
+#else
+    #include <sail-common/export.h>
+    #include <sail-common/pixel.h>
+#endif
+
+struct sail_conversion_options;
+
+/*
+ * Converts 'width' pixels of a single row. The input and the output may point to the same row
+ * when the output pixels are not larger than the input pixels.
+ */
+typedef void (*row_kernel_t)(const void *input, void *output, unsigned width);
+
+/*
+ * Returns a specialized row kernel for the specified conversion or NULL if there is no one,
+ * and the generic per-pixel conversion must be used. Kernels produce the same output
+ * as the generic conversion except that X bytes of the RGBX-like output formats are set to 255.
+ */
+SAIL_HIDDEN row_kernel_t find_row_kernel(enum SailPixelFormat input_pixel_format,
+                                         enum SailPixelFormat output_pixel_format,
+                                         const struct sail_conversion_options *options);
+
+#endif
@@ -36,6 +36,8 @@
     #include "convert.h"
     #include "manip_common.h"
     #include "manip_utils.h"
+    #include "row_kernels.h"
+    #include "simd.h"
     #include "ycbcr.h"
     #include "ycck.h"
 #else
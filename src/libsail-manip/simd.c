@@ -0,0 +1,1108 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+#include "cmyk.h"
+#include "simd.h"
+#include "ycbcr.h"
+#include "ycck.h"
+
+#if defined(SAIL_ENABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+    #define SIMD_X86
+#elif defined(SAIL_ENABLE_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+    #define SIMD_NEON
+#endif
+
+#ifdef SIMD_X86
+    #include <immintrin.h>
+
+    #ifdef _MSC_VER
+        #include <intrin.h>
+
+        /* MSVC allows all intrinsics without enabling them globally. */
+        #define TARGET_SSE2
+        #define TARGET_SSSE3
+        #define TARGET_AVX2
+    #else
+        #include <cpuid.h>
+
+        #define TARGET_SSE2  __attribute__((target("sse2")))
+        #define TARGET_SSSE3 __attribute__((target("ssse3")))
+        #define TARGET_AVX2  __attribute__((target("avx2")))
+    #endif
+#endif
+
+#ifdef SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Describes a conversion of a single pixel. Output component 'i' is taken from the input component
+ * 'source[i]', or set to 255 if it's negative. 16-bit input components are narrowed to 8 bits.
+ */
+struct shuffle_pattern {
+    unsigned input_size;
+    unsigned output_size;
+    int source[4];
+};
+
+static inline uint8_t narrow16(uint16_t value) {
+
+    /* Same as value / 257 for all 16-bit values. */
+    return (uint8_t)((value - (value >> 8)) >> 8);
+}
+
+static void shuffle8_tail(const struct shuffle_pattern *pattern, const uint8_t *input, uint8_t *output, unsigned column, unsigned width) {
+
+    input  += (size_t)column * pattern->input_size;
+    output += (size_t)column * pattern->output_size;
+
+    for (; column < width; column++) {
+        uint8_t pixel[4];
+
+        for (unsigned i = 0; i < pattern->output_size; i++) {
+            pixel[i] = (pattern->source[i] >= 0) ? input[pattern->source[i]] : 255;
+        }
+        for (unsigned i = 0; i < pattern->output_size; i++) {
+            output[i] = pixel[i];
+        }
+
+        input  += pattern->input_size;
+        output += pattern->output_size;
+    }
+}
+
+static void narrow16_tail(const struct shuffle_pattern *pattern, const uint16_t *input, uint8_t *output, unsigned column, unsigned width) {
+
+    input  += (size_t)column * pattern->input_size;
+    output += (size_t)column * pattern->output_size;
+
+    for (; column < width; column++) {
+        uint8_t pixel[4];
+
+        for (unsigned i = 0; i < pattern->output_size; i++) {
+            pixel[i] = (pattern->source[i] >= 0) ? narrow16(input[pattern->source[i]]) : 255;
+        }
+        for (unsigned i = 0; i < pattern->output_size; i++) {
+            output[i] = pixel[i];
+        }
+
+        input  += pattern->input_size;
+        output += pattern->output_size;
+    }
+}
+
+/*
+ * Describes an RGB-like pixel: the output of color space conversions or the input of RGB -> YCbCr.
+ * Alpha index is -1 when there is no alpha.
+ */
+struct rgb_layout {
+    unsigned pixel_size;
+    int r, g, b, a;
+};
+
+static const struct rgb_layout YCBCR_LAYOUT = { 3, 0, 1, 2, -1 };
+
+/*
+ * Replaces a 256-entry table from ycbcr.c or ycck.c with fixed-point arithmetic:
+ * table[x] == (x * factor + addend) >> 14 for every 8-bit x. The constants reproduce
+ * every entry exactly, not just approximately.
+ */
+struct fixed_point_table {
+    int16_t factor;
+    int32_t addend;
+};
+
+/* YCbCr -> RGB. */
+static const struct fixed_point_table YCBCR_CR_R = { 22970, -2931968 };
+static const struct fixed_point_table YCBCR_CB_G = {  5638,  -713472 };
+static const struct fixed_point_table YCBCR_CR_G = { 11700, -1489408 };
+static const struct fixed_point_table YCBCR_CB_B = { 29033, -3708032 };
+
+/* YCCK -> RGB. */
+static const struct fixed_point_table YCCK_CR_R  = { 22970,     8284 };
+static const struct fixed_point_table YCCK_CB_G  = {  5638,     8196 };
+static const struct fixed_point_table YCCK_CR_G  = { 11700,     8192 };
+static const struct fixed_point_table YCCK_CB_B  = { 29032,     8248 };
+
+/* RGB -> YCbCr. */
+static const struct fixed_point_table R_Y        = {  4899,     8192 };
+static const struct fixed_point_table G_Y        = {  9617,     8192 };
+static const struct fixed_point_table B_Y        = {  1868,     8192 };
+static const struct fixed_point_table R_CB       = {  2765,     8143 };
+static const struct fixed_point_table G_CB       = {  5427,     8240 };
+static const struct fixed_point_table B_CB       = {  8192,     8192 };
+static const struct fixed_point_table R_CR       = {  8192,     8192 };
+static const struct fixed_point_table G_CR       = {  6860,     8187 };
+static const struct fixed_point_table B_CR       = {  1332,     8192 };
+
+#endif
+
+#ifdef SIMD_X86
+
+/* Builds PSHUFB and OR masks that apply the pattern to 4 pixels in a 16-byte block. */
+static void build_x86_masks(const struct shuffle_pattern *pattern, uint8_t shuffle_mask[16], uint8_t or_mask[16]) {
+
+    for (unsigned i = 0; i < 16; i++) {
+        shuffle_mask[i] = 0x80;
+        or_mask[i]      = 0;
+    }
+
+    for (unsigned pixel = 0; pixel < 4; pixel++) {
+        for (unsigned i = 0; i < pattern->output_size; i++) {
+            const unsigned index = pixel * pattern->output_size + i;
+
+            if (pattern->source[i] >= 0) {
+                shuffle_mask[index] = (uint8_t)(pixel * pattern->input_size + (unsigned)pattern->source[i]);
+            } else {
+                or_mask[index] = 0xFF;
+            }
+        }
+    }
+}
+
+static bool detect_cpu_support(enum SimdLevel level) {
+
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    ecx = (unsigned)info[2];
+    edx = (unsigned)info[3];
+#else
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+#endif
+
+    switch (level) {
+        case SIMD_LEVEL_SSE2:  return (edx & (1u << 26)) != 0;
+        case SIMD_LEVEL_SSSE3: return (ecx & (1u << 9)) != 0;
+        case SIMD_LEVEL_AVX2: {
+            /* The OS must save YMM registers on context switches. */
+            const bool osxsave = (ecx & (1u << 27)) != 0;
+
+            if (!osxsave) {
+                return false;
+            }
+
+#ifdef _MSC_VER
+            const unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            ebx = (unsigned)info[1];
+#else
+            unsigned xcr0_eax, xcr0_edx;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_eax), "=d"(xcr0_edx) : "c"(0));
+            const unsigned long long xcr0 = xcr0_eax | ((unsigned long long)xcr0_edx << 32);
+
+            if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+                return false;
+            }
+#endif
+
+            return (xcr0 & 6) == 6 && (ebx & (1u << 5)) != 0;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+/* cpuid is expensive compared to converting a small image, so query it once per thread. */
+static bool cpu_supports(enum SimdLevel level) {
+
+    static SAIL_THREAD_LOCAL bool initialized = false;
+    static SAIL_THREAD_LOCAL bool supported[SIMD_LEVEL_NEON + 1];
+
+    if (!initialized) {
+        for (int i = SIMD_LEVEL_SSE2; i <= SIMD_LEVEL_NEON; i++) {
+            supported[i] = detect_cpu_support((enum SimdLevel)i);
+        }
+
+        initialized = true;
+    }
+
+    return supported[level];
+}
+
+/* 4 pixels per iteration. Input and output pixels are 3 or 4 bytes. */
+TARGET_SSSE3
+static void shuffle8_ssse3(const struct shuffle_pattern *pattern, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    uint8_t shuffle_mask_bytes[16], or_mask_bytes[16];
+    build_x86_masks(pattern, shuffle_mask_bytes, or_mask_bytes);
+
+    const __m128i shuffle_mask = _mm_loadu_si128((const __m128i *)shuffle_mask_bytes);
+    const __m128i or_mask      = _mm_loadu_si128((const __m128i *)or_mask_bytes);
+
+    /* 16-byte loads and stores of 3-byte pixels touch 2 more pixels than converted. */
+    const unsigned guard = (pattern->input_size == 3 || pattern->output_size == 3) ? 6 : 4;
+    unsigned column = 0;
+
+    for (; column + guard <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(input + (size_t)column * pattern->input_size));
+        const __m128i result = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle_mask), or_mask);
+        _mm_storeu_si128((__m128i *)(output + (size_t)column * pattern->output_size), result);
+    }
+
+    shuffle8_tail(pattern, input, output, column, width);
+}
+
+/* 8 pixels per iteration. Input and output pixels are 4 bytes. */
+TARGET_AVX2
+static void shuffle8_avx2(const struct shuffle_pattern *pattern, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    uint8_t shuffle_mask_bytes[16], or_mask_bytes[16];
+    build_x86_masks(pattern, shuffle_mask_bytes, or_mask_bytes);
+
+    /* PSHUFB shuffles within 128-bit lanes, so both lanes use the same mask. */
+    const __m256i shuffle_mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle_mask_bytes));
+    const __m256i or_mask      = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)or_mask_bytes));
+
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(input + (size_t)column * 4));
+        const __m256i result = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle_mask), or_mask);
+        _mm256_storeu_si256((__m256i *)(output + (size_t)column * 4), result);
+    }
+
+    shuffle8_tail(pattern, input, output, column, width);
+}
+
+/* Narrows 16 components. */
+TARGET_SSE2
+static inline __m128i narrow16_block_sse2(const uint16_t *input) {
+
+    __m128i low  = _mm_loadu_si128((const __m128i *)(input + 0));
+    __m128i high = _mm_loadu_si128((const __m128i *)(input + 8));
+
+    low  = _mm_srli_epi16(_mm_sub_epi16(low,  _mm_srli_epi16(low,  8)), 8);
+    high = _mm_srli_epi16(_mm_sub_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+    return _mm_packus_epi16(low, high);
+}
+
+/* Narrowing without reordering. The components are processed as a flat stream. */
+TARGET_SSE2
+static void narrow16_sse2(const struct shuffle_pattern *pattern, const uint16_t *input, uint8_t *output, unsigned width) {
+
+    const size_t components = (size_t)width * pattern->input_size;
+    size_t i = 0;
+
+    for (; i + 16 <= components; i += 16) {
+        _mm_storeu_si128((__m128i *)(output + i), narrow16_block_sse2(input + i));
+    }
+
+    narrow16_tail(pattern, input, output, (unsigned)(i / pattern->input_size), width);
+}
+
+/* Narrowing with reordering. 4 pixels of 4 components per iteration. */
+TARGET_SSSE3
+static void narrow16_ssse3(const struct shuffle_pattern *pattern, const uint16_t *input, uint8_t *output, unsigned width) {
+
+    uint8_t shuffle_mask_bytes[16], or_mask_bytes[16];
+    build_x86_masks(pattern, shuffle_mask_bytes, or_mask_bytes);
+
+    const __m128i shuffle_mask = _mm_loadu_si128((const __m128i *)shuffle_mask_bytes);
+    const __m128i or_mask      = _mm_loadu_si128((const __m128i *)or_mask_bytes);
+
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = narrow16_block_sse2(input + (size_t)column * 4);
+        const __m128i result = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle_mask), or_mask);
+        _mm_storeu_si128((__m128i *)(output + (size_t)column * 4), result);
+    }
+
+    narrow16_tail(pattern, input, output, column, width);
+}
+
+/*
+ * Builds PSHUFB masks that extract the component 'index' of 8 pixels into 16-bit lanes. The pixels
+ * are loaded as two 16-byte blocks. The second block starts at pixel_size * 8 - 16, so the loads
+ * never touch bytes past the 8 pixels.
+ */
+static void build_x86_component_masks(unsigned pixel_size, int index, uint8_t first_mask[16], uint8_t second_mask[16]) {
+
+    const unsigned second_block = pixel_size * 8 - 16;
+
+    for (unsigned i = 0; i < 16; i++) {
+        first_mask[i]  = 0x80;
+        second_mask[i] = 0x80;
+    }
+
+    for (unsigned pixel = 0; pixel < 4; pixel++) {
+        first_mask[pixel * 2]      = (uint8_t)(pixel * pixel_size + (unsigned)index);
+        second_mask[8 + pixel * 2] = (uint8_t)((pixel + 4) * pixel_size + (unsigned)index - second_block);
+    }
+}
+
+/* Builds a PSHUFB mask that reorders 4 RGBA pixels into the layout. */
+static void build_x86_rgb_layout_mask(const struct rgb_layout *layout, uint8_t bytes[16]) {
+
+    for (unsigned i = 0; i < 16; i++) {
+        bytes[i] = 0x80;
+    }
+
+    for (unsigned pixel = 0; pixel < 4; pixel++) {
+        bytes[pixel * layout->pixel_size + (unsigned)layout->r] = (uint8_t)(pixel * 4 + 0);
+        bytes[pixel * layout->pixel_size + (unsigned)layout->g] = (uint8_t)(pixel * 4 + 1);
+        bytes[pixel * layout->pixel_size + (unsigned)layout->b] = (uint8_t)(pixel * 4 + 2);
+
+        if (layout->a >= 0) {
+            bytes[pixel * layout->pixel_size + (unsigned)layout->a] = (uint8_t)(pixel * 4 + 3);
+        }
+    }
+}
+
+/* Loads the masks built by build_x86_component_masks(). */
+TARGET_SSE2
+static inline void load_component_masks_sse2(unsigned pixel_size, int index, __m128i masks[2]) {
+
+    uint8_t first_mask_bytes[16], second_mask_bytes[16];
+    build_x86_component_masks(pixel_size, index, first_mask_bytes, second_mask_bytes);
+
+    masks[0] = _mm_loadu_si128((const __m128i *)first_mask_bytes);
+    masks[1] = _mm_loadu_si128((const __m128i *)second_mask_bytes);
+}
+
+/* Loads the mask built by build_x86_rgb_layout_mask(). */
+TARGET_SSE2
+static inline __m128i load_rgb_layout_mask_sse2(const struct rgb_layout *layout) {
+
+    uint8_t layout_mask_bytes[16];
+    build_x86_rgb_layout_mask(layout, layout_mask_bytes);
+
+    return _mm_loadu_si128((const __m128i *)layout_mask_bytes);
+}
+
+TARGET_SSSE3
+static inline __m128i extract_component_ssse3(__m128i first, __m128i second, __m128i first_mask, __m128i second_mask) {
+
+    return _mm_or_si128(_mm_shuffle_epi8(first, first_mask), _mm_shuffle_epi8(second, second_mask));
+}
+
+/* Returns table[x] for 8 16-bit values. */
+TARGET_SSE2
+static inline __m128i lookup_sse2(__m128i x, const struct fixed_point_table *table) {
+
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi32(table->factor);
+    const __m128i addend = _mm_set1_epi32(table->addend);
+
+    const __m128i low  = _mm_madd_epi16(_mm_unpacklo_epi16(x, zero), factor);
+    const __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(x, zero), factor);
+
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(low,  addend), 14),
+                           _mm_srai_epi32(_mm_add_epi32(high, addend), 14));
+}
+
+/* Same as apply_black() in cmyk.c for 8 16-bit values. */
+TARGET_SSE2
+static inline __m128i apply_black_sse2(__m128i value, __m128i k) {
+
+    const __m128i product = _mm_add_epi16(_mm_mullo_epi16(value, k), _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+/* Writes the lower 12 bytes. */
+TARGET_SSE2
+static inline void store12_sse2(uint8_t *output, __m128i value) {
+
+    _mm_storel_epi64((__m128i *)output, value);
+
+    const uint32_t tail = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+    memcpy(output + 8, &tail, sizeof(tail));
+}
+
+/*
+ * Clamps 8 pixels of signed 16-bit components to [0, 255], adds opaque alpha, and stores them
+ * in the layout built by build_x86_rgb_layout_mask(). Writes exactly 8 pixels.
+ */
+TARGET_SSSE3
+static inline void store_pixels_ssse3(__m128i c1, __m128i c2, __m128i c3, __m128i layout_mask, unsigned pixel_size, uint8_t *output) {
+
+    const __m128i c12 = _mm_packus_epi16(c1, c2);
+    const __m128i c34 = _mm_packus_epi16(c3, _mm_set1_epi16(255));
+
+    const __m128i c12_pairs = _mm_unpacklo_epi8(c12, _mm_srli_si128(c12, 8));
+    const __m128i c34_pairs = _mm_unpacklo_epi8(c34, _mm_srli_si128(c34, 8));
+
+    const __m128i low  = _mm_shuffle_epi8(_mm_unpacklo_epi16(c12_pairs, c34_pairs), layout_mask);
+    const __m128i high = _mm_shuffle_epi8(_mm_unpackhi_epi16(c12_pairs, c34_pairs), layout_mask);
+
+    if (pixel_size == 4) {
+        _mm_storeu_si128((__m128i *)(output + 0),  low);
+        _mm_storeu_si128((__m128i *)(output + 16), high);
+    } else {
+        store12_sse2(output + 0,  low);
+        store12_sse2(output + 12, high);
+    }
+}
+
+/* 8 pixels per iteration. */
+TARGET_SSSE3
+static void ycbcr24_to_rgb_ssse3(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    __m128i y_masks[2], cb_masks[2], cr_masks[2];
+    load_component_masks_sse2(3, 0, y_masks);
+    load_component_masks_sse2(3, 1, cb_masks);
+    load_component_masks_sse2(3, 2, cr_masks);
+
+    const __m128i layout_mask = load_rgb_layout_mask_sse2(layout);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8_t *pixels = input + (size_t)column * 3;
+        const __m128i first  = _mm_loadu_si128((const __m128i *)(pixels + 0));
+        const __m128i second = _mm_loadu_si128((const __m128i *)(pixels + 8));
+
+        const __m128i y  = extract_component_ssse3(first, second, y_masks[0],  y_masks[1]);
+        const __m128i cb = extract_component_ssse3(first, second, cb_masks[0], cb_masks[1]);
+        const __m128i cr = extract_component_ssse3(first, second, cr_masks[0], cr_masks[1]);
+
+        const __m128i r = _mm_add_epi16(y, lookup_sse2(cr, &YCBCR_CR_R));
+        const __m128i g = _mm_sub_epi16(_mm_sub_epi16(y, lookup_sse2(cb, &YCBCR_CB_G)), lookup_sse2(cr, &YCBCR_CR_G));
+        const __m128i b = _mm_add_epi16(y, lookup_sse2(cb, &YCBCR_CB_B));
+
+        store_pixels_ssse3(r, g, b, layout_mask, layout->pixel_size, output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_ycbcr24_row_to_rgba_kind(input + (size_t)column * 3, output + (size_t)column * layout->pixel_size, width - column,
+                                     layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 8 pixels per iteration. */
+TARGET_SSSE3
+static void ycck32_to_rgb_ssse3(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    __m128i y_masks[2], cb_masks[2], cr_masks[2], k_masks[2];
+    load_component_masks_sse2(4, 0, y_masks);
+    load_component_masks_sse2(4, 1, cb_masks);
+    load_component_masks_sse2(4, 2, cr_masks);
+    load_component_masks_sse2(4, 3, k_masks);
+
+    const __m128i layout_mask = load_rgb_layout_mask_sse2(layout);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max  = _mm_set1_epi16(255);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8_t *pixels = input + (size_t)column * 4;
+        const __m128i first  = _mm_loadu_si128((const __m128i *)(pixels + 0));
+        const __m128i second = _mm_loadu_si128((const __m128i *)(pixels + 16));
+
+        const __m128i y  = extract_component_ssse3(first, second, y_masks[0],  y_masks[1]);
+        const __m128i cb = extract_component_ssse3(first, second, cb_masks[0], cb_masks[1]);
+        const __m128i cr = extract_component_ssse3(first, second, cr_masks[0], cr_masks[1]);
+        const __m128i k  = extract_component_ssse3(first, second, k_masks[0],  k_masks[1]);
+
+        /* See convert_ycc_to_cmy() in ycck.c. */
+        __m128i c = _mm_sub_epi16(_mm_add_epi16(y, lookup_sse2(cr, &YCCK_CR_R)), _mm_set1_epi16(180));
+        __m128i m = _mm_add_epi16(_mm_sub_epi16(_mm_sub_epi16(y, lookup_sse2(cb, &YCCK_CB_G)), lookup_sse2(cr, &YCCK_CR_G)), _mm_set1_epi16(135));
+        __m128i yellow = _mm_sub_epi16(_mm_add_epi16(y, lookup_sse2(cb, &YCCK_CB_B)), _mm_set1_epi16(227));
+
+        c      = _mm_sub_epi16(max, _mm_min_epi16(_mm_max_epi16(c,      zero), max));
+        m      = _mm_sub_epi16(max, _mm_min_epi16(_mm_max_epi16(m,      zero), max));
+        yellow = _mm_sub_epi16(max, _mm_min_epi16(_mm_max_epi16(yellow, zero), max));
+
+        store_pixels_ssse3(apply_black_sse2(c, k), apply_black_sse2(m, k), apply_black_sse2(yellow, k),
+                           layout_mask, layout->pixel_size, output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_ycck32_row_to_rgba_kind(input + (size_t)column * 4, output + (size_t)column * layout->pixel_size, width - column,
+                                    layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 8 pixels per iteration. */
+TARGET_SSSE3
+static void cmyk32_to_rgb_ssse3(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    __m128i c_masks[2], m_masks[2], y_masks[2], k_masks[2];
+    load_component_masks_sse2(4, 0, c_masks);
+    load_component_masks_sse2(4, 1, m_masks);
+    load_component_masks_sse2(4, 2, y_masks);
+    load_component_masks_sse2(4, 3, k_masks);
+
+    const __m128i layout_mask = load_rgb_layout_mask_sse2(layout);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8_t *pixels = input + (size_t)column * 4;
+        const __m128i first  = _mm_loadu_si128((const __m128i *)(pixels + 0));
+        const __m128i second = _mm_loadu_si128((const __m128i *)(pixels + 16));
+
+        const __m128i k = extract_component_ssse3(first, second, k_masks[0], k_masks[1]);
+
+        const __m128i r = apply_black_sse2(extract_component_ssse3(first, second, c_masks[0], c_masks[1]), k);
+        const __m128i g = apply_black_sse2(extract_component_ssse3(first, second, m_masks[0], m_masks[1]), k);
+        const __m128i b = apply_black_sse2(extract_component_ssse3(first, second, y_masks[0], y_masks[1]), k);
+
+        store_pixels_ssse3(r, g, b, layout_mask, layout->pixel_size, output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_cmyk32_row_to_rgba_kind(input + (size_t)column * 4, output + (size_t)column * layout->pixel_size, width - column,
+                                    layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 8 pixels per iteration. Here the layout describes the input pixels. */
+TARGET_SSSE3
+static void rgb_to_ycbcr24_ssse3(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    __m128i r_masks[2], g_masks[2], b_masks[2];
+    load_component_masks_sse2(layout->pixel_size, layout->r, r_masks);
+    load_component_masks_sse2(layout->pixel_size, layout->g, g_masks);
+    load_component_masks_sse2(layout->pixel_size, layout->b, b_masks);
+
+    const __m128i layout_mask = load_rgb_layout_mask_sse2(&YCBCR_LAYOUT);
+    const size_t second_block = (size_t)layout->pixel_size * 8 - 16;
+    const __m128i half = _mm_set1_epi16(128);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8_t *pixels = input + (size_t)column * layout->pixel_size;
+        const __m128i first  = _mm_loadu_si128((const __m128i *)pixels);
+        const __m128i second = _mm_loadu_si128((const __m128i *)(pixels + second_block));
+
+        const __m128i r = extract_component_ssse3(first, second, r_masks[0], r_masks[1]);
+        const __m128i g = extract_component_ssse3(first, second, g_masks[0], g_masks[1]);
+        const __m128i b = extract_component_ssse3(first, second, b_masks[0], b_masks[1]);
+
+        const __m128i y  = _mm_add_epi16(_mm_add_epi16(lookup_sse2(r, &R_Y), lookup_sse2(g, &G_Y)), lookup_sse2(b, &B_Y));
+        const __m128i cb = _mm_add_epi16(_mm_sub_epi16(_mm_sub_epi16(half, lookup_sse2(r, &R_CB)), lookup_sse2(g, &G_CB)), lookup_sse2(b, &B_CB));
+        const __m128i cr = _mm_sub_epi16(_mm_sub_epi16(_mm_add_epi16(half, lookup_sse2(r, &R_CR)), lookup_sse2(g, &G_CR)), lookup_sse2(b, &B_CR));
+
+        store_pixels_ssse3(y, cb, cr, layout_mask, YCBCR_LAYOUT.pixel_size, output + (size_t)column * 3);
+    }
+
+    convert_rgba_kind_row_to_ycbcr24(input + (size_t)column * layout->pixel_size, output + (size_t)column * 3, width - column,
+                                     layout->pixel_size, layout->r, layout->g, layout->b);
+}
+
+#endif
+
+#ifdef SIMD_NEON
+
+/* 16 pixels per iteration. */
+static void shuffle8_neon(const struct shuffle_pattern *pattern, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    const uint8x16_t opaque = vdupq_n_u8(255);
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        uint8x16_t channels[4];
+
+        if (pattern->input_size == 4) {
+            const uint8x16x4_t pixels = vld4q_u8(input + (size_t)column * 4);
+            channels[0] = pixels.val[0];
+            channels[1] = pixels.val[1];
+            channels[2] = pixels.val[2];
+            channels[3] = pixels.val[3];
+        } else {
+            const uint8x16x3_t pixels = vld3q_u8(input + (size_t)column * 3);
+            channels[0] = pixels.val[0];
+            channels[1] = pixels.val[1];
+            channels[2] = pixels.val[2];
+            channels[3] = opaque;
+        }
+
+        if (pattern->output_size == 4) {
+            uint8x16x4_t result;
+            result.val[0] = (pattern->source[0] >= 0) ? channels[pattern->source[0]] : opaque;
+            result.val[1] = (pattern->source[1] >= 0) ? channels[pattern->source[1]] : opaque;
+            result.val[2] = (pattern->source[2] >= 0) ? channels[pattern->source[2]] : opaque;
+            result.val[3] = (pattern->source[3] >= 0) ? channels[pattern->source[3]] : opaque;
+            vst4q_u8(output + (size_t)column * 4, result);
+        } else {
+            uint8x16x3_t result;
+            result.val[0] = (pattern->source[0] >= 0) ? channels[pattern->source[0]] : opaque;
+            result.val[1] = (pattern->source[1] >= 0) ? channels[pattern->source[1]] : opaque;
+            result.val[2] = (pattern->source[2] >= 0) ? channels[pattern->source[2]] : opaque;
+            vst3q_u8(output + (size_t)column * 3, result);
+        }
+    }
+
+    shuffle8_tail(pattern, input, output, column, width);
+}
+
+static inline uint8x8_t narrow16_neon_vector(uint16x8_t value) {
+
+    return vshrn_n_u16(vsubq_u16(value, vshrq_n_u16(value, 8)), 8);
+}
+
+/* 8 pixels per iteration. */
+static void narrow16_neon(const struct shuffle_pattern *pattern, const uint16_t *input, uint8_t *output, unsigned width) {
+
+    const uint8x8_t opaque = vdup_n_u8(255);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        uint8x8_t channels[4];
+
+        if (pattern->input_size == 4) {
+            const uint16x8x4_t pixels = vld4q_u16(input + (size_t)column * 4);
+            channels[0] = narrow16_neon_vector(pixels.val[0]);
+            channels[1] = narrow16_neon_vector(pixels.val[1]);
+            channels[2] = narrow16_neon_vector(pixels.val[2]);
+            channels[3] = narrow16_neon_vector(pixels.val[3]);
+        } else {
+            const uint16x8x3_t pixels = vld3q_u16(input + (size_t)column * 3);
+            channels[0] = narrow16_neon_vector(pixels.val[0]);
+            channels[1] = narrow16_neon_vector(pixels.val[1]);
+            channels[2] = narrow16_neon_vector(pixels.val[2]);
+            channels[3] = opaque;
+        }
+
+        if (pattern->output_size == 4) {
+            uint8x8x4_t result;
+            result.val[0] = (pattern->source[0] >= 0) ? channels[pattern->source[0]] : opaque;
+            result.val[1] = (pattern->source[1] >= 0) ? channels[pattern->source[1]] : opaque;
+            result.val[2] = (pattern->source[2] >= 0) ? channels[pattern->source[2]] : opaque;
+            result.val[3] = (pattern->source[3] >= 0) ? channels[pattern->source[3]] : opaque;
+            vst4_u8(output + (size_t)column * 4, result);
+        } else {
+            uint8x8x3_t result;
+            result.val[0] = (pattern->source[0] >= 0) ? channels[pattern->source[0]] : opaque;
+            result.val[1] = (pattern->source[1] >= 0) ? channels[pattern->source[1]] : opaque;
+            result.val[2] = (pattern->source[2] >= 0) ? channels[pattern->source[2]] : opaque;
+            vst3_u8(output + (size_t)column * 3, result);
+        }
+    }
+
+    narrow16_tail(pattern, input, output, column, width);
+}
+
+/* Returns table[x] for 8 16-bit values. */
+static inline int16x8_t lookup_neon(uint16x8_t x, const struct fixed_point_table *table) {
+
+    const int16x8_t value  = vreinterpretq_s16_u16(x);
+    const int32x4_t addend = vdupq_n_s32(table->addend);
+
+    const int32x4_t low  = vmlal_n_s16(addend, vget_low_s16(value),  table->factor);
+    const int32x4_t high = vmlal_n_s16(addend, vget_high_s16(value), table->factor);
+
+    return vcombine_s16(vmovn_s32(vshrq_n_s32(low, 14)), vmovn_s32(vshrq_n_s32(high, 14)));
+}
+
+/* Same as apply_black() in cmyk.c. */
+static inline uint8x8_t apply_black_neon(uint8x8_t value, uint8x8_t k) {
+
+    const uint16x8_t product = vaddq_u16(vmull_u8(value, k), vdupq_n_u16(128));
+
+    return vshrn_n_u16(vaddq_u16(product, vshrq_n_u16(product, 8)), 8);
+}
+
+/* Stores 16 pixels with opaque alpha in the layout. */
+static inline void store_pixels_neon(const struct rgb_layout *layout, uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8_t *output) {
+
+    if (layout->pixel_size == 4) {
+        uint8x16x4_t result;
+        result.val[layout->r] = r;
+        result.val[layout->g] = g;
+        result.val[layout->b] = b;
+        result.val[layout->a] = vdupq_n_u8(255);
+        vst4q_u8(output, result);
+    } else {
+        uint8x16x3_t result;
+        result.val[layout->r] = r;
+        result.val[layout->g] = g;
+        result.val[layout->b] = b;
+        vst3q_u8(output, result);
+    }
+}
+
+static inline void ycbcr_to_rgb_neon(uint8x8_t y, uint8x8_t cb, uint8x8_t cr, uint8x8_t rgb[3]) {
+
+    const int16x8_t y16   = vreinterpretq_s16_u16(vmovl_u8(y));
+    const uint16x8_t cb16 = vmovl_u8(cb);
+    const uint16x8_t cr16 = vmovl_u8(cr);
+
+    rgb[0] = vqmovun_s16(vaddq_s16(y16, lookup_neon(cr16, &YCBCR_CR_R)));
+    rgb[1] = vqmovun_s16(vsubq_s16(vsubq_s16(y16, lookup_neon(cb16, &YCBCR_CB_G)), lookup_neon(cr16, &YCBCR_CR_G)));
+    rgb[2] = vqmovun_s16(vaddq_s16(y16, lookup_neon(cb16, &YCBCR_CB_B)));
+}
+
+/* See convert_ycc_to_cmy() in ycck.c. */
+static inline void ycck_to_rgb_neon(uint8x8_t y, uint8x8_t cb, uint8x8_t cr, uint8x8_t k, uint8x8_t rgb[3]) {
+
+    const int16x8_t y16   = vreinterpretq_s16_u16(vmovl_u8(y));
+    const uint16x8_t cb16 = vmovl_u8(cb);
+    const uint16x8_t cr16 = vmovl_u8(cr);
+
+    const uint8x8_t c      = vmvn_u8(vqmovun_s16(vsubq_s16(vaddq_s16(y16, lookup_neon(cr16, &YCCK_CR_R)), vdupq_n_s16(180))));
+    const uint8x8_t m      = vmvn_u8(vqmovun_s16(vaddq_s16(vsubq_s16(vsubq_s16(y16, lookup_neon(cb16, &YCCK_CB_G)), lookup_neon(cr16, &YCCK_CR_G)), vdupq_n_s16(135))));
+    const uint8x8_t yellow = vmvn_u8(vqmovun_s16(vsubq_s16(vaddq_s16(y16, lookup_neon(cb16, &YCCK_CB_B)), vdupq_n_s16(227))));
+
+    rgb[0] = apply_black_neon(c,      k);
+    rgb[1] = apply_black_neon(m,      k);
+    rgb[2] = apply_black_neon(yellow, k);
+}
+
+static inline void rgb_to_ycbcr_neon(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t ycbcr[3]) {
+
+    const uint16x8_t r16 = vmovl_u8(r);
+    const uint16x8_t g16 = vmovl_u8(g);
+    const uint16x8_t b16 = vmovl_u8(b);
+    const int16x8_t half = vdupq_n_s16(128);
+
+    ycbcr[0] = vqmovun_s16(vaddq_s16(vaddq_s16(lookup_neon(r16, &R_Y), lookup_neon(g16, &G_Y)), lookup_neon(b16, &B_Y)));
+    ycbcr[1] = vqmovun_s16(vaddq_s16(vsubq_s16(vsubq_s16(half, lookup_neon(r16, &R_CB)), lookup_neon(g16, &G_CB)), lookup_neon(b16, &B_CB)));
+    ycbcr[2] = vqmovun_s16(vsubq_s16(vsubq_s16(vaddq_s16(half, lookup_neon(r16, &R_CR)), lookup_neon(g16, &G_CR)), lookup_neon(b16, &B_CR)));
+}
+
+/* 16 pixels per iteration. */
+static void ycbcr24_to_rgb_neon(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(input + (size_t)column * 3);
+        uint8x8_t low[3], high[3];
+
+        ycbcr_to_rgb_neon(vget_low_u8(pixels.val[0]),  vget_low_u8(pixels.val[1]),  vget_low_u8(pixels.val[2]),  low);
+        ycbcr_to_rgb_neon(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]), vget_high_u8(pixels.val[2]), high);
+
+        store_pixels_neon(layout, vcombine_u8(low[0], high[0]), vcombine_u8(low[1], high[1]), vcombine_u8(low[2], high[2]),
+                          output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_ycbcr24_row_to_rgba_kind(input + (size_t)column * 3, output + (size_t)column * layout->pixel_size, width - column,
+                                     layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 16 pixels per iteration. */
+static void ycck32_to_rgb_neon(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(input + (size_t)column * 4);
+        uint8x8_t low[3], high[3];
+
+        ycck_to_rgb_neon(vget_low_u8(pixels.val[0]),  vget_low_u8(pixels.val[1]),
+                         vget_low_u8(pixels.val[2]),  vget_low_u8(pixels.val[3]),  low);
+        ycck_to_rgb_neon(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]),
+                         vget_high_u8(pixels.val[2]), vget_high_u8(pixels.val[3]), high);
+
+        store_pixels_neon(layout, vcombine_u8(low[0], high[0]), vcombine_u8(low[1], high[1]), vcombine_u8(low[2], high[2]),
+                          output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_ycck32_row_to_rgba_kind(input + (size_t)column * 4, output + (size_t)column * layout->pixel_size, width - column,
+                                    layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 16 pixels per iteration. */
+static void cmyk32_to_rgb_neon(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(input + (size_t)column * 4);
+        const uint8x8_t k_low  = vget_low_u8(pixels.val[3]);
+        const uint8x8_t k_high = vget_high_u8(pixels.val[3]);
+
+        const uint8x16_t r = vcombine_u8(apply_black_neon(vget_low_u8(pixels.val[0]), k_low), apply_black_neon(vget_high_u8(pixels.val[0]), k_high));
+        const uint8x16_t g = vcombine_u8(apply_black_neon(vget_low_u8(pixels.val[1]), k_low), apply_black_neon(vget_high_u8(pixels.val[1]), k_high));
+        const uint8x16_t b = vcombine_u8(apply_black_neon(vget_low_u8(pixels.val[2]), k_low), apply_black_neon(vget_high_u8(pixels.val[2]), k_high));
+
+        store_pixels_neon(layout, r, g, b, output + (size_t)column * layout->pixel_size);
+    }
+
+    convert_cmyk32_row_to_rgba_kind(input + (size_t)column * 4, output + (size_t)column * layout->pixel_size, width - column,
+                                    layout->pixel_size, layout->r, layout->g, layout->b, layout->a);
+}
+
+/* 16 pixels per iteration. Here the layout describes the input pixels. */
+static void rgb_to_ycbcr24_neon(const struct rgb_layout *layout, const uint8_t *input, uint8_t *output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        uint8x16_t r, g, b;
+
+        if (layout->pixel_size == 4) {
+            const uint8x16x4_t pixels = vld4q_u8(input + (size_t)column * 4);
+            r = pixels.val[layout->r];
+            g = pixels.val[layout->g];
+            b = pixels.val[layout->b];
+        } else {
+            const uint8x16x3_t pixels = vld3q_u8(input + (size_t)column * 3);
+            r = pixels.val[layout->r];
+            g = pixels.val[layout->g];
+            b = pixels.val[layout->b];
+        }
+
+        uint8x8_t low[3], high[3];
+        rgb_to_ycbcr_neon(vget_low_u8(r),  vget_low_u8(g),  vget_low_u8(b),  low);
+        rgb_to_ycbcr_neon(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), high);
+
+        store_pixels_neon(&YCBCR_LAYOUT, vcombine_u8(low[0], high[0]), vcombine_u8(low[1], high[1]), vcombine_u8(low[2], high[2]),
+                          output + (size_t)column * 3);
+    }
+
+    convert_rgba_kind_row_to_ycbcr24(input + (size_t)column * layout->pixel_size, output + (size_t)column * 3, width - column,
+                                     layout->pixel_size, layout->r, layout->g, layout->b);
+}
+
+#endif
+
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+
+/*
+ * Conversions with SIMD kernels. Every conversion must also have a scalar row kernel.
+ *
+ *   name,  input format,  output format,  input size,  output size,  sources of the output components
+ */
+#define SIMD_SHUFFLE32_CONVERSIONS(X)                                   \
+    X(rgba32_to_bgra32, BPP32_RGBA, BPP32_BGRA, 4, 4,  2,  1,  0,  3)   \
+    X(rgba32_to_argb32, BPP32_RGBA, BPP32_ARGB, 4, 4,  3,  0,  1,  2)   \
+    X(rgba32_to_abgr32, BPP32_RGBA, BPP32_ABGR, 4, 4,  3,  2,  1,  0)   \
+    X(bgra32_to_rgba32, BPP32_BGRA, BPP32_RGBA, 4, 4,  2,  1,  0,  3)   \
+    X(bgra32_to_argb32, BPP32_BGRA, BPP32_ARGB, 4, 4,  3,  2,  1,  0)   \
+    X(bgra32_to_abgr32, BPP32_BGRA, BPP32_ABGR, 4, 4,  3,  0,  1,  2)   \
+    X(argb32_to_rgba32, BPP32_ARGB, BPP32_RGBA, 4, 4,  1,  2,  3,  0)   \
+    X(argb32_to_bgra32, BPP32_ARGB, BPP32_BGRA, 4, 4,  3,  2,  1,  0)   \
+    X(abgr32_to_rgba32, BPP32_ABGR, BPP32_RGBA, 4, 4,  3,  2,  1,  0)   \
+    X(abgr32_to_bgra32, BPP32_ABGR, BPP32_BGRA, 4, 4,  1,  2,  3,  0)   \
+    X(rgbx32_to_rgba32, BPP32_RGBX, BPP32_RGBA, 4, 4,  0,  1,  2, -1)   \
+    X(rgbx32_to_bgra32, BPP32_RGBX, BPP32_BGRA, 4, 4,  2,  1,  0, -1)   \
+    X(bgrx32_to_rgba32, BPP32_BGRX, BPP32_RGBA, 4, 4,  2,  1,  0, -1)   \
+    X(bgrx32_to_bgra32, BPP32_BGRX, BPP32_BGRA, 4, 4,  0,  1,  2, -1)
+
+#define SIMD_RESIZE8_CONVERSIONS(X)                                     \
+    X(rgb24_to_rgba32,  BPP24_RGB,  BPP32_RGBA, 3, 4,  0,  1,  2, -1)   \
+    X(rgb24_to_bgra32,  BPP24_RGB,  BPP32_BGRA, 3, 4,  2,  1,  0, -1)   \
+    X(rgb24_to_rgbx32,  BPP24_RGB,  BPP32_RGBX, 3, 4,  0,  1,  2, -1)   \
+    X(bgr24_to_rgba32,  BPP24_BGR,  BPP32_RGBA, 3, 4,  2,  1,  0, -1)   \
+    X(bgr24_to_bgra32,  BPP24_BGR,  BPP32_BGRA, 3, 4,  0,  1,  2, -1)   \
+    X(bgr24_to_bgrx32,  BPP24_BGR,  BPP32_BGRX, 3, 4,  0,  1,  2, -1)   \
+    X(rgba32_to_rgb24,  BPP32_RGBA, BPP24_RGB,  4, 3,  0,  1,  2, -1)   \
+    X(rgba32_to_bgr24,  BPP32_RGBA, BPP24_BGR,  4, 3,  2,  1,  0, -1)   \
+    X(bgra32_to_rgb24,  BPP32_BGRA, BPP24_RGB,  4, 3,  2,  1,  0, -1)   \
+    X(bgra32_to_bgr24,  BPP32_BGRA, BPP24_BGR,  4, 3,  0,  1,  2, -1)
+
+/* Narrowing in the same component order. */
+#define SIMD_NARROW16_CONVERSIONS(X)                                    \
+    X(rgb48_to_rgb24,   BPP48_RGB,  BPP24_RGB,  3, 3,  0,  1,  2, -1)   \
+    X(bgr48_to_bgr24,   BPP48_BGR,  BPP24_BGR,  3, 3,  0,  1,  2, -1)   \
+    X(rgba64_to_rgba32, BPP64_RGBA, BPP32_RGBA, 4, 4,  0,  1,  2,  3)   \
+    X(bgra64_to_bgra32, BPP64_BGRA, BPP32_BGRA, 4, 4,  0,  1,  2,  3)
+
+/* Narrowing with reordering. */
+#define SIMD_NARROW16_SHUFFLE_CONVERSIONS(X)                            \
+    X(rgba64_to_bgra32, BPP64_RGBA, BPP32_BGRA, 4, 4,  2,  1,  0,  3)   \
+    X(bgra64_to_rgba32, BPP64_BGRA, BPP32_RGBA, 4, 4,  2,  1,  0,  3)
+
+/*
+ * Color space conversions. The layout describes the output pixels, or the input pixels for RGB -> YCbCr.
+ *
+ *   implementation,  name,  input format,  output format,  pixel size,  R, G, B, and A indexes
+ */
+#define SIMD_COLOR_CONVERSIONS(X)                                                       \
+    X(ycbcr24_to_rgb, ycbcr24_to_rgb24,  BPP24_YCBCR, BPP24_RGB,    3,  0,  1,  2, -1)  \
+    X(ycbcr24_to_rgb, ycbcr24_to_bgr24,  BPP24_YCBCR, BPP24_BGR,    3,  2,  1,  0, -1)  \
+    X(ycbcr24_to_rgb, ycbcr24_to_rgba32, BPP24_YCBCR, BPP32_RGBA,   4,  0,  1,  2,  3)  \
+    X(ycbcr24_to_rgb, ycbcr24_to_bgra32, BPP24_YCBCR, BPP32_BGRA,   4,  2,  1,  0,  3)  \
+    X(ycck32_to_rgb,  ycck32_to_rgb24,   BPP32_YCCK,  BPP24_RGB,    3,  0,  1,  2, -1)  \
+    X(ycck32_to_rgb,  ycck32_to_bgr24,   BPP32_YCCK,  BPP24_BGR,    3,  2,  1,  0, -1)  \
+    X(ycck32_to_rgb,  ycck32_to_rgba32,  BPP32_YCCK,  BPP32_RGBA,   4,  0,  1,  2,  3)  \
+    X(ycck32_to_rgb,  ycck32_to_bgra32,  BPP32_YCCK,  BPP32_BGRA,   4,  2,  1,  0,  3)  \
+    X(cmyk32_to_rgb,  cmyk32_to_rgb24,   BPP32_CMYK,  BPP24_RGB,    3,  0,  1,  2, -1)  \
+    X(cmyk32_to_rgb,  cmyk32_to_bgr24,   BPP32_CMYK,  BPP24_BGR,    3,  2,  1,  0, -1)  \
+    X(cmyk32_to_rgb,  cmyk32_to_rgba32,  BPP32_CMYK,  BPP32_RGBA,   4,  0,  1,  2,  3)  \
+    X(cmyk32_to_rgb,  cmyk32_to_bgra32,  BPP32_CMYK,  BPP32_BGRA,   4,  2,  1,  0,  3)  \
+    X(rgb_to_ycbcr24, rgb24_to_ycbcr24,  BPP24_RGB,   BPP24_YCBCR,  3,  0,  1,  2, -1)  \
+    X(rgb_to_ycbcr24, bgr24_to_ycbcr24,  BPP24_BGR,   BPP24_YCBCR,  3,  2,  1,  0, -1)  \
+    X(rgb_to_ycbcr24, rgba32_to_ycbcr24, BPP32_RGBA,  BPP24_YCBCR,  4,  0,  1,  2,  3)  \
+    X(rgb_to_ycbcr24, bgra32_to_ycbcr24, BPP32_BGRA,  BPP24_YCBCR,  4,  2,  1,  0,  3)
+
+#define DEFINE_KERNEL(impl, name, input_type, input_size, output_size, s0, s1, s2, s3)     \
+    static void name##_##impl(const void *input, void *output, unsigned width) {          \
+        static const struct shuffle_pattern PATTERN = {                                   \
+            input_size, output_size, { s0, s1, s2, s3 }                                   \
+        };                                                                                \
+        impl(&PATTERN, (const input_type *)input, (uint8_t *)output, width);              \
+    }
+
+#define DEFINE_COLOR_KERNEL(impl, name, pixel_size, r, g, b, a)                          \
+    static void name##_##impl(const void *input, void *output, unsigned width) {          \
+        static const struct rgb_layout LAYOUT = { pixel_size, r, g, b, a };               \
+        impl(&LAYOUT, (const uint8_t *)input, (uint8_t *)output, width);                  \
+    }
+
+#define TABLE_ENTRY(impl, level, name, input, output)                                      \
+    { SAIL_PIXEL_FORMAT_##input, SAIL_PIXEL_FORMAT_##output, level, name##_##impl },
+
+#ifdef SIMD_X86
+
+#define DEFINE_SSSE3_SHUFFLE8(name, input, output, input_size, output_size, s0, s1, s2, s3)  \
+    DEFINE_KERNEL(shuffle8_ssse3, name, uint8_t, input_size, output_size, s0, s1, s2, s3)
+#define DEFINE_AVX2_SHUFFLE8(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    DEFINE_KERNEL(shuffle8_avx2, name, uint8_t, input_size, output_size, s0, s1, s2, s3)
+#define DEFINE_SSE2_NARROW16(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    DEFINE_KERNEL(narrow16_sse2, name, uint16_t, input_size, output_size, s0, s1, s2, s3)
+#define DEFINE_SSSE3_NARROW16(name, input, output, input_size, output_size, s0, s1, s2, s3)  \
+    DEFINE_KERNEL(narrow16_ssse3, name, uint16_t, input_size, output_size, s0, s1, s2, s3)
+
+SIMD_SHUFFLE32_CONVERSIONS(DEFINE_SSSE3_SHUFFLE8)
+SIMD_SHUFFLE32_CONVERSIONS(DEFINE_AVX2_SHUFFLE8)
+SIMD_RESIZE8_CONVERSIONS(DEFINE_SSSE3_SHUFFLE8)
+SIMD_NARROW16_CONVERSIONS(DEFINE_SSE2_NARROW16)
+SIMD_NARROW16_SHUFFLE_CONVERSIONS(DEFINE_SSSE3_NARROW16)
+
+#define DEFINE_SSSE3_COLOR(impl, name, input, output, pixel_size, r, g, b, a)                \
+    DEFINE_COLOR_KERNEL(impl##_ssse3, name, pixel_size, r, g, b, a)
+
+SIMD_COLOR_CONVERSIONS(DEFINE_SSSE3_COLOR)
+
+#define SSSE3_SHUFFLE8_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    TABLE_ENTRY(shuffle8_ssse3, SIMD_LEVEL_SSSE3, name, input, output)
+#define AVX2_SHUFFLE8_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)    \
+    TABLE_ENTRY(shuffle8_avx2, SIMD_LEVEL_AVX2, name, input, output)
+#define SSE2_NARROW16_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)    \
+    TABLE_ENTRY(narrow16_sse2, SIMD_LEVEL_SSE2, name, input, output)
+#define SSSE3_NARROW16_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    TABLE_ENTRY(narrow16_ssse3, SIMD_LEVEL_SSSE3, name, input, output)
+#define SSSE3_COLOR_ENTRY(impl, name, input, output, pixel_size, r, g, b, a)                 \
+    TABLE_ENTRY(impl##_ssse3, SIMD_LEVEL_SSSE3, name, input, output)
+
+/* Faster kernels go first. */
+static const struct simd_row_kernel SIMD_ROW_KERNELS[] = {
+    SIMD_SHUFFLE32_CONVERSIONS(AVX2_SHUFFLE8_ENTRY)
+    SIMD_SHUFFLE32_CONVERSIONS(SSSE3_SHUFFLE8_ENTRY)
+    SIMD_RESIZE8_CONVERSIONS(SSSE3_SHUFFLE8_ENTRY)
+    SIMD_NARROW16_CONVERSIONS(SSE2_NARROW16_ENTRY)
+    SIMD_NARROW16_SHUFFLE_CONVERSIONS(SSSE3_NARROW16_ENTRY)
+    SIMD_COLOR_CONVERSIONS(SSSE3_COLOR_ENTRY)
+};
+
+#endif
+
+#ifdef SIMD_NEON
+
+static bool cpu_supports(enum SimdLevel level) {
+
+    /* NEON is mandatory on AArch64. */
+    return level == SIMD_LEVEL_NEON;
+}
+
+#define DEFINE_NEON_SHUFFLE8(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    DEFINE_KERNEL(shuffle8_neon, name, uint8_t, input_size, output_size, s0, s1, s2, s3)
+#define DEFINE_NEON_NARROW16(name, input, output, input_size, output_size, s0, s1, s2, s3)   \
+    DEFINE_KERNEL(narrow16_neon, name, uint16_t, input_size, output_size, s0, s1, s2, s3)
+
+SIMD_SHUFFLE32_CONVERSIONS(DEFINE_NEON_SHUFFLE8)
+SIMD_RESIZE8_CONVERSIONS(DEFINE_NEON_SHUFFLE8)
+SIMD_NARROW16_CONVERSIONS(DEFINE_NEON_NARROW16)
+SIMD_NARROW16_SHUFFLE_CONVERSIONS(DEFINE_NEON_NARROW16)
+
+#define DEFINE_NEON_COLOR(impl, name, input, output, pixel_size, r, g, b, a)                 \
+    DEFINE_COLOR_KERNEL(impl##_neon, name, pixel_size, r, g, b, a)
+
+SIMD_COLOR_CONVERSIONS(DEFINE_NEON_COLOR)
+
+#define NEON_SHUFFLE8_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)    \
+    TABLE_ENTRY(shuffle8_neon, SIMD_LEVEL_NEON, name, input, output)
+#define NEON_NARROW16_ENTRY(name, input, output, input_size, output_size, s0, s1, s2, s3)    \
+    TABLE_ENTRY(narrow16_neon, SIMD_LEVEL_NEON, name, input, output)
+#define NEON_COLOR_ENTRY(impl, name, input, output, pixel_size, r, g, b, a)                  \
+    TABLE_ENTRY(impl##_neon, SIMD_LEVEL_NEON, name, input, output)
+
+static const struct simd_row_kernel SIMD_ROW_KERNELS[] = {
+    SIMD_SHUFFLE32_CONVERSIONS(NEON_SHUFFLE8_ENTRY)
+    SIMD_RESIZE8_CONVERSIONS(NEON_SHUFFLE8_ENTRY)
+    SIMD_NARROW16_CONVERSIONS(NEON_NARROW16_ENTRY)
+    SIMD_NARROW16_SHUFFLE_CONVERSIONS(NEON_NARROW16_ENTRY)
+    SIMD_COLOR_CONVERSIONS(NEON_COLOR_ENTRY)
+};
+
+#endif
+
+static const size_t SIMD_ROW_KERNELS_LENGTH = sizeof(SIMD_ROW_KERNELS) / sizeof(SIMD_ROW_KERNELS[0]);
+
+#endif
+
+/*
+ * Public functions.
+ */
+
+const struct simd_row_kernel* simd_row_kernels(size_t *length) {
+
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+    *length = SIMD_ROW_KERNELS_LENGTH;
+    return SIMD_ROW_KERNELS;
+#else
+    *length = 0;
+    return NULL;
+#endif
+}
+
+bool simd_level_supported(enum SimdLevel level) {
+
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+    return cpu_supports(level);
+#else
+    (void)level;
+    return false;
+#endif
+}
+
+row_kernel_t find_simd_row_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+    for (size_t i = 0; i < SIMD_ROW_KERNELS_LENGTH; i++) {
+        const struct simd_row_kernel *entry = &SIMD_ROW_KERNELS[i];
+
+        if (entry->input_pixel_format == input_pixel_format &&
+                entry->output_pixel_format == output_pixel_format &&
+                cpu_supports(entry->level)) {
+            return entry->kernel;
+        }
+    }
+#else
+    (void)input_pixel_format;
+    (void)output_pixel_format;
+#endif
+
+    return NULL;
+}
@@ -0,0 +1,75 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SIMD_H
+#define SAIL_SIMD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef SAIL_BUILD
+    #include "export.h"
+    #include "pixel.h"
+#else
+    #include <sail-common/export.h>
+    #include <sail-common/pixel.h>
+#endif
+
+#include "row_kernels.h"
+
+/* Instruction sets SIMD row kernels are written for. */
+enum SimdLevel {
+    SIMD_LEVEL_SSE2,
+    SIMD_LEVEL_SSSE3,
+    SIMD_LEVEL_AVX2,
+    SIMD_LEVEL_NEON,
+};
+
+struct simd_row_kernel {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    enum SimdLevel level;
+    row_kernel_t kernel;
+};
+
+/*
+ * Returns all the SIMD row kernels compiled in, including the ones the current CPU doesn't support.
+ * Returns NULL and assigns 0 to 'length' when SIMD is disabled or unavailable for the target architecture.
+ * The kernels produce exactly the same output as the scalar row kernels.
+ */
+SAIL_HIDDEN const struct simd_row_kernel* simd_row_kernels(size_t *length);
+
+/*
+ * Returns true if the current CPU supports the specified instruction set.
+ */
+SAIL_HIDDEN bool simd_level_supported(enum SimdLevel level);
+
+/*
+ * Returns the fastest SIMD row kernel supported by the current CPU for the specified conversion
+ * or NULL if there is no one.
+ */
+SAIL_HIDDEN row_kernel_t find_simd_row_kernel(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
+
+#endif
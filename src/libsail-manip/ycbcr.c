@@ -80,9 +80,49 @@ void convert_ycbcr24_to_rgba32(uint8_t y, uint8_t cb, uint8_t cr, sail_rgba32_t
     rgba32->component4 = 255;
 }
 
+void convert_ycbcr24_row_to_rgba_kind(const uint8_t *input, uint8_t *output, unsigned width,
+                                      unsigned output_pixel_size, int r, int g, int b, int a) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t y  = *(input+0);
+        const uint8_t cb = *(input+1);
+        const uint8_t cr = *(input+2);
+
+        *(output+r) = (uint8_t)(SAIL_MAX(0, SAIL_MIN(255, y            + CR_R[cr])));
+        *(output+g) = (uint8_t)(SAIL_MAX(0, SAIL_MIN(255, y - CB_G[cb] - CR_G[cr])));
+        *(output+b) = (uint8_t)(SAIL_MAX(0, SAIL_MIN(255, y + CB_B[cb])));
+
+        if (a >= 0) {
+            *(output+a) = 255;
+        }
+
+        input  += 3;
+        output += output_pixel_size;
+    }
+}
+
 void convert_rgba32_to_ycbcr24(const sail_rgba32_t *rgba32, uint8_t *y, uint8_t *cb, uint8_t *cr) {
 
     *y =  (uint8_t)(  0 + R_Y[rgba32->component1]  + G_Y[rgba32->component2]  + B_Y[rgba32->component3]);
-    *cb = (uint8_t)(128 - R_CB[rgba32->component1] - G_CB[rgba32->component2] + B_CB[rgba32->component3]);
-    *cr = (uint8_t)(128 + R_CR[rgba32->component1] - G_CR[rgba32->component2] - B_CR[rgba32->component3]);
+    /* Pure blue and red give 256 otherwise. */
+    *cb = (uint8_t)(SAIL_MIN(255, 128 - R_CB[rgba32->component1] - G_CB[rgba32->component2] + B_CB[rgba32->component3]));
+    *cr = (uint8_t)(SAIL_MIN(255, 128 + R_CR[rgba32->component1] - G_CR[rgba32->component2] - B_CR[rgba32->component3]));
+}
+
+void convert_rgba_kind_row_to_ycbcr24(const uint8_t *input, uint8_t *output, unsigned width,
+                                      unsigned input_pixel_size, int r, int g, int b) {
+
+    for (unsigned column = 0; column < width; column++) {
+        /* Read the whole pixel first as the input and output may overlap. */
+        const uint8_t red   = *(input+r);
+        const uint8_t green = *(input+g);
+        const uint8_t blue  = *(input+b);
+
+        *(output+0) = (uint8_t)(                   R_Y[red]  + G_Y[green]  + B_Y[blue]);
+        *(output+1) = (uint8_t)(SAIL_MIN(255, 128 - R_CB[red] - G_CB[green] + B_CB[blue]));
+        *(output+2) = (uint8_t)(SAIL_MIN(255, 128 + R_CR[red] - G_CR[green] - B_CR[blue]));
+
+        input  += input_pixel_size;
+        output += 3;
+    }
 }
@@ -38,6 +38,20 @@
 
 SAIL_HIDDEN void convert_ycbcr24_to_rgba32(uint8_t y, uint8_t cb, uint8_t cr, sail_rgba32_t *rgba32);
 
+/*
+ * Converts a row of YCbCr pixels into an RGB-like row with the specified output pixel size
+ * and component indexes. If 'a' is non-negative, the alpha component is set to 255.
+ */
+SAIL_HIDDEN void convert_ycbcr24_row_to_rgba_kind(const uint8_t *input, uint8_t *output, unsigned width,
+                                                  unsigned output_pixel_size, int r, int g, int b, int a);
+
 SAIL_HIDDEN void convert_rgba32_to_ycbcr24(const sail_rgba32_t *rgba32, uint8_t *y, uint8_t *cb, uint8_t *cr);
 
+/*
+ * Converts a row of RGB-like pixels with the specified input pixel size and component indexes
+ * into a row of YCbCr pixels. The input alpha is ignored.
+ */
+SAIL_HIDDEN void convert_rgba_kind_row_to_ycbcr24(const uint8_t *input, uint8_t *output, unsigned width,
+                                                  unsigned input_pixel_size, int r, int g, int b);
+
 #endif
@@ -38,4 +38,11 @@
 
 SAIL_HIDDEN void convert_ycck32_to_rgba32(uint8_t y, uint8_t cb, uint8_t cr, uint8_t k, sail_rgba32_t *rgba32);
 
+/*
+ * Converts a row of YCCK pixels into an RGB-like row with the specified output pixel size
+ * and component indexes. If 'a' is non-negative, the alpha component is set to 255.
+ */
+SAIL_HIDDEN void convert_ycck32_row_to_rgba_kind(const uint8_t *input, uint8_t *output, unsigned width,
+                                                 unsigned output_pixel_size, int r, int g, int b, int a);
+
 #endif
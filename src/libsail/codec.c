@@ -64,13 +64,16 @@ static sail_status_t load_combined_codec(const struct sail_codec_info *codec_inf
 #ifdef SAIL_STATIC
     /* For example: [ "gif", "jpeg", "png" ]. */
     extern const char * const sail_enabled_codecs[];
+    extern const struct sail_codec_info * const sail_enabled_codecs_info[];
     extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
 #else
     SAIL_IMPORT extern const char * const sail_enabled_codecs[];
+    SAIL_IMPORT extern const struct sail_codec_info * const sail_enabled_codecs_info[];
     SAIL_IMPORT extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
 #endif
+    /* Combined codec info objects are static, so match them by address. */
     for (size_t i = 0; sail_enabled_codecs[i] != NULL; i++) {
-        if (strcmp(sail_enabled_codecs[i], codec_info->name) == 0) {
+        if (sail_enabled_codecs_info[i] == codec_info) {
             *codec->v8 = sail_enabled_codecs_layouts[i];
             return SAIL_OK;
         }
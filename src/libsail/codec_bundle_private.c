@@ -45,8 +45,33 @@ void destroy_codec_bundle(struct sail_codec_bundle *codec_bundle) {
         return;
     }
 
+#ifdef SAIL_COMBINE_CODECS
+    /* Combined codecs have no paths. Their codec info objects are static data of sail-codecs. */
+    if (codec_bundle->codec_info != NULL && codec_bundle->codec_info->path != NULL) {
+        destroy_codec_info(codec_bundle->codec_info);
+    }
+#else
     destroy_codec_info(codec_bundle->codec_info);
+#endif
     destroy_codec(codec_bundle->codec);
 
     sail_free(codec_bundle);
 }
+
+struct sail_codec* codec_bundle_loaded_codec(const struct sail_codec_bundle *codec_bundle) {
+
+#ifdef SAIL_THREAD_SAFE
+    return threading_load_pointer_acquire((void * const *)&codec_bundle->codec);
+#else
+    return codec_bundle->codec;
+#endif
+}
+
+void codec_bundle_publish_codec(struct sail_codec_bundle *codec_bundle, struct sail_codec *codec) {
+
+#ifdef SAIL_THREAD_SAFE
+    threading_store_pointer_release((void **)&codec_bundle->codec, codec);
+#else
+    codec_bundle->codec = codec;
+#endif
+}
@@ -34,6 +34,7 @@
     #include <sail-common/export.h>
 #endif
 
+struct sail_codec;
 struct sail_codec_bundle;
 
 /*
@@ -52,4 +53,15 @@ SAIL_HIDDEN sail_status_t alloc_codec_bundle(struct sail_codec_bundle **codec_bu
  */
 SAIL_HIDDEN void destroy_codec_bundle(struct sail_codec_bundle *codec_bundle);
 
+/*
+ * Returns the loaded codec or NULL. Safe to call without locking the context
+ * concurrently with codec_bundle_publish_codec().
+ */
+SAIL_HIDDEN struct sail_codec* codec_bundle_loaded_codec(const struct sail_codec_bundle *codec_bundle);
+
+/*
+ * Publishes the loaded codec to lock-free readers. Must be called with the context locked.
+ */
+SAIL_HIDDEN void codec_bundle_publish_codec(struct sail_codec_bundle *codec_bundle, struct sail_codec *codec);
+
 #endif
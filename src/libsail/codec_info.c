@@ -32,6 +32,28 @@
 #include "sail-common.h"
 #include "sail.h"
 
+/*
+ * Private functions.
+ */
+
+/* Formats \xFF\xDD as "ff dd". */
+static void magic_number_to_string(const unsigned char *buffer, size_t buffer_length, char *str) {
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < buffer_length; i++) {
+        *str++ = HEX_DIGITS[buffer[i] >> 4];
+        *str++ = HEX_DIGITS[buffer[i] & 0xF];
+        *str++ = ' ';
+    }
+
+    *(str - 1) = '\0';
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_codec_info_from_path(const char *path, const struct sail_codec_info **codec_info) {
 
     SAIL_CHECK_PTR(path);
@@ -122,81 +144,25 @@ sail_status_t sail_codec_info_by_magic_number_from_io(struct sail_io *io, const
     /* Seek back. */
     SAIL_TRY(io->seek(io->stream, (long)saved_offset, SEEK_SET));
 
-    /* \xFF\xDD => "FF DD" + string terminator. */
-    char hex_numbers[sizeof(buffer) * 3 + 1];
-
-    /* Debug print. */
-    {
-        char *hex_numbers_ptr = hex_numbers;
+    const struct sail_codec_info *codec_info_local = find_codec_info_by_magic_number(context->magic_number_table, buffer);
 
-        for (size_t i = 0; i < sizeof(buffer); i++, hex_numbers_ptr += 3) {
-#ifdef _MSC_VER
-            sprintf_s(hex_numbers_ptr, 4, "%02x ", buffer[i]);
-#else
-            sprintf(hex_numbers_ptr, "%02x ", buffer[i]);
-#endif
-        }
+    /* \xFF\xDD => "ff dd" + string terminator. Formatted only when it's going to be logged. */
+    char hex_numbers[sizeof(buffer) * 3 + 1] = "";
 
-        *(hex_numbers_ptr-1) = '\0';
+    if (sail_log_enabled(codec_info_local == NULL ? SAIL_LOG_LEVEL_ERROR : SAIL_LOG_LEVEL_DEBUG)) {
+        magic_number_to_string(buffer, sizeof(buffer), hex_numbers);
         SAIL_LOG_DEBUG("Read magic number: '%s'", hex_numbers);
     }
 
-    /* Find the codec info. */
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *magic_number_node = codec_bundle->codec_info->magic_number_node;
-
-        /*
-         * Split "ab cd" into bytes and compare individual bytes against the read magic number.
-         * Additionally, we support "??" pattern matching any byte. For example, "?? ?? 66 74"
-         * matches both "00 20 66 74" and "20 30 66 74".
-         */
-        while (magic_number_node != NULL) {
-            size_t buffer_index = 0;
-            const char *magic = magic_number_node->string;
-            char hex_byte[3];
-            int bytes_consumed = 0;
-            bool mismatch = false;
-
-            SAIL_LOG_TRACE("Check against %s magic '%s'", codec_bundle->codec_info->name, magic);
-
-#ifdef _MSC_VER
-            while (buffer_index < sizeof(buffer) && sscanf_s(magic, "%2s%n", hex_byte, (unsigned)sizeof(hex_byte), &bytes_consumed) == 1) {
-#else
-            while (buffer_index < sizeof(buffer) && sscanf(magic, "%2s%n", hex_byte, &bytes_consumed) == 1) {
-#endif
-                if (hex_byte[0] == '?') {
-                    SAIL_LOG_TRACE("Skipping ? character");
-                } else {
-                    unsigned byte = 0;
-
-#ifdef _MSC_VER
-                    if (sscanf_s(hex_byte, "%02x", &byte) != 1 || byte != buffer[buffer_index]) {
-#else
-                    if (sscanf(hex_byte, "%02x", &byte) != 1 || byte != buffer[buffer_index]) {
-#endif
-                        SAIL_LOG_TRACE("Character mismatch %02x != %02x", buffer[buffer_index], byte);
-                        mismatch = true;
-                        break;
-                    }
-                }
-
-                magic += bytes_consumed;
-                buffer_index++;
-            }
-
-            if (mismatch) {
-                magic_number_node = magic_number_node->next;
-            } else {
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            }
-        }
+    if (codec_info_local == NULL) {
+        SAIL_LOG_ERROR("Magic number '%s' is not supported by any codec", hex_numbers);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
     }
 
-    SAIL_LOG_ERROR("Magic number '%s' is not supported by any codec", hex_numbers);
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+    *codec_info = codec_info_local;
+    SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+
+    return SAIL_OK;
 }
 
 sail_status_t sail_codec_info_from_extension(const char *extension, const struct sail_codec_info **codec_info) {
@@ -209,35 +175,17 @@ sail_status_t sail_codec_info_from_extension(const char *extension, const struct
     struct sail_context *context;
     SAIL_TRY(fetch_global_context_guarded(&context));
 
-    char *extension_copy;
-    SAIL_TRY(sail_strdup(extension, &extension_copy));
-
-    /* Will compare in lower case. */
-    sail_to_lower(extension_copy);
+    const struct sail_codec_info *codec_info_local = find_codec_info_in_index(context->extension_index, extension);
 
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *extension_node = codec_bundle->codec_info->extension_node;
-
-        while (extension_node != NULL) {
-            SAIL_LOG_TRACE("Check against %s extension '%s'", codec_bundle->codec_info->name, extension_node->string);
-
-            if (strcmp(extension_node->string, extension_copy) == 0) {
-                sail_free(extension_copy);
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            } else {
-                SAIL_LOG_TRACE("Extension mismatch '%s' != '%s'", extension_copy, extension_node->string);
-            }
-
-            extension_node = extension_node->next;
-        }
+    if (codec_info_local == NULL) {
+        SAIL_LOG_ERROR("Extension %s is not supported by any codec", extension);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
     }
 
-    sail_free(extension_copy);
-    SAIL_LOG_ERROR("Extension %s is not supported by any codec", extension);
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+    *codec_info = codec_info_local;
+    SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+
+    return SAIL_OK;
 }
 
 sail_status_t sail_codec_info_from_mime_type(const char *mime_type, const struct sail_codec_info **codec_info) {
@@ -250,35 +198,15 @@ sail_status_t sail_codec_info_from_mime_type(const char *mime_type, const struct
     struct sail_context *context;
     SAIL_TRY(fetch_global_context_guarded(&context));
 
-    char *mime_type_copy;
-    SAIL_TRY(sail_strdup(mime_type, &mime_type_copy));
-
-    /* Will compare in lower case. */
-    sail_to_lower(mime_type_copy);
+    const struct sail_codec_info *codec_info_local = find_codec_info_in_index(context->mime_type_index, mime_type);
 
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *mime_type_node = codec_bundle->codec_info->mime_type_node;
-
-        while (mime_type_node != NULL) {
-            SAIL_LOG_TRACE("Check against %s MIME type '%s'", codec_bundle->codec_info->name, mime_type_node->string);
-
-            if (strcmp(mime_type_node->string, mime_type_copy) == 0) {
-                sail_free(mime_type_copy);
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            } else {
-                SAIL_LOG_TRACE("MIME type mismatch '%s' != '%s'", mime_type_copy, mime_type_node->string);
-            }
-
-            mime_type_node = mime_type_node->next;
-        }
-
-        codec_bundle_node = codec_bundle_node->next;
+    if (codec_info_local == NULL) {
+        SAIL_LOG_ERROR("MIME type %s is not supported by any codec", mime_type);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
     }
 
-    sail_free(mime_type_copy);
-    SAIL_LOG_ERROR("MIME type %s is not supported by any codec", mime_type);
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+    *codec_info = codec_info_local;
+    SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+
+    return SAIL_OK;
 }
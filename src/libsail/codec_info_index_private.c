@@ -0,0 +1,162 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sail-common.h"
+#include "sail.h"
+
+/*
+ * Private functions.
+ */
+
+struct codec_info_index_entry {
+    uint64_t hash;
+    /* NULL for empty slots. */
+    const char *key;
+    const struct sail_codec_info *codec_info;
+};
+
+/* Open addressing with linear probing. */
+struct sail_codec_info_index {
+    struct codec_info_index_entry *entries;
+    /* Power of two. */
+    size_t capacity;
+};
+
+static inline char ascii_to_lower(char c) {
+
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+/* Same as sail_string_hash() of the lower-cased string. */
+static uint64_t hash_ignore_case(const char *str) {
+
+    uint64_t hash = 5381;
+
+    for (; *str != '\0'; str++) {
+        hash = ((hash << 5) + hash) + (unsigned char)ascii_to_lower(*str);
+    }
+
+    return hash;
+}
+
+static bool equal_ignore_case(const char *str1, const char *str2) {
+
+    for (; *str1 != '\0' && *str2 != '\0'; str1++, str2++) {
+        if (ascii_to_lower(*str1) != ascii_to_lower(*str2)) {
+            return false;
+        }
+    }
+
+    return *str1 == *str2;
+}
+
+static const struct codec_info_index_entry* find_entry(const struct sail_codec_info_index *codec_info_index, const char *key, uint64_t hash) {
+
+    const size_t mask = codec_info_index->capacity - 1;
+
+    for (size_t i = (size_t)hash & mask; ; i = (i + 1) & mask) {
+        const struct codec_info_index_entry *entry = &codec_info_index->entries[i];
+
+        if (entry->key == NULL || (entry->hash == hash && equal_ignore_case(entry->key, key))) {
+            return entry;
+        }
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t alloc_codec_info_index(const struct sail_codec_bundle_node *codec_bundle_node,
+                                     codec_info_index_keys_t keys,
+                                     struct sail_codec_info_index **codec_info_index) {
+
+    SAIL_CHECK_PTR(keys);
+    SAIL_CHECK_PTR(codec_info_index);
+
+    size_t keys_length = 0;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        for (const struct sail_string_node *key_node = keys(node->codec_bundle->codec_info); key_node != NULL; key_node = key_node->next) {
+            keys_length++;
+        }
+    }
+
+    /* Keep the load factor at 0.5 or lower so probe sequences stay short. */
+    size_t capacity = 8;
+
+    while (capacity < keys_length * 2) {
+        capacity *= 2;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_codec_info_index), &ptr));
+    struct sail_codec_info_index *codec_info_index_local = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(capacity, sizeof(struct codec_info_index_entry), &ptr),
+                        /* cleanup */ sail_free(codec_info_index_local));
+    codec_info_index_local->entries  = ptr;
+    codec_info_index_local->capacity = capacity;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        for (const struct sail_string_node *key_node = keys(codec_info); key_node != NULL; key_node = key_node->next) {
+            const uint64_t hash = hash_ignore_case(key_node->string);
+            struct codec_info_index_entry *entry = (struct codec_info_index_entry *)find_entry(codec_info_index_local, key_node->string, hash);
+
+            /* Codecs with higher priorities win. */
+            if (entry->key == NULL) {
+                entry->hash       = hash;
+                entry->key        = key_node->string;
+                entry->codec_info = codec_info;
+            }
+        }
+    }
+
+    *codec_info_index = codec_info_index_local;
+
+    return SAIL_OK;
+}
+
+void destroy_codec_info_index(struct sail_codec_info_index *codec_info_index) {
+
+    if (codec_info_index == NULL) {
+        return;
+    }
+
+    sail_free(codec_info_index->entries);
+    sail_free(codec_info_index);
+}
+
+const struct sail_codec_info* find_codec_info_in_index(const struct sail_codec_info_index *codec_info_index,
+                                                       const char *key) {
+
+    return find_entry(codec_info_index, key, hash_ignore_case(key))->codec_info;
+}
@@ -0,0 +1,69 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CODEC_INFO_INDEX_PRIVATE_H
+#define SAIL_CODEC_INFO_INDEX_PRIVATE_H
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+struct sail_codec_bundle_node;
+struct sail_codec_info;
+struct sail_string_node;
+
+/*
+ * Immutable hash index mapping strings like extensions or MIME types to codec info objects.
+ * Lookups are case insensitive and don't allocate memory.
+ */
+struct sail_codec_info_index;
+
+/* Returns the keys of the specified codec info to index. For example, its extensions. */
+typedef const struct sail_string_node* (*codec_info_index_keys_t)(const struct sail_codec_info *codec_info);
+
+/*
+ * Builds a new index from the keys of the specified codecs. The codecs must be already sorted
+ * by priority. When several codecs share a key, the first one wins. The index references the keys,
+ * so it must be destroyed before the codecs.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_codec_info_index(const struct sail_codec_bundle_node *codec_bundle_node,
+                                                 codec_info_index_keys_t keys,
+                                                 struct sail_codec_info_index **codec_info_index);
+
+SAIL_HIDDEN void destroy_codec_info_index(struct sail_codec_info_index *codec_info_index);
+
+/*
+ * Returns the codec info indexed by the specified key, or NULL.
+ */
+SAIL_HIDDEN const struct sail_codec_info* find_codec_info_in_index(const struct sail_codec_info_index *codec_info_index,
+                                                                   const char *key);
+
+#endif
@@ -144,8 +144,8 @@ static sail_status_t inih_handler_sail_error(void *data, const char *section, co
             SAIL_TRY(sail_split_into_string_node_chain(value, &codec_info->magic_number_node));
 
             for (struct sail_string_node *node = codec_info->magic_number_node; node != NULL; node = node->next) {
-                if (strlen(node->string) > SAIL_MAGIC_BUFFER_SIZE * 3 - 1) {
-                    SAIL_LOG_ERROR("Magic number '%s' is too long. Magic numbers for the '%s' codec are disabled",
+                if (!is_valid_magic_number(node->string)) {
+                    SAIL_LOG_ERROR("Magic number '%s' is invalid or too long. Magic numbers for the '%s' codec are disabled",
                                     node->string, codec_info->name);
                     sail_destroy_string_node_chain(codec_info->magic_number_node);
                     codec_info->magic_number_node = NULL;
@@ -419,18 +419,6 @@ void destroy_codec_info(struct sail_codec_info *codec_info) {
     sail_free(codec_info);
 }
 
-sail_status_t codec_read_info_from_file(const char *path, struct sail_codec_info **codec_info) {
-
-    SAIL_CHECK_PTR(path);
-    SAIL_CHECK_PTR(codec_info);
-
-    SAIL_LOG_DEBUG("Loading codec info '%s'", path);
-
-    SAIL_TRY(codec_read_info_from_input(path, ini_parse, codec_info));
-
-    return SAIL_OK;
-}
-
 sail_status_t codec_read_info_from_string(const char *str, struct sail_codec_info **codec_info) {
 
     SAIL_CHECK_PTR(str);
@@ -42,14 +42,6 @@ struct sail_codec_info;
 
 SAIL_HIDDEN void destroy_codec_info(struct sail_codec_info *codec_info);
 
-/*
- * Reads SAIL codec info from the specified file and stores the parsed information into the specified
- * codec info object.
- *
- * Returns SAIL_OK on success.
- */
-SAIL_HIDDEN sail_status_t codec_read_info_from_file(const char *path, struct sail_codec_info **codec_info);
-
 /*
  * Reads SAIL codec info from the specified string and stores the parsed information into the specified
  * codec info object.
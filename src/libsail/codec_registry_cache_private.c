@@ -0,0 +1,577 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+
+#ifdef SAIL_WIN32
+    #include <process.h> /* _getpid() */
+    #include <windows.h> /* MoveFileEx() */
+#else
+    #include <unistd.h> /* getpid() */
+#endif
+
+#include "sail.h"
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Cache file layout. Numbers are stored in the native byte order, strings are stored as their u32 length
+ * followed by the characters and a string terminator, so they're used directly from the cache:
+ *
+ *   "SAILREG\0", u32 format version, u32 byte order marker, string SAIL version
+ *   u32 number of codecs paths, then for every path: string path, i64 modification time
+ *   u32 number of codec info files, then for every file: string path, i64 modification time, u64 size, string contents
+ */
+static const char CACHE_MAGIC[8] = "SAILREG";
+
+static const uint32_t CACHE_FORMAT_VERSION = 2;
+
+static const uint32_t CACHE_BYTE_ORDER_MARKER = 0x01020304;
+
+struct sail_codec_registry_cache_writer {
+
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+
+    /* Offset of the number of codec info files to update it on every added file. */
+    size_t codecs_offset;
+    uint32_t codecs;
+
+    /* A codecs path or a codec info file was modified too recently to trust its modification time. */
+    bool racy;
+};
+
+struct cache_reader {
+
+    const unsigned char *data;
+    size_t length;
+    size_t pos;
+};
+
+/* Retrieves the modification time in seconds and the size of the specified path. Returns false on error. */
+static bool path_attributes(const char *path, int64_t *modification_time, uint64_t *size) {
+
+#ifdef _MSC_VER
+    struct _stat64 attrs;
+
+    if (_stat64(path, &attrs) != 0) {
+        return false;
+    }
+#else
+    struct stat attrs;
+
+    if (stat(path, &attrs) != 0) {
+        return false;
+    }
+#endif
+
+    *modification_time = (int64_t)attrs.st_mtime;
+    *size              = (uint64_t)attrs.st_size;
+
+    return true;
+}
+
+/* Returns the modification time of the specified path in seconds or -1 on error. */
+static int64_t path_modification_time(const char *path) {
+
+    int64_t modification_time;
+    uint64_t size;
+
+    return path_attributes(path, &modification_time, &size) ? modification_time : -1;
+}
+
+static sail_status_t writer_reserve(struct sail_codec_registry_cache_writer *writer, size_t size) {
+
+    if (writer->length + size <= writer->capacity) {
+        return SAIL_OK;
+    }
+
+    size_t capacity = (writer->capacity == 0) ? 4096 : writer->capacity;
+
+    while (capacity < writer->length + size) {
+        capacity *= 2;
+    }
+
+    void *ptr = writer->data;
+    SAIL_TRY(sail_realloc(capacity, &ptr));
+
+    writer->data     = ptr;
+    writer->capacity = capacity;
+
+    return SAIL_OK;
+}
+
+static sail_status_t writer_put(struct sail_codec_registry_cache_writer *writer, const void *data, size_t size) {
+
+    SAIL_TRY(writer_reserve(writer, size));
+
+    memcpy(writer->data + writer->length, data, size);
+    writer->length += size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t writer_put_u32(struct sail_codec_registry_cache_writer *writer, uint32_t value) {
+
+    SAIL_TRY(writer_put(writer, &value, sizeof(value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t writer_put_string(struct sail_codec_registry_cache_writer *writer, const char *str) {
+
+    const size_t length = strlen(str);
+
+    if (length > UINT32_MAX - 1) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    SAIL_TRY(writer_put_u32(writer, (uint32_t)length));
+    SAIL_TRY(writer_put(writer, str, length + 1));
+
+    return SAIL_OK;
+}
+
+static bool reader_get(struct cache_reader *reader, void *data, size_t size) {
+
+    if (reader->length - reader->pos < size) {
+        return false;
+    }
+
+    memcpy(data, reader->data + reader->pos, size);
+    reader->pos += size;
+
+    return true;
+}
+
+static bool reader_get_u32(struct cache_reader *reader, uint32_t *value) {
+
+    return reader_get(reader, value, sizeof(*value));
+}
+
+/* The returned string points into the cache data. */
+static bool reader_get_string(struct cache_reader *reader, const char **str) {
+
+    uint32_t length;
+
+    if (!reader_get_u32(reader, &length) || reader->length - reader->pos < (size_t)length + 1) {
+        return false;
+    }
+
+    *str = (const char *)(reader->data + reader->pos);
+
+    if ((*str)[length] != '\0' || memchr(*str, '\0', length) != NULL) {
+        return false;
+    }
+
+    reader->pos += (size_t)length + 1;
+
+    return true;
+}
+
+/* Returns true if the cache was built for the same SAIL version and the same unchanged codecs paths. */
+static bool read_and_verify_header(struct cache_reader *reader, const struct sail_string_node *codecs_paths) {
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint32_t format_version;
+    uint32_t byte_order_marker;
+    const char *sail_version;
+
+    if (!reader_get(reader, magic, sizeof(magic)) || memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+            !reader_get_u32(reader, &format_version) || format_version != CACHE_FORMAT_VERSION ||
+            !reader_get_u32(reader, &byte_order_marker) || byte_order_marker != CACHE_BYTE_ORDER_MARKER ||
+            !reader_get_string(reader, &sail_version) || strcmp(sail_version, SAIL_VERSION_STRING) != 0) {
+        SAIL_LOG_DEBUG("Codec registry cache has unsupported format");
+        return false;
+    }
+
+    uint32_t paths;
+
+    if (!reader_get_u32(reader, &paths)) {
+        return false;
+    }
+
+    const struct sail_string_node *codecs_path = codecs_paths;
+
+    for (uint32_t i = 0; i < paths; i++, codecs_path = codecs_path->next) {
+        const char *path;
+        int64_t modification_time;
+
+        if (!reader_get_string(reader, &path) || !reader_get(reader, &modification_time, sizeof(modification_time))) {
+            return false;
+        }
+
+        if (codecs_path == NULL || strcmp(codecs_path->string, path) != 0) {
+            SAIL_LOG_DEBUG("Codec registry cache was built for other codecs paths");
+            return false;
+        }
+
+        if (path_modification_time(path) != modification_time) {
+            SAIL_LOG_DEBUG("Codec registry cache is stale as '%s' was modified", path);
+            return false;
+        }
+    }
+
+    if (codecs_path != NULL) {
+        SAIL_LOG_DEBUG("Codec registry cache was built for other codecs paths");
+        return false;
+    }
+
+    return true;
+}
+
+static bool is_path_separator(char c) {
+
+#ifdef SAIL_WIN32
+    return c == '\\' || c == '/' || c == ':';
+#else
+    return c == '/';
+#endif
+}
+
+/*
+ * Returns true if the codec info path is a file directly inside one of the codecs paths.
+ * The codec library path is derived from it, so paths from a tampered cache must never
+ * point to other locations.
+ */
+static bool is_codec_info_path_in_codecs_paths(const char *codec_info_path, const struct sail_string_node *codecs_paths) {
+
+    for (const struct sail_string_node *codecs_path = codecs_paths; codecs_path != NULL; codecs_path = codecs_path->next) {
+        const size_t codecs_path_length = strlen(codecs_path->string);
+
+        if (strncmp(codec_info_path, codecs_path->string, codecs_path_length) != 0 ||
+                !is_path_separator(codec_info_path[codecs_path_length])) {
+            continue;
+        }
+
+        const char *name = codec_info_path + codecs_path_length + 1;
+        bool has_separator = false;
+
+        for (const char *c = name; *c != '\0'; c++) {
+            if (is_path_separator(*c)) {
+                has_separator = true;
+                break;
+            }
+        }
+
+        if (!has_separator && strstr(name, ".codec.info") != NULL) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Public functions.
+ */
+
+const char* codec_registry_cache_path(void) {
+
+    const char *env;
+
+#ifdef _MSC_VER
+    /* The caller doesn't own the string, so keep the copy between calls. */
+    static char *env_copy = NULL;
+    free(env_copy);
+    env_copy = NULL;
+    _dupenv_s(&env_copy, NULL, "SAIL_CODECS_CACHE");
+    env = env_copy;
+#else
+    env = getenv("SAIL_CODECS_CACHE");
+#endif
+
+    return (env == NULL || *env == '\0') ? NULL : env;
+}
+
+sail_status_t read_codec_registry_cache(const char *cache_path,
+                                        const struct sail_string_node *codecs_paths,
+                                        codec_registry_cache_callback_t callback,
+                                        void *user_data) {
+
+    SAIL_CHECK_PTR(cache_path);
+    SAIL_CHECK_PTR(callback);
+
+    if (!sail_is_file(cache_path)) {
+        SAIL_LOG_DEBUG("Codec registry cache '%s' doesn't exist", cache_path);
+        return SAIL_ERROR_OPEN_FILE;
+    }
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY(sail_file_contents_to_data(cache_path, &data, &data_size));
+
+    struct cache_reader reader = { data, data_size, 0 };
+    uint32_t codecs;
+
+    /* Stale caches are expected, so don't log errors. */
+    if (!read_and_verify_header(&reader, codecs_paths) || !reader_get_u32(&reader, &codecs)) {
+        sail_free(data);
+        return SAIL_ERROR_PARSE_FILE;
+    }
+
+    /* Validate all the records before using them. */
+    const size_t codecs_pos = reader.pos;
+
+    for (uint32_t i = 0; i < codecs; i++) {
+        const char *codec_info_path;
+        int64_t modification_time;
+        uint64_t size;
+        const char *codec_info;
+
+        if (!reader_get_string(&reader, &codec_info_path) ||
+                !reader_get(&reader, &modification_time, sizeof(modification_time)) ||
+                !reader_get(&reader, &size, sizeof(size)) ||
+                !reader_get_string(&reader, &codec_info)) {
+            SAIL_LOG_ERROR("Codec registry cache '%s' is corrupted", cache_path);
+            sail_free(data);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+        }
+
+        if (!is_codec_info_path_in_codecs_paths(codec_info_path, codecs_paths)) {
+            SAIL_LOG_ERROR("Codec registry cache '%s' references '%s' outside of the codecs paths", cache_path, codec_info_path);
+            sail_free(data);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+        }
+
+        /* Files overwritten in place don't change the modification time of their directory. */
+        int64_t actual_modification_time;
+        uint64_t actual_size;
+
+        if (!path_attributes(codec_info_path, &actual_modification_time, &actual_size) ||
+                actual_modification_time != modification_time || actual_size != size) {
+            SAIL_LOG_DEBUG("Codec registry cache is stale as '%s' was modified", codec_info_path);
+            sail_free(data);
+            return SAIL_ERROR_PARSE_FILE;
+        }
+    }
+
+    reader.pos = codecs_pos;
+
+    for (uint32_t i = 0; i < codecs; i++) {
+        const char *codec_info_path;
+        int64_t modification_time;
+        uint64_t size;
+        const char *codec_info;
+
+        if (!reader_get_string(&reader, &codec_info_path) ||
+                !reader_get(&reader, &modification_time, sizeof(modification_time)) ||
+                !reader_get(&reader, &size, sizeof(size)) ||
+                !reader_get_string(&reader, &codec_info)) {
+            sail_free(data);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+        }
+
+        (void)callback(codec_info_path, codec_info, user_data);
+    }
+
+    sail_free(data);
+
+    SAIL_LOG_DEBUG("Loaded %u codec info files from the codec registry cache '%s'", (unsigned)codecs, cache_path);
+
+    return SAIL_OK;
+}
+
+sail_status_t alloc_codec_registry_cache_writer(const struct sail_string_node *codecs_paths,
+                                                struct sail_codec_registry_cache_writer **writer) {
+
+    SAIL_CHECK_PTR(writer);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_codec_registry_cache_writer), &ptr));
+    struct sail_codec_registry_cache_writer *writer_local = ptr;
+
+    writer_local->data     = NULL;
+    writer_local->length   = 0;
+    writer_local->capacity = 0;
+    writer_local->codecs   = 0;
+    writer_local->racy     = false;
+
+    uint32_t paths = 0;
+
+    for (const struct sail_string_node *codecs_path = codecs_paths; codecs_path != NULL; codecs_path = codecs_path->next) {
+        paths++;
+    }
+
+    SAIL_TRY_OR_CLEANUP(writer_put(writer_local, CACHE_MAGIC, sizeof(CACHE_MAGIC)),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+    SAIL_TRY_OR_CLEANUP(writer_put_u32(writer_local, CACHE_FORMAT_VERSION),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+    SAIL_TRY_OR_CLEANUP(writer_put_u32(writer_local, CACHE_BYTE_ORDER_MARKER),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+    SAIL_TRY_OR_CLEANUP(writer_put_string(writer_local, SAIL_VERSION_STRING),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+    SAIL_TRY_OR_CLEANUP(writer_put_u32(writer_local, paths),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+
+    /*
+     * Modification times have a granularity of one second. A path modified during the current second
+     * could be modified again without changing its modification time, so don't trust it.
+     */
+    const int64_t now = (int64_t)time(NULL);
+
+    for (const struct sail_string_node *codecs_path = codecs_paths; codecs_path != NULL; codecs_path = codecs_path->next) {
+        const int64_t modification_time = path_modification_time(codecs_path->string);
+
+        if (modification_time >= now) {
+            writer_local->racy = true;
+        }
+
+        SAIL_TRY_OR_CLEANUP(writer_put_string(writer_local, codecs_path->string),
+                            /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+        SAIL_TRY_OR_CLEANUP(writer_put(writer_local, &modification_time, sizeof(modification_time)),
+                            /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+    }
+
+    writer_local->codecs_offset = writer_local->length;
+
+    SAIL_TRY_OR_CLEANUP(writer_put_u32(writer_local, 0),
+                        /* cleanup */ destroy_codec_registry_cache_writer(writer_local));
+
+    *writer = writer_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t codec_registry_cache_writer_add(struct sail_codec_registry_cache_writer *writer,
+                                              const char *codec_info_path,
+                                              const char *codec_info) {
+
+    SAIL_CHECK_PTR(writer);
+    SAIL_CHECK_PTR(codec_info_path);
+    SAIL_CHECK_PTR(codec_info);
+
+    int64_t modification_time;
+    uint64_t size;
+
+    if (!path_attributes(codec_info_path, &modification_time, &size)) {
+        SAIL_LOG_ERROR("Failed to get the attributes of '%s'", codec_info_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    /* See alloc_codec_registry_cache_writer(). */
+    if (modification_time >= (int64_t)time(NULL)) {
+        writer->racy = true;
+    }
+
+    SAIL_TRY(writer_put_string(writer, codec_info_path));
+    SAIL_TRY(writer_put(writer, &modification_time, sizeof(modification_time)));
+    SAIL_TRY(writer_put(writer, &size, sizeof(size)));
+    SAIL_TRY(writer_put_string(writer, codec_info));
+
+    writer->codecs++;
+    memcpy(writer->data + writer->codecs_offset, &writer->codecs, sizeof(writer->codecs));
+
+    return SAIL_OK;
+}
+
+sail_status_t codec_registry_cache_writer_save(const struct sail_codec_registry_cache_writer *writer,
+                                               const char *cache_path) {
+
+    SAIL_CHECK_PTR(writer);
+    SAIL_CHECK_PTR(cache_path);
+
+    if (writer->racy) {
+        SAIL_LOG_DEBUG("Codecs paths were modified too recently. Not saving the codec registry cache");
+        return SAIL_OK;
+    }
+
+    /* Write into a temporary file first, so concurrent processes never read partial caches. */
+    char pid[24];
+#ifdef SAIL_WIN32
+    snprintf(pid, sizeof(pid), "%d", _getpid());
+#else
+    snprintf(pid, sizeof(pid), "%ld", (long)getpid());
+#endif
+
+    char *temp_path;
+    SAIL_TRY(sail_concat(&temp_path, 4, cache_path, ".", pid, ".tmp"));
+
+#ifdef _MSC_VER
+    FILE *f;
+    if (fopen_s(&f, temp_path, "wb") != 0) {
+        f = NULL;
+    }
+#else
+    FILE *f = fopen(temp_path, "wb");
+#endif
+
+    if (f == NULL) {
+        SAIL_LOG_ERROR("Failed to create the codec registry cache '%s'", temp_path);
+        sail_free(temp_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    const bool written = fwrite(writer->data, 1, writer->length, f) == writer->length;
+
+    if (fclose(f) != 0 || !written) {
+        SAIL_LOG_ERROR("Failed to write the codec registry cache '%s'", temp_path);
+        remove(temp_path);
+        sail_free(temp_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+#ifdef SAIL_WIN32
+    const bool renamed = MoveFileExA(temp_path, cache_path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool renamed = rename(temp_path, cache_path) == 0;
+#endif
+
+    if (!renamed) {
+        SAIL_LOG_ERROR("Failed to replace the codec registry cache '%s'", cache_path);
+        remove(temp_path);
+        sail_free(temp_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+    sail_free(temp_path);
+
+    SAIL_LOG_DEBUG("Saved %u codec info files into the codec registry cache '%s'", (unsigned)writer->codecs, cache_path);
+
+    return SAIL_OK;
+}
+
+void destroy_codec_registry_cache_writer(struct sail_codec_registry_cache_writer *writer) {
+
+    if (writer == NULL) {
+        return;
+    }
+
+    sail_free(writer->data);
+    sail_free(writer);
+}
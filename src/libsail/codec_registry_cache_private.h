@@ -0,0 +1,96 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CODEC_REGISTRY_CACHE_PRIVATE_H
+#define SAIL_CODEC_REGISTRY_CACHE_PRIVATE_H
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+struct sail_string_node;
+
+/*
+ * Codec registry cache is an optional binary file holding the contents of all the codec info files
+ * found in the codecs paths. It's enabled by setting the SAIL_CODECS_CACHE environment variable
+ * to the cache file path. The cache is considered stale when the list of the codecs paths
+ * or the modification time of any of them changes, or when the modification time or the size
+ * of any cached codec info file changes.
+ */
+struct sail_codec_registry_cache_writer;
+
+/* Called for every cached codec info file. Returns SAIL_OK on success. */
+typedef sail_status_t (*codec_registry_cache_callback_t)(const char *codec_info_path, const char *codec_info, void *user_data);
+
+/*
+ * Returns the cache file path from the SAIL_CODECS_CACHE environment variable
+ * or NULL if caching is disabled.
+ */
+SAIL_HIDDEN const char* codec_registry_cache_path(void);
+
+/*
+ * Reads the specified cache and calls the callback for every cached codec info file if the cache
+ * is valid and fresh for the specified codecs paths. Errors from the callback are ignored.
+ *
+ * Returns SAIL_OK on success. Any other status means that the caller must enumerate the codecs paths.
+ */
+SAIL_HIDDEN sail_status_t read_codec_registry_cache(const char *cache_path,
+                                                    const struct sail_string_node *codecs_paths,
+                                                    codec_registry_cache_callback_t callback,
+                                                    void *user_data);
+
+/*
+ * Allocates a new writer to collect the codec info files found in the specified codecs paths.
+ * The modification times of the codecs paths are captured here, before they are enumerated.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_codec_registry_cache_writer(const struct sail_string_node *codecs_paths,
+                                                            struct sail_codec_registry_cache_writer **writer);
+
+/*
+ * Adds the codec info file to the writer. Its modification time and size are captured here.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t codec_registry_cache_writer_add(struct sail_codec_registry_cache_writer *writer,
+                                                          const char *codec_info_path,
+                                                          const char *codec_info);
+
+/*
+ * Atomically replaces the specified cache file with the collected codec info files.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t codec_registry_cache_writer_save(const struct sail_codec_registry_cache_writer *writer,
+                                                           const char *cache_path);
+
+SAIL_HIDDEN void destroy_codec_registry_cache_writer(struct sail_codec_registry_cache_writer *writer);
+
+#endif
@@ -46,6 +46,30 @@
 
 static struct sail_context *global_context = NULL;
 
+/*
+ * The global context after a successful initialization. It's immutable except lazily loaded codecs,
+ * so readers load it without locking the context.
+ */
+static struct sail_context *published_global_context = NULL;
+
+static struct sail_context* load_published_global_context(void) {
+
+#ifdef SAIL_THREAD_SAFE
+    return threading_load_pointer_acquire((void **)&published_global_context);
+#else
+    return published_global_context;
+#endif
+}
+
+static void publish_global_context(struct sail_context *context) {
+
+#ifdef SAIL_THREAD_SAFE
+    threading_store_pointer_release((void **)&published_global_context, context);
+#else
+    published_global_context = context;
+#endif
+}
+
 #ifdef SAIL_THREAD_SAFE
 static sail_mutex_t global_context_guard_mutex;
 
@@ -193,8 +217,11 @@ static sail_status_t alloc_context(struct sail_context **context) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_context), &ptr));
     *context = ptr;
 
-    (*context)->initialized     = false;
-    (*context)->codec_bundle_node = NULL;
+    (*context)->initialized        = false;
+    (*context)->codec_bundle_node  = NULL;
+    (*context)->magic_number_table = NULL;
+    (*context)->extension_index    = NULL;
+    (*context)->mime_type_index    = NULL;
 
     return SAIL_OK;
 }
@@ -219,6 +246,9 @@ static sail_status_t destroy_context(struct sail_context *context) {
         return SAIL_OK;
     }
 
+    destroy_magic_number_table(context->magic_number_table);
+    destroy_codec_info_index(context->extension_index);
+    destroy_codec_info_index(context->mime_type_index);
     destroy_codec_bundle_node_chain(context->codec_bundle_node);
     sail_free(context);
 
@@ -253,6 +283,18 @@ static int codec_bundle_priority_comparator(const void *elem1, const void *elem2
     return priority1 - priority2;
 }
 
+static bool enumerated_codecs_sorted(const struct sail_context *context) {
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node;
+            codec_bundle_node->next != NULL; codec_bundle_node = codec_bundle_node->next) {
+        if (codec_bundle_node->codec_bundle->codec_info->priority > codec_bundle_node->next->codec_bundle->codec_info->priority) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /*
  * Space complexity: O(n)
  * Time complexity: O(n * log(n))
@@ -264,6 +306,11 @@ static sail_status_t sort_enumerated_codecs(struct sail_context *context) {
         return SAIL_OK;
     }
 
+    /* Combined codecs are already sorted at build time. */
+    if (enumerated_codecs_sorted(context)) {
+        return SAIL_OK;
+    }
+
     /* Count the number of codecs. */
     unsigned codecs_num = 0;
 
@@ -393,14 +440,17 @@ static sail_status_t build_full_path(const char *sail_codecs_path, const char *n
     return SAIL_OK;
 }
 
-static sail_status_t build_codec_bundle_from_codec_info_path(const char *codec_info_full_path,
-                                                             struct sail_codec_bundle_node **codec_bundle_node) {
+/* Builds a codec bundle from the codec info file contents. */
+static sail_status_t build_codec_bundle_from_codec_info(const char *codec_info_full_path,
+                                                        const char *codec_info,
+                                                        struct sail_codec_bundle_node **codec_bundle_node) {
 
     SAIL_CHECK_PTR(codec_info_full_path);
+    SAIL_CHECK_PTR(codec_info);
     SAIL_CHECK_PTR(codec_bundle_node);
 
     /* Build "/path/jpeg.so" from "/path/jpeg.codec.info". */
-    char *codec_info_part = strstr(codec_info_full_path, ".codec.info");
+    const char *codec_info_part = strstr(codec_info_full_path, ".codec.info");
 
     if (codec_info_part == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -437,7 +487,9 @@ static sail_status_t build_codec_bundle_from_codec_info_path(const char *codec_i
                         /* cleanup */ destroy_codec_bundle_node(local_codec_bundle_node),
                                       sail_free(codec_full_path));
 
-    SAIL_TRY_OR_CLEANUP(codec_read_info_from_file(codec_info_full_path, &local_codec_bundle_node->codec_bundle->codec_info),
+    SAIL_LOG_DEBUG("Loading codec info '%s'", codec_info_full_path);
+
+    SAIL_TRY_OR_CLEANUP(codec_read_info_from_string(codec_info, &local_codec_bundle_node->codec_bundle->codec_info),
                         destroy_codec_bundle_node(local_codec_bundle_node),
                         sail_free(codec_full_path));
     local_codec_bundle_node->codec_bundle->codec_info->path = codec_full_path;
@@ -448,19 +500,84 @@ static sail_status_t build_codec_bundle_from_codec_info_path(const char *codec_i
     return SAIL_OK;
 }
 
+/* Reads the codec info file contents as a string. */
+static sail_status_t read_codec_info_file(const char *codec_info_full_path, char **codec_info) {
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY(sail_file_contents_to_data(codec_info_full_path, &data, &data_size));
+
+    SAIL_TRY_OR_CLEANUP(sail_strdup_length(data, data_size, codec_info),
+                        /* cleanup */ sail_free(data));
+
+    sail_free(data);
+
+    return SAIL_OK;
+}
+
+struct enumerated_codecs {
+    struct sail_codec_bundle_node **last_codec_bundle_node;
+    struct sail_codec_registry_cache_writer *cache_writer;
+};
+
+/* Ignores errors to load as much codecs as possible. */
+static sail_status_t add_codec_bundle_from_codec_info(const char *codec_info_full_path, const char *codec_info, void *user_data) {
+
+    struct enumerated_codecs *enumerated_codecs = user_data;
+    struct sail_codec_bundle_node *codec_bundle_node;
+
+    SAIL_TRY(build_codec_bundle_from_codec_info(codec_info_full_path, codec_info, &codec_bundle_node));
+
+    *enumerated_codecs->last_codec_bundle_node = codec_bundle_node;
+    enumerated_codecs->last_codec_bundle_node = &codec_bundle_node->next;
+
+    if (enumerated_codecs->cache_writer != NULL) {
+        SAIL_TRY_OR_EXECUTE(codec_registry_cache_writer_add(enumerated_codecs->cache_writer, codec_info_full_path, codec_info),
+                            /* on error */ destroy_codec_registry_cache_writer(enumerated_codecs->cache_writer);
+                                           enumerated_codecs->cache_writer = NULL);
+    }
+
+    return SAIL_OK;
+}
+
+static void add_codec_bundle_from_codec_info_path(const char *codec_info_full_path, struct enumerated_codecs *enumerated_codecs) {
+
+    char *codec_info;
+    SAIL_TRY_OR_EXECUTE(read_codec_info_file(codec_info_full_path, &codec_info),
+                        /* on error */ return);
+
+    (void)add_codec_bundle_from_codec_info(codec_info_full_path, codec_info, enumerated_codecs);
+
+    sail_free(codec_info);
+}
+
 static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, const struct sail_string_node *string_node) {
 
     SAIL_CHECK_PTR(context);
 
     /* Used to load and store codec info objects. */
-    struct sail_codec_bundle_node **last_codec_bundle_node = &context->codec_bundle_node;
-    struct sail_codec_bundle_node *codec_bundle_node;
+    struct enumerated_codecs enumerated_codecs = { &context->codec_bundle_node, NULL };
+
+    for (const struct sail_string_node *node = string_node; node != NULL; node = node->next) {
+        SAIL_TRY(add_lib_subdir_to_dll_search_path(node->string));
+    }
+
+    /* Try the codec registry cache first to avoid listing directories and reading every codec info file. */
+    const char *cache_path = codec_registry_cache_path();
+
+    if (cache_path != NULL) {
+        if (read_codec_registry_cache(cache_path, string_node, add_codec_bundle_from_codec_info, &enumerated_codecs) == SAIL_OK) {
+            return SAIL_OK;
+        }
+
+        SAIL_LOG_DEBUG("Rebuilding the codec registry cache '%s'", cache_path);
+
+        SAIL_TRY_OR_SUPPRESS(alloc_codec_registry_cache_writer(string_node, &enumerated_codecs.cache_writer));
+    }
 
     for (; string_node != NULL; string_node = string_node->next) {
         const char *codecs_path = string_node->string;
 
-        SAIL_TRY(add_lib_subdir_to_dll_search_path(codecs_path));
-
         SAIL_LOG_DEBUG("Enumerating codecs in '%s'", codecs_path);
 
 #ifdef SAIL_WIN32
@@ -469,7 +586,8 @@ static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, con
         size_t codecs_path_with_mask_length = strlen(codecs_path) + strlen(plugs_info_mask) + 1;
 
         void *ptr;
-        SAIL_TRY(sail_malloc(codecs_path_with_mask_length, &ptr));
+        SAIL_TRY_OR_CLEANUP(sail_malloc(codecs_path_with_mask_length, &ptr),
+                            /* cleanup */ destroy_codec_registry_cache_writer(enumerated_codecs.cache_writer));
         char *codecs_path_with_mask = ptr;
 
 #ifdef _MSC_VER
@@ -499,10 +617,7 @@ static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, con
 
             SAIL_LOG_DEBUG("Found codec info '%s'", data.cFileName);
 
-            if (build_codec_bundle_from_codec_info_path(full_path, &codec_bundle_node) == SAIL_OK) {
-                *last_codec_bundle_node = codec_bundle_node;
-                last_codec_bundle_node = &codec_bundle_node->next;
-            }
+            add_codec_bundle_from_codec_info_path(full_path, &enumerated_codecs);
 
             sail_free(full_path);
         } while (FindNextFile(hFind, &data));
@@ -538,10 +653,7 @@ static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, con
                 if (is_codec_info) {
                     SAIL_LOG_DEBUG("Found codec info '%s'", dir->d_name);
 
-                    if (build_codec_bundle_from_codec_info_path(full_path, &codec_bundle_node) == SAIL_OK) {
-                        *last_codec_bundle_node = codec_bundle_node;
-                        last_codec_bundle_node = &codec_bundle_node->next;
-                    }
+                    add_codec_bundle_from_codec_info_path(full_path, &enumerated_codecs);
                 }
             }
 
@@ -552,6 +664,11 @@ static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, con
 #endif
     }
 
+    if (enumerated_codecs.cache_writer != NULL) {
+        SAIL_TRY_OR_SUPPRESS(codec_registry_cache_writer_save(enumerated_codecs.cache_writer, cache_path));
+        destroy_codec_registry_cache_writer(enumerated_codecs.cache_writer);
+    }
+
     return SAIL_OK;
 }
 #endif
@@ -566,19 +683,27 @@ static sail_status_t init_context_impl(struct sail_context *context) {
 #ifdef SAIL_STATIC
     /* For example: [ "gif", "jpeg", "png" ]. */
     extern const char * const sail_enabled_codecs[];
-    extern const char * const sail_enabled_codecs_info[];
+    extern const struct sail_codec_info * const sail_enabled_codecs_info[];
 #else
     SAIL_IMPORT extern const char * const sail_enabled_codecs[];
-    SAIL_IMPORT extern const char * const sail_enabled_codecs_info[];
+    SAIL_IMPORT extern const struct sail_codec_info * const sail_enabled_codecs_info[];
 #endif
 
-    /* Load codec info objects. */
+    /*
+     * Codec info objects are generated at build time and sorted by priority.
+     * They are static and never destroyed. See destroy_codec_bundle().
+     */
     struct sail_codec_bundle_node **last_codec_bundle_node = &context->codec_bundle_node;
 
     for (size_t i = 0; sail_enabled_codecs[i] != NULL; i++) {
-        const char *sail_codec_info = sail_enabled_codecs_info[i];
+        const struct sail_codec_info *sail_codec_info = sail_enabled_codecs_info[i];
+
+        if (sail_codec_info->layout != SAIL_CODEC_LAYOUT_V8) {
+            SAIL_LOG_ERROR("Unsupported codec layout version %d of %s codec. Please check your codec info files",
+                            sail_codec_info->layout, sail_codec_info->name);
+            continue;
+        }
 
-        /* Parse codec info. */
         struct sail_codec_bundle_node *codec_bundle_node;
         SAIL_TRY_OR_EXECUTE(alloc_codec_bundle_node(&codec_bundle_node),
                             /* on error */ continue);
@@ -587,9 +712,7 @@ static sail_status_t init_context_impl(struct sail_context *context) {
                             /* on error */ destroy_codec_bundle_node(codec_bundle_node);
                                            continue);
 
-        SAIL_TRY_OR_EXECUTE(codec_read_info_from_string(sail_codec_info, &codec_bundle_node->codec_bundle->codec_info),
-                            /* on error */ destroy_codec_bundle_node(codec_bundle_node);
-                                           continue);
+        codec_bundle_node->codec_bundle->codec_info = (struct sail_codec_info *)sail_codec_info;
 
         *last_codec_bundle_node = codec_bundle_node;
         last_codec_bundle_node = &codec_bundle_node->next;
@@ -741,6 +864,16 @@ static void print_build_statistics(void) {
 #endif
 }
 
+static const struct sail_string_node* codec_info_extensions(const struct sail_codec_info *codec_info) {
+
+    return codec_info->extension_node;
+}
+
+static const struct sail_string_node* codec_info_mime_types(const struct sail_codec_info *codec_info) {
+
+    return codec_info->mime_type_node;
+}
+
 /* Initializes the context and loads all the codec info files if the context is not initialized. */
 static sail_status_t init_context(struct sail_context *context, int flags) {
 
@@ -773,6 +906,10 @@ static sail_status_t init_context(struct sail_context *context, int flags) {
 
     SAIL_TRY(sort_enumerated_codecs(context));
 
+    SAIL_TRY(alloc_magic_number_table(context->codec_bundle_node, &context->magic_number_table));
+    SAIL_TRY(alloc_codec_info_index(context->codec_bundle_node, codec_info_extensions, &context->extension_index));
+    SAIL_TRY(alloc_codec_info_index(context->codec_bundle_node, codec_info_mime_types, &context->mime_type_index));
+
     SAIL_TRY(print_enumerated_codecs(context));
 
     if (flags & SAIL_FLAG_PRELOAD_CODECS) {
@@ -781,6 +918,8 @@ static sail_status_t init_context(struct sail_context *context, int flags) {
 
     SAIL_LOG_DEBUG("Initialized in %lu ms.", (unsigned long)(sail_now() - start_time));
 
+    publish_global_context(context);
+
     return SAIL_OK;
 }
 
@@ -793,7 +932,12 @@ sail_status_t destroy_global_context(void) {
     SAIL_TRY(lock_context());
 
     SAIL_LOG_DEBUG("Destroyed context %p", global_context);
+    publish_global_context(NULL);
+
+    sail_private_begin_global_allocation();
     destroy_context(global_context);
+    sail_private_end_global_allocation();
+
     global_context = NULL;
 
     SAIL_TRY(unlock_context());
@@ -819,6 +963,14 @@ sail_status_t fetch_global_context_guarded_with_flags(struct sail_context **cont
 
     SAIL_CHECK_PTR(context);
 
+    /* Fast path: the context is already initialized. */
+    struct sail_context *published_context = load_published_global_context();
+
+    if (SAIL_LIKELY(published_context != NULL)) {
+        *context = published_context;
+        return SAIL_OK;
+    }
+
     SAIL_TRY(lock_context());
 
     SAIL_TRY_OR_CLEANUP(fetch_global_context_unsafe_with_flags(context, flags),
@@ -833,10 +985,17 @@ sail_status_t fetch_global_context_unsafe_with_flags(struct sail_context **conte
 
     SAIL_CHECK_PTR(context);
 
+    /* The context is shared between threads, so it must not be allocated with a thread allocator. */
+    sail_private_begin_global_allocation();
+
     struct sail_context *local_context;
 
-    SAIL_TRY(allocate_global_context(&local_context));
-    SAIL_TRY(init_context(local_context, flags));
+    SAIL_TRY_OR_CLEANUP(allocate_global_context(&local_context),
+                        /* cleanup */ sail_private_end_global_allocation());
+    SAIL_TRY_OR_CLEANUP(init_context(local_context, flags),
+                        /* cleanup */ sail_private_end_global_allocation());
+
+    sail_private_end_global_allocation();
 
     *context = local_context;
 
@@ -863,8 +1022,13 @@ sail_status_t sail_unload_codecs_private(void) {
         struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
 
         if (codec_bundle->codec != NULL) {
-            destroy_codec(codec_bundle->codec);
-            codec_bundle->codec = NULL;
+            struct sail_codec *codec = codec_bundle->codec;
+            codec_bundle_publish_codec(codec_bundle, NULL);
+
+            sail_private_begin_global_allocation();
+            destroy_codec(codec);
+            sail_private_end_global_allocation();
+
             counter++;
         }
     }
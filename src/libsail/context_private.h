@@ -37,6 +37,8 @@
 #endif
 
 struct sail_codec_bundle_node;
+struct sail_codec_info_index;
+struct sail_magic_number_table;
 
 /*
  * Context is a main entry point to start working with SAIL. It enumerates codec info objects which could be
@@ -49,6 +51,13 @@ struct sail_context {
 
     /* Linked list of found codec info objects. */
     struct sail_codec_bundle_node *codec_bundle_node;
+
+    /* Magic numbers of the found codecs compiled for fast lookups. */
+    struct sail_magic_number_table *magic_number_table;
+
+    /* Found codecs indexed by their extensions and MIME types. */
+    struct sail_codec_info_index *extension_index;
+    struct sail_codec_info_index *mime_type_index;
 };
 
 typedef struct sail_context sail_context_t;
@@ -0,0 +1,334 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+struct buffered_io_stream {
+
+    /* Underlying I/O object. */
+    struct sail_io *io;
+    bool own_io;
+
+    /* Read-ahead buffer. */
+    unsigned char *buffer;
+    size_t buffer_size;
+
+    /* The number of valid bytes in the buffer. */
+    size_t length;
+
+    /* Current position in the buffer. */
+    size_t pos;
+};
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t io_buffered_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    unsigned char *buf_ptr = buf;
+    size_t total_read = 0;
+
+    while (size_to_read > 0) {
+        if (buffered_io_stream->pos == buffered_io_stream->length) {
+            size_t actually_read;
+
+            /* Large reads bypass the buffer. Drop the buffered block as it no longer precedes the position. */
+            if (size_to_read >= buffered_io_stream->buffer_size) {
+                buffered_io_stream->pos    = 0;
+                buffered_io_stream->length = 0;
+
+                const sail_status_t status = io->tolerant_read(io->stream, buf_ptr, size_to_read, &actually_read);
+
+                if (status != SAIL_OK) {
+                    if (total_read == 0) {
+                        return status;
+                    }
+                    break;
+                }
+
+                total_read += actually_read;
+                break;
+            }
+
+            /* Refill. */
+            buffered_io_stream->pos    = 0;
+            buffered_io_stream->length = 0;
+
+            const sail_status_t status = io->tolerant_read(io->stream, buffered_io_stream->buffer,
+                                                            buffered_io_stream->buffer_size, &actually_read);
+
+            if (status != SAIL_OK) {
+                if (total_read == 0) {
+                    return status;
+                }
+                break;
+            }
+
+            if (actually_read == 0) {
+                break;
+            }
+
+            buffered_io_stream->length = actually_read;
+        }
+
+        const size_t available = buffered_io_stream->length - buffered_io_stream->pos;
+        const size_t chunk = size_to_read < available ? size_to_read : available;
+
+        memcpy(buf_ptr, buffered_io_stream->buffer + buffered_io_stream->pos, chunk);
+
+        buffered_io_stream->pos += chunk;
+        buf_ptr                 += chunk;
+        total_read              += chunk;
+        size_to_read            -= chunk;
+    }
+
+    *read_size = total_read;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+
+    /* Fast path: the requested data is already in the buffer. */
+    if (buffered_io_stream->length - buffered_io_stream->pos >= size_to_read) {
+        memcpy(buf, buffered_io_stream->buffer + buffered_io_stream->pos, size_to_read);
+        buffered_io_stream->pos += size_to_read;
+        return SAIL_OK;
+    }
+
+    size_t read_size;
+    SAIL_TRY(io_buffered_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    const size_t unread = buffered_io_stream->length - buffered_io_stream->pos;
+
+    switch (whence) {
+        case SEEK_CUR: {
+            /* Seek within the buffer. */
+            if (offset >= -(long)buffered_io_stream->pos && offset <= (long)unread) {
+                buffered_io_stream->pos = (size_t)((long)buffered_io_stream->pos + offset);
+                return SAIL_OK;
+            }
+
+            /* The underlying position is ahead of the logical position by the number of unread bytes. */
+            SAIL_TRY(io->seek(io->stream, offset - (long)unread, SEEK_CUR));
+            break;
+        }
+
+        case SEEK_SET: {
+            if (buffered_io_stream->length > 0 && offset >= 0) {
+                size_t buffer_end;
+                SAIL_TRY(io->tell(io->stream, &buffer_end));
+
+                const size_t buffer_start = buffer_end - buffered_io_stream->length;
+
+                if ((size_t)offset >= buffer_start && (size_t)offset <= buffer_end) {
+                    buffered_io_stream->pos = (size_t)offset - buffer_start;
+                    return SAIL_OK;
+                }
+            }
+
+            SAIL_TRY(io->seek(io->stream, offset, SEEK_SET));
+            break;
+        }
+
+        default: {
+            SAIL_TRY(io->seek(io->stream, offset, whence));
+            break;
+        }
+    }
+
+    buffered_io_stream->pos    = 0;
+    buffered_io_stream->length = 0;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    size_t offset_local;
+    SAIL_TRY(io->tell(io->stream, &offset_local));
+
+    *offset = offset_local - (buffered_io_stream->length - buffered_io_stream->pos);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    if (buffered_io_stream->own_io) {
+        sail_destroy_io(io);
+    } else {
+        /* Give the unread bytes back to the underlying I/O object. */
+        const size_t unread = buffered_io_stream->length - buffered_io_stream->pos;
+
+        if (unread > 0 && (io->features & SAIL_IO_FEATURE_SEEKABLE)) {
+            SAIL_TRY_OR_EXECUTE(io->seek(io->stream, -(long)unread, SEEK_CUR),
+                                /* on error */ SAIL_LOG_WARNING("Failed to rewind the underlying I/O object"));
+        }
+    }
+
+    sail_free(buffered_io_stream->buffer);
+    sail_free(buffered_io_stream);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    if (buffered_io_stream->pos < buffered_io_stream->length) {
+        *result = false;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(io->eof(io->stream, result));
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_buffered_borrow(void *stream, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    struct buffered_io_stream *buffered_io_stream = (struct buffered_io_stream *)stream;
+    struct sail_io *io = buffered_io_stream->io;
+
+    const void *data_local;
+    size_t data_size_local;
+    SAIL_TRY(io->borrow(io->stream, &data_local, &data_size_local));
+
+    /* The bytes are contiguous, so step back over the unread bytes in the buffer. */
+    const size_t unread = buffered_io_stream->length - buffered_io_stream->pos;
+
+    *data      = (const unsigned char *)data_local - unread;
+    *data_size = data_size_local + unread;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_io_read_buffered(struct sail_io *io, bool own_io, size_t buffer_size,
+                                          struct sail_io **buffered_io) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(buffered_io);
+
+    if (buffer_size == 0) {
+        SAIL_LOG_ERROR("Buffer size must be positive");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct sail_io *io_local;
+    SAIL_TRY(sail_alloc_io(&io_local));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct buffered_io_stream), &ptr),
+                        /* cleanup */ sail_destroy_io(io_local));
+    struct buffered_io_stream *buffered_io_stream = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_size, &ptr),
+                        /* cleanup */ sail_free(buffered_io_stream),
+                                      sail_destroy_io(io_local));
+
+    buffered_io_stream->io          = io;
+    buffered_io_stream->own_io      = own_io;
+    buffered_io_stream->buffer      = ptr;
+    buffered_io_stream->buffer_size = buffer_size;
+    buffered_io_stream->length      = 0;
+    buffered_io_stream->pos         = 0;
+
+    io_local->id             = SAIL_BUFFERED_IO_ID;
+    io_local->features       = io->features;
+    io_local->stream         = buffered_io_stream;
+    io_local->tolerant_read  = io_buffered_tolerant_read;
+    io_local->strict_read    = io_buffered_strict_read;
+    io_local->tolerant_write = sail_io_noop_tolerant_write;
+    io_local->strict_write   = sail_io_noop_strict_write;
+    io_local->seek           = io_buffered_seek;
+    io_local->tell           = io_buffered_tell;
+    io_local->flush          = sail_io_noop_flush;
+    io_local->close          = io_buffered_close;
+    io_local->eof            = io_buffered_eof;
+    io_local->borrow         = io->borrow != NULL ? io_buffered_borrow : NULL;
+
+    *buffered_io = io_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,76 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IO_BUFFERED_H
+#define SAIL_IO_BUFFERED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/*
+ * Well-known I/O id used in libsail for buffered I/O classes.
+ *
+ * SAIL_BUFFERED_IO_ID = sail_string_hash("sail-buffered-io-id")
+ */
+static const uint64_t SAIL_BUFFERED_IO_ID = UINT64_C(7207463336408363069);
+
+/*
+ * Wraps the specified I/O object into a new read-only I/O object that reads ahead from it
+ * in blocks of the specified size. Small reads like one to four bytes in RLE decoders are then
+ * served from the read-ahead buffer instead of calling the underlying I/O object every time.
+ * Reads larger than the block size bypass the buffer.
+ *
+ * If own_io is true, the underlying I/O object is destroyed along with the buffered I/O object.
+ * Otherwise, the underlying I/O object is left open, and its position is rewound to the last byte
+ * actually consumed if the underlying I/O object is seekable.
+ *
+ * sail_io.stream is an opaque internal object.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_buffered(struct sail_io *io, bool own_io, size_t buffer_size,
+                                                      struct sail_io **buffered_io);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,6 +26,7 @@
 #include "config.h"
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -67,6 +68,19 @@ struct mem_io_write_stream {
     void *buffer;
 };
 
+/* Must start with the same fields as mem_io_write_stream to share the read functions. */
+struct mem_io_growable_stream {
+    struct mem_io_buffer_info mem_io_buffer_info;
+    void *buffer;
+
+    /* Receive the written data and its size when the stream is closed. */
+    void **output_buffer;
+    size_t *output_length;
+};
+
+/* The minimum allocation size of growable memory buffers. */
+static const size_t MEM_IO_GROWABLE_MIN_LENGTH = 4096;
+
 /*
  * Private functions.
  */
@@ -238,6 +252,147 @@ static sail_status_t io_memory_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+static sail_status_t io_memory_borrow(void *stream, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    struct mem_io_read_stream *mem_io_read_stream = (struct mem_io_read_stream *)stream;
+    struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_read_stream->mem_io_buffer_info;
+
+    const size_t pos = mem_io_buffer_info->pos < mem_io_buffer_info->accessible_length
+                        ? mem_io_buffer_info->pos
+                        : mem_io_buffer_info->accessible_length;
+
+    *data      = (const char *)mem_io_read_stream->buffer + pos;
+    *data_size = mem_io_buffer_info->accessible_length - pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_tolerant_write(void *stream, const void *buf, size_t size_to_write, size_t *written_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(written_size);
+
+    struct mem_io_growable_stream *mem_io_growable_stream = (struct mem_io_growable_stream *)stream;
+    struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_growable_stream->mem_io_buffer_info;
+
+    *written_size = 0;
+
+    if (size_to_write > SIZE_MAX - mem_io_buffer_info->pos) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    const size_t required_length = mem_io_buffer_info->pos + size_to_write;
+
+    /* Grow geometrically to keep the number of reallocations logarithmic. */
+    if (required_length > mem_io_buffer_info->length) {
+        size_t new_length = mem_io_buffer_info->length < MEM_IO_GROWABLE_MIN_LENGTH
+                            ? MEM_IO_GROWABLE_MIN_LENGTH
+                            : mem_io_buffer_info->length;
+
+        while (new_length < required_length) {
+            new_length = (new_length > SIZE_MAX / 2) ? required_length : new_length * 2;
+        }
+
+        SAIL_TRY(sail_realloc(new_length, &mem_io_growable_stream->buffer));
+        mem_io_buffer_info->length = new_length;
+    }
+
+    /* Zero the gap left by seeking past the end. */
+    if (mem_io_buffer_info->pos > mem_io_buffer_info->accessible_length) {
+        memset((char *)mem_io_growable_stream->buffer + mem_io_buffer_info->accessible_length,
+                0,
+                mem_io_buffer_info->pos - mem_io_buffer_info->accessible_length);
+    }
+
+    memcpy((char *)mem_io_growable_stream->buffer + mem_io_buffer_info->pos, buf, size_to_write);
+    mem_io_buffer_info->pos += size_to_write;
+
+    *written_size = size_to_write;
+
+    if (mem_io_buffer_info->pos > mem_io_buffer_info->accessible_length) {
+        mem_io_buffer_info->accessible_length = mem_io_buffer_info->pos;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_strict_write(void *stream, const void *buf, size_t size_to_write) {
+
+    size_t written_size;
+
+    SAIL_TRY(io_growable_memory_tolerant_write(stream, buf, size_to_write, &written_size));
+
+    if (written_size != size_to_write) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mem_io_buffer_info *mem_io_buffer_info = (struct mem_io_buffer_info *)stream;
+
+    long base;
+
+    switch (whence) {
+        case SEEK_SET: base = 0;                                           break;
+        case SEEK_CUR: base = (long)mem_io_buffer_info->pos;               break;
+        case SEEK_END: base = (long)mem_io_buffer_info->accessible_length; break;
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    if (offset < -base) {
+        SAIL_LOG_ERROR("Cannot seek before the beginning of a growable memory buffer");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    /* Seeking past the end is allowed. The gap is zeroed on the next write. */
+    mem_io_buffer_info->pos = (size_t)(base + offset);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mem_io_growable_stream *mem_io_growable_stream = (struct mem_io_growable_stream *)stream;
+    const size_t accessible_length = mem_io_growable_stream->mem_io_buffer_info.accessible_length;
+
+    void *buffer = mem_io_growable_stream->buffer;
+
+    if (accessible_length == 0) {
+        sail_free(buffer);
+        buffer = NULL;
+    } else if (accessible_length < mem_io_growable_stream->mem_io_buffer_info.length) {
+        /* Give the unused tail back. Not an error if shrinking fails. */
+        void *shrunk_buffer = buffer;
+
+        if (sail_realloc(accessible_length, &shrunk_buffer) == SAIL_OK) {
+            buffer = shrunk_buffer;
+        }
+    }
+
+    /* Transfer the ownership. */
+    *mem_io_growable_stream->output_buffer = buffer;
+    *mem_io_growable_stream->output_length = accessible_length;
+
+    sail_free(mem_io_growable_stream);
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -263,6 +418,7 @@ sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t length, struc
     mem_io_read_stream->buffer                               = buffer;
 
     io_local->id             = SAIL_MEMORY_IO_ID;
+    io_local->features       = SAIL_IO_FEATURE_BORROWABLE;
     io_local->stream         = mem_io_read_stream;
     io_local->tolerant_read  = io_memory_tolerant_read;
     io_local->strict_read    = io_memory_strict_read;
@@ -273,6 +429,7 @@ sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t length, struc
     io_local->flush          = sail_io_noop_flush;
     io_local->close          = io_memory_close;
     io_local->eof            = io_memory_eof;
+    io_local->borrow         = io_memory_borrow;
 
     *io = io_local;
 
@@ -316,3 +473,54 @@ sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struc
 
     return SAIL_OK;
 }
+
+sail_status_t sail_alloc_io_write_growable_memory(size_t size_hint, void **buffer, size_t *buffer_length, struct sail_io **io) {
+
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(buffer_length);
+    SAIL_CHECK_PTR(io);
+
+    SAIL_LOG_DEBUG("Opening growable memory buffer with the size hint %lu for writing", (unsigned long)size_hint);
+
+    *buffer        = NULL;
+    *buffer_length = 0;
+
+    struct sail_io *io_local;
+    SAIL_TRY(sail_alloc_io(&io_local));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct mem_io_growable_stream), &ptr),
+                        /* cleanup */ sail_destroy_io(io_local));
+    struct mem_io_growable_stream *mem_io_growable_stream = ptr;
+
+    mem_io_growable_stream->mem_io_buffer_info.length            = 0;
+    mem_io_growable_stream->mem_io_buffer_info.accessible_length = 0;
+    mem_io_growable_stream->mem_io_buffer_info.pos               = 0;
+    mem_io_growable_stream->buffer                               = NULL;
+    mem_io_growable_stream->output_buffer                        = buffer;
+    mem_io_growable_stream->output_length                        = buffer_length;
+
+    if (size_hint > 0) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc(size_hint, &mem_io_growable_stream->buffer),
+                            /* cleanup */ sail_free(mem_io_growable_stream),
+                                          sail_destroy_io(io_local));
+        mem_io_growable_stream->mem_io_buffer_info.length = size_hint;
+    }
+
+    io_local->id             = SAIL_MEMORY_IO_ID;
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE;
+    io_local->stream         = mem_io_growable_stream;
+    io_local->tolerant_read  = io_memory_tolerant_read;
+    io_local->strict_read    = io_memory_strict_read;
+    io_local->tolerant_write = io_growable_memory_tolerant_write;
+    io_local->strict_write   = io_growable_memory_strict_write;
+    io_local->seek           = io_growable_memory_seek;
+    io_local->tell           = io_memory_tell;
+    io_local->flush          = io_memory_flush;
+    io_local->close          = io_growable_memory_close;
+    io_local->eof            = io_memory_eof;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
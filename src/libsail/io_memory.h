@@ -56,6 +56,21 @@ SAIL_EXPORT sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t l
  */
 SAIL_EXPORT sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struct sail_io **io);
 
+/*
+ * Allocates a new I/O object that writes into an automatically growing memory buffer.
+ * The buffer grows geometrically, so the output size doesn't need to be known in advance.
+ * 'size_hint' is the number of bytes to preallocate. It may be 0.
+ *
+ * When the I/O object is closed, the written data is assigned to 'buffer' and its size
+ * to 'buffer_length', and the caller takes ownership of the data. It must be freed
+ * with sail_free(). 'buffer' is assigned NULL if nothing was written. Both pointers
+ * must stay valid until the I/O object is closed.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_write_growable_memory(size_t size_hint, void **buffer, size_t *buffer_length,
+                                                              struct sail_io **io);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -0,0 +1,325 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h> /* CreateFileMapping */
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+#endif
+
+#include "sail.h"
+
+struct mmap_io_stream {
+
+    /* Mapped file contents. */
+    const unsigned char *data;
+    size_t length;
+
+    /* Current stream position. */
+    size_t pos;
+};
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t map_file(const char *path, const unsigned char **data, size_t *length) {
+
+#ifdef SAIL_WIN32
+    wchar_t *path_w;
+    SAIL_TRY(sail_to_wchar(path, &path_w));
+
+    HANDLE file = CreateFileW(path_w, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    sail_free(path_w);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        SAIL_LOG_ERROR("Failed to open '%s'. Error: 0x%X", path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size)) {
+        SAIL_LOG_ERROR("Failed to get the size of '%s'. Error: 0x%X", path, GetLastError());
+        CloseHandle(file);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    if (size.QuadPart == 0) {
+        SAIL_LOG_ERROR("Cannot map empty file '%s'", path);
+        CloseHandle(file);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL) {
+        SAIL_LOG_ERROR("Failed to map '%s'. Error: 0x%X", path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    /* The view keeps the mapping alive. */
+    void *data_local = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data_local == NULL) {
+        SAIL_LOG_ERROR("Failed to map '%s'. Error: 0x%X", path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    *data   = data_local;
+    *length = (size_t)size.QuadPart;
+#else
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        sail_print_errno("Failed to open the specified file: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    struct stat attrs;
+
+    if (fstat(fd, &attrs) != 0) {
+        sail_print_errno("Failed to get the file size: %s");
+        close(fd);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    if (!S_ISREG(attrs.st_mode) || attrs.st_size == 0) {
+        SAIL_LOG_ERROR("Cannot map '%s' as it's not a regular file or it's empty", path);
+        close(fd);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    void *data_local = mmap(NULL, (size_t)attrs.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    /* The mapping stays valid after closing the descriptor. */
+    close(fd);
+
+    if (data_local == MAP_FAILED) {
+        sail_print_errno("Failed to map the file: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    /* Codecs mostly read files from the beginning to the end. This is just a hint. */
+    posix_madvise(data_local, (size_t)attrs.st_size, POSIX_MADV_SEQUENTIAL);
+
+    *data   = data_local;
+    *length = (size_t)attrs.st_size;
+#endif
+
+    return SAIL_OK;
+}
+
+static void unmap_file(const unsigned char *data, size_t length) {
+
+#ifdef SAIL_WIN32
+    (void)length;
+
+    if (!UnmapViewOfFile(data)) {
+        SAIL_LOG_ERROR("Failed to unmap the file. Error: 0x%X", GetLastError());
+    }
+#else
+    if (munmap((void *)data, length) != 0) {
+        sail_print_errno("Failed to unmap the file: %s");
+    }
+#endif
+}
+
+static sail_status_t io_mmap_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    *read_size = 0;
+
+    if (mmap_io_stream->pos >= mmap_io_stream->length) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+    }
+
+    const size_t available = mmap_io_stream->length - mmap_io_stream->pos;
+    const size_t actual_size_to_read = size_to_read < available ? size_to_read : available;
+
+    memcpy(buf, mmap_io_stream->data + mmap_io_stream->pos, actual_size_to_read);
+    mmap_io_stream->pos += actual_size_to_read;
+
+    *read_size = actual_size_to_read;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_mmap_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    long new_pos;
+
+    switch (whence) {
+        case SEEK_SET: new_pos = offset;                                break;
+        case SEEK_CUR: new_pos = (long)mmap_io_stream->pos + offset;    break;
+        case SEEK_END: new_pos = (long)mmap_io_stream->length + offset; break;
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    if (new_pos < 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    /* Reading beyond the end returns EOF. */
+    mmap_io_stream->pos = (size_t)new_pos > mmap_io_stream->length ? mmap_io_stream->length : (size_t)new_pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    *offset = mmap_io_stream->pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    unmap_file(mmap_io_stream->data, mmap_io_stream->length);
+    sail_free(mmap_io_stream);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    *result = mmap_io_stream->pos >= mmap_io_stream->length;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_borrow(void *stream, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    struct mmap_io_stream *mmap_io_stream = (struct mmap_io_stream *)stream;
+
+    *data      = mmap_io_stream->data + mmap_io_stream->pos;
+    *data_size = mmap_io_stream->length - mmap_io_stream->pos;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_io_read_mmap(const char *path, struct sail_io **io) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(io);
+
+    SAIL_LOG_DEBUG("Mapping file '%s' for reading", path);
+
+    const unsigned char *data;
+    size_t length;
+    SAIL_TRY(map_file(path, &data, &length));
+
+    struct sail_io *io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&io_local),
+                        /* cleanup */ unmap_file(data, length));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct mmap_io_stream), &ptr),
+                        /* cleanup */ sail_destroy_io(io_local),
+                                      unmap_file(data, length));
+    struct mmap_io_stream *mmap_io_stream = ptr;
+
+    mmap_io_stream->data   = data;
+    mmap_io_stream->length = length;
+    mmap_io_stream->pos    = 0;
+
+    io_local->id             = SAIL_MMAP_IO_ID;
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE | SAIL_IO_FEATURE_BORROWABLE;
+    io_local->stream         = mmap_io_stream;
+    io_local->tolerant_read  = io_mmap_tolerant_read;
+    io_local->strict_read    = io_mmap_strict_read;
+    io_local->tolerant_write = sail_io_noop_tolerant_write;
+    io_local->strict_write   = sail_io_noop_strict_write;
+    io_local->seek           = io_mmap_seek;
+    io_local->tell           = io_mmap_tell;
+    io_local->flush          = sail_io_noop_flush;
+    io_local->close          = io_mmap_close;
+    io_local->eof            = io_mmap_eof;
+    io_local->borrow         = io_mmap_borrow;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,72 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IO_MMAP_H
+#define SAIL_IO_MMAP_H
+
+#include <stdint.h>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/*
+ * Well-known I/O id used in libsail for memory-mapped file I/O classes.
+ *
+ * SAIL_MMAP_IO_ID = sail_string_hash("sail-mmap-io-id")
+ */
+static const uint64_t SAIL_MMAP_IO_ID = UINT64_C(5821120586751770661);
+
+/*
+ * Maps the specified image file into memory for reading and allocates a new I/O object for it.
+ * The file is unmapped when the I/O object is destroyed. Empty files cannot be mapped.
+ *
+ * sail_load_from_file() and brothers use memory-mapped I/O automatically for files larger
+ * than SAIL_MMAP_IO_THRESHOLD bytes.
+ *
+ * The I/O object is borrowable, i.e. codecs can use the mapped bytes directly without copying them.
+ *
+ * sail_io.stream is an opaque internal object.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_mmap(const char *path, struct sail_io **io);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
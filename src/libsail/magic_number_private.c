@@ -0,0 +1,264 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "sail-common.h"
+#include "sail.h"
+
+/*
+ * Private functions.
+ */
+
+/*
+ * "ab ?? cd" is compiled into the bytes { 0xab, 0x00, 0xcd } and the masks { 0xff, 0x00, 0xff }.
+ * The input byte matches when (byte & mask) == bytes[i].
+ */
+struct sail_magic_number {
+    unsigned char bytes[SAIL_MAGIC_BUFFER_SIZE];
+    unsigned char masks[SAIL_MAGIC_BUFFER_SIZE];
+    size_t length;
+
+    const struct sail_codec_info *codec_info;
+};
+
+struct sail_magic_number_table {
+
+    /* Magic numbers of all the codecs sorted by the codec priority. */
+    struct sail_magic_number *magic_numbers;
+
+    /*
+     * Magic numbers that could match an input starting with the byte N are stored
+     * in candidates[first_candidate[N] .. first_candidate[N+1]) in the priority order.
+     * Magic numbers starting with "??" are stored for every byte.
+     */
+    const struct sail_magic_number **candidates;
+    size_t first_candidate[256 + 1];
+};
+
+static int hex_digit_value(char c) {
+
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else {
+        return -1;
+    }
+}
+
+static bool is_space(char c) {
+
+    return c == ' ' || c == '\t';
+}
+
+/*
+ * Splits "ab cd" into bytes. Additionally, we support "??" pattern matching any byte.
+ * For example, "?? ?? 66 74" matches both "00 20 66 74" and "20 30 66 74".
+ */
+static bool compile_magic_number(const char *str, struct sail_magic_number *magic_number) {
+
+    magic_number->length = 0;
+
+    while (true) {
+        while (is_space(*str)) {
+            str++;
+        }
+
+        if (*str == '\0') {
+            break;
+        }
+
+        if (magic_number->length == SAIL_MAGIC_BUFFER_SIZE) {
+            return false;
+        }
+
+        /* Every byte is one or two characters long. */
+        const char first = *str++;
+        const char second = (*str != '\0' && !is_space(*str)) ? *str++ : '\0';
+
+        if (first == '?') {
+            magic_number->bytes[magic_number->length] = 0;
+            magic_number->masks[magic_number->length] = 0;
+        } else {
+            const int high = hex_digit_value(first);
+            const int low = (second == '\0') ? 0 : hex_digit_value(second);
+
+            if (high < 0 || low < 0) {
+                return false;
+            }
+
+            magic_number->bytes[magic_number->length] = (unsigned char)((second == '\0') ? high : (high << 4 | low));
+            magic_number->masks[magic_number->length] = 0xFF;
+        }
+
+        magic_number->length++;
+    }
+
+    return magic_number->length > 0;
+}
+
+static bool magic_number_matches(const struct sail_magic_number *magic_number, const unsigned char *buffer) {
+
+    for (size_t i = 0; i < magic_number->length; i++) {
+        if ((buffer[i] & magic_number->masks[i]) != magic_number->bytes[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Public functions.
+ */
+
+bool is_valid_magic_number(const char *magic_number) {
+
+    struct sail_magic_number compiled;
+
+    return compile_magic_number(magic_number, &compiled);
+}
+
+sail_status_t alloc_magic_number_table(const struct sail_codec_bundle_node *codec_bundle_node,
+                                       struct sail_magic_number_table **magic_number_table) {
+
+    SAIL_CHECK_PTR(magic_number_table);
+
+    size_t magic_numbers_length = 0;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        for (const struct sail_string_node *magic_number_node = node->codec_bundle->codec_info->magic_number_node;
+                magic_number_node != NULL; magic_number_node = magic_number_node->next) {
+            magic_numbers_length++;
+        }
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_magic_number_table), &ptr));
+    struct sail_magic_number_table *magic_number_table_local = ptr;
+
+    magic_number_table_local->magic_numbers = NULL;
+    magic_number_table_local->candidates    = NULL;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((magic_numbers_length + 1) * sizeof(struct sail_magic_number), &ptr),
+                        /* cleanup */ destroy_magic_number_table(magic_number_table_local));
+    magic_number_table_local->magic_numbers = ptr;
+
+    /* Compile. Magic numbers are validated when parsing codec info files, so they never fail here. */
+    size_t count = 0;
+    size_t candidates_length = 0;
+    size_t counts[256] = { 0 };
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        for (const struct sail_string_node *magic_number_node = node->codec_bundle->codec_info->magic_number_node;
+                magic_number_node != NULL; magic_number_node = magic_number_node->next) {
+            struct sail_magic_number *magic_number = &magic_number_table_local->magic_numbers[count];
+
+            if (!compile_magic_number(magic_number_node->string, magic_number)) {
+                continue;
+            }
+
+            magic_number->codec_info = node->codec_bundle->codec_info;
+            count++;
+
+            if (magic_number->masks[0] == 0) {
+                for (unsigned byte = 0; byte < 256; byte++) {
+                    counts[byte]++;
+                }
+
+                candidates_length += 256;
+            } else {
+                counts[magic_number->bytes[0]]++;
+                candidates_length++;
+            }
+        }
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((candidates_length + 1) * sizeof(struct sail_magic_number *), &ptr),
+                        /* cleanup */ destroy_magic_number_table(magic_number_table_local));
+    magic_number_table_local->candidates = ptr;
+
+    /* Group by the first byte preserving the priority order. */
+    size_t positions[256];
+    magic_number_table_local->first_candidate[0] = 0;
+
+    for (unsigned byte = 0; byte < 256; byte++) {
+        positions[byte] = magic_number_table_local->first_candidate[byte];
+        magic_number_table_local->first_candidate[byte + 1] = magic_number_table_local->first_candidate[byte] + counts[byte];
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const struct sail_magic_number *magic_number = &magic_number_table_local->magic_numbers[i];
+
+        if (magic_number->masks[0] == 0) {
+            for (unsigned byte = 0; byte < 256; byte++) {
+                magic_number_table_local->candidates[positions[byte]++] = magic_number;
+            }
+        } else {
+            magic_number_table_local->candidates[positions[magic_number->bytes[0]]++] = magic_number;
+        }
+    }
+
+    SAIL_LOG_DEBUG("Compiled %lu magic numbers", (unsigned long)count);
+
+    *magic_number_table = magic_number_table_local;
+
+    return SAIL_OK;
+}
+
+void destroy_magic_number_table(struct sail_magic_number_table *magic_number_table) {
+
+    if (magic_number_table == NULL) {
+        return;
+    }
+
+    sail_free((void *)magic_number_table->candidates);
+    sail_free(magic_number_table->magic_numbers);
+    sail_free(magic_number_table);
+}
+
+const struct sail_codec_info* find_codec_info_by_magic_number(const struct sail_magic_number_table *magic_number_table,
+                                                              const unsigned char *buffer) {
+
+    const size_t first = magic_number_table->first_candidate[buffer[0]];
+    const size_t last  = magic_number_table->first_candidate[buffer[0] + 1];
+
+    for (size_t i = first; i < last; i++) {
+        const struct sail_magic_number *magic_number = magic_number_table->candidates[i];
+
+        if (magic_number_matches(magic_number, buffer)) {
+            return magic_number->codec_info;
+        }
+    }
+
+    return NULL;
+}
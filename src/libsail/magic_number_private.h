@@ -0,0 +1,72 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_MAGIC_NUMBER_PRIVATE_H
+#define SAIL_MAGIC_NUMBER_PRIVATE_H
+
+#include <stdbool.h>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+struct sail_codec_bundle_node;
+struct sail_codec_info;
+
+/*
+ * Magic numbers of all the enumerated codecs compiled into byte and mask pairs
+ * and grouped by their first byte.
+ */
+struct sail_magic_number_table;
+
+/*
+ * Returns true if the specified magic number string like "ff d8 ?? e0" can be compiled
+ * and fits into SAIL_MAGIC_BUFFER_SIZE bytes.
+ */
+SAIL_HIDDEN bool is_valid_magic_number(const char *magic_number);
+
+/*
+ * Compiles the magic numbers of the specified codecs into a new table. The codecs must be
+ * already sorted by priority.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_magic_number_table(const struct sail_codec_bundle_node *codec_bundle_node,
+                                                   struct sail_magic_number_table **magic_number_table);
+
+SAIL_HIDDEN void destroy_magic_number_table(struct sail_magic_number_table *magic_number_table);
+
+/*
+ * Returns the codec info of the highest priority codec which magic number matches the specified
+ * buffer of SAIL_MAGIC_BUFFER_SIZE bytes, or NULL.
+ */
+SAIL_HIDDEN const struct sail_codec_info* find_codec_info_by_magic_number(const struct sail_magic_number_table *magic_number_table,
+                                                                          const unsigned char *buffer);
+
+#endif
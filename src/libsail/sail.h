@@ -37,15 +37,20 @@
     #include "codec_bundle_node_private.h"
     #include "codec_bundle_private.h"
     #include "codec_info.h"
+    #include "codec_info_index_private.h"
     #include "codec_info_private.h"
+    #include "codec_registry_cache_private.h"
     #include "codec_layout.h"
     #include "codec_priority.h"
     #include "context.h"
     #include "context_private.h"
     #include "ini.h"
+    #include "io_buffered.h"
     #include "io_file.h"
     #include "io_memory.h"
+    #include "io_mmap.h"
     #include "io_noop.h"
+    #include "magic_number_private.h"
     #include "sail_advanced.h"
     #include "sail_deep_diver.h"
     #include "sail_junior.h"
@@ -63,8 +68,10 @@
     #include <sail/codec_info.h>
     #include <sail/codec_priority.h>
     #include <sail/context.h>
+    #include <sail/io_buffered.h>
     #include <sail/io_file.h>
     #include <sail/io_memory.h>
+    #include <sail/io_mmap.h>
     #include <sail/io_noop.h>
     #include <sail/sail_advanced.h>
     #include <sail/sail_deep_diver.h>
@@ -164,6 +164,14 @@ sail_status_t sail_start_saving_into_memory(void *buffer, size_t buffer_length,
     return SAIL_OK;
 }
 
+sail_status_t sail_start_saving_into_growable_memory(void **buffer, size_t *buffer_length,
+                                                     const struct sail_codec_info *codec_info, void **state) {
+
+    SAIL_TRY(sail_start_saving_into_growable_memory_with_options(0, buffer, buffer_length, codec_info, NULL, state));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_write_next_frame(void *state, const struct sail_image *image) {
 
     SAIL_CHECK_PTR(state);
@@ -162,6 +162,29 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_file(const char *path, const st
 SAIL_EXPORT sail_status_t sail_start_saving_into_memory(void *buffer, size_t buffer_length,
                                                         const struct sail_codec_info *codec_info, void **state);
 
+/*
+ * Starts saving into a memory buffer allocated and grown by SAIL. Use it when the size
+ * of the encoded image is not known in advance.
+ *
+ * sail_stop_saving() assigns the encoded data to 'buffer' and its size to 'buffer_length'.
+ * The caller takes ownership of the data and must free it with sail_free(), even if saving
+ * failed. Both pointers must stay valid until saving is stopped.
+ *
+ * Typical usage: sail_codec_info_from_extension()          ->
+ *                sail_start_saving_into_growable_memory()  ->
+ *                sail_write_next_frame()                   ->
+ *                sail_stop_saving()                        ->
+ *                sail_free(buffer).
+ *
+ * STATE explanation: Passes the address of a local void* pointer. SAIL will store an internal state
+ * in it and destroy it in sail_stop_saving. States must be used per image. DO NOT use the same state
+ * to start saving multiple images at the same time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_growable_memory(void **buffer, size_t *buffer_length,
+                                                                 const struct sail_codec_info *codec_info, void **state);
+
 /*
  * Continues saving started by sail_start_saving_into_file() and brothers. Writes the specified
  * image into the underlying I/O target.
@@ -44,7 +44,7 @@ sail_status_t sail_start_loading_from_file_with_options(const char *path, const
     }
 
     struct sail_io *io;
-    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+    SAIL_TRY(alloc_io_read_file_or_mmap(path, &io));
 
     SAIL_TRY(start_loading_io_with_options(io, true, codec_info_local, load_options, state));
 
@@ -73,6 +73,50 @@ sail_status_t sail_start_loading_from_memory_with_options(const void *buffer, si
     return SAIL_OK;
 }
 
+sail_status_t sail_load_next_frame_into_buffer(void *state, void *buffer, size_t buffer_length, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(image);
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
+    SAIL_CHECK_PTR(state_of_mind->state);
+    SAIL_CHECK_PTR(state_of_mind->codec);
+
+    struct sail_image *image_local;
+    SAIL_TRY(state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image_local));
+
+    if (image_local->pixels != NULL) {
+        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", state_of_mind->codec_info->name);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
+
+    if (buffer_length < pixels_size) {
+        SAIL_LOG_ERROR("The buffer of %lu bytes is too small to hold %ux%u pixels. At least %lu bytes are required",
+                        (unsigned long)buffer_length, image_local->width, image_local->height, (unsigned long)pixels_size);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* Decode into the caller buffer. The buffer is not owned by the image. */
+    image_local->pixels = buffer;
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_frame(state_of_mind->state, image_local),
+                        /* cleanup */ image_local->pixels = NULL,
+                                      sail_destroy_image(image_local));
+
+    image_local->pixels = NULL;
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_start_saving_into_file_with_options(const char *path, const struct sail_codec_info *codec_info,
                                                        const struct sail_save_options *save_options, void **state) {
 
@@ -110,6 +154,22 @@ sail_status_t sail_start_saving_into_memory_with_options(void *buffer, size_t bu
     return SAIL_OK;
 }
 
+sail_status_t sail_start_saving_into_growable_memory_with_options(size_t size_hint, void **buffer, size_t *buffer_length,
+                                                                  const struct sail_codec_info *codec_info,
+                                                                  const struct sail_save_options *save_options, void **state) {
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(buffer_length);
+    SAIL_CHECK_PTR(codec_info);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_write_growable_memory(size_hint, buffer, buffer_length, &io));
+
+    /* The I/O object will be destroyed in this function. */
+    SAIL_TRY(start_saving_io_with_options(io, true, codec_info, save_options, state));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_stop_saving_with_written(void *state, size_t *written) {
 
     SAIL_TRY(stop_saving(state, written));
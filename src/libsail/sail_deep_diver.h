@@ -41,6 +41,7 @@ extern "C" {
 #endif
 
 struct sail_codec_info;
+struct sail_image;
 struct sail_io;
 struct sail_load_options;
 struct sail_save_options;
@@ -138,6 +139,55 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_memory_with_options(void *buffe
                                                                      const struct sail_codec_info *codec_info,
                                                                      const struct sail_save_options *save_options, void **state);
 
+/*
+ * Starts saving into a memory buffer allocated and grown by SAIL with the specified save options.
+ * If you do not need specific save options, just pass NULL. Codec-specific defaults will be used in this case.
+ * 'size_hint' is the number of bytes to preallocate, for example, the size of a previously encoded image.
+ * It may be 0.
+ *
+ * sail_stop_saving() assigns the encoded data to 'buffer' and its size to 'buffer_length'.
+ * The caller takes ownership of the data and must free it with sail_free(), even if saving
+ * failed. Both pointers must stay valid until saving is stopped.
+ *
+ * The save options are deep copied.
+ *
+ * Typical usage: sail_codec_info_from_extension()                      ->
+ *                sail_start_saving_into_growable_memory_with_options() ->
+ *                sail_write_next_frame()                               ->
+ *                sail_stop_saving()                                    ->
+ *                sail_free(buffer).
+ *
+ * STATE explanation: Passes the address of a local void* pointer. SAIL will store an internal state
+ * in it and destroy it in sail_stop_saving. States must be used per image. DO NOT use the same state
+ * to start saving multiple images at the same time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_growable_memory_with_options(size_t size_hint, void **buffer, size_t *buffer_length,
+                                                                              const struct sail_codec_info *codec_info,
+                                                                              const struct sail_save_options *save_options, void **state);
+
+/*
+ * Continues loading the file started by sail_start_loading_from_file() and brothers. Unlike sail_load_next_frame(),
+ * decodes the pixels into the specified caller-owned buffer instead of allocating a new one. This is useful
+ * to decode into pooled buffers, shared memory segments, or GPU staging areas without extra allocations.
+ *
+ * The buffer must be at least image->height * image->bytes_per_line bytes long. Use sail_probe_file() and brothers
+ * to know the image geometry beforehand. If the buffer is too small, no pixels are decoded and the loading
+ * cannot be continued. Just stop it with sail_stop_loading().
+ *
+ * The assigned image has its pixels field set to NULL as the pixels are stored in the buffer. The caller
+ * is still responsible for destroying the image with sail_destroy_image(). The buffer is never freed by SAIL.
+ *
+ * Typical usage: sail_start_loading_from_file()     ->
+ *                sail_load_next_frame_into_buffer() ->
+ *                sail_stop_loading().
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT when the buffer is too small to hold the frame.
+ */
+SAIL_EXPORT sail_status_t sail_load_next_frame_into_buffer(void *state, void *buffer, size_t buffer_length, struct sail_image **image);
 
 /*
  * Stops saving started by sail_start_saving_into_file() and brothers. Closes the underlying I/O target.
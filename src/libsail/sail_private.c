@@ -35,60 +35,87 @@ static void print_unsupported_write_pixel_format(enum SailPixelFormat pixel_form
                     sail_pixel_format_to_string(pixel_format));
 }
 
-static sail_status_t load_codec_by_codec_info_unsafe(const struct sail_codec_info *codec_info, const struct sail_codec **codec) {
+static struct sail_codec_bundle* find_codec_bundle(const struct sail_context *context, const struct sail_codec_info *codec_info) {
+
+    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        if (codec_bundle_node->codec_bundle->codec_info == codec_info) {
+            return codec_bundle_node->codec_bundle;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info, const struct sail_codec **codec) {
 
     SAIL_CHECK_PTR(codec_info);
     SAIL_CHECK_PTR(codec);
 
     struct sail_context *context;
-    SAIL_TRY(fetch_global_context_unsafe(&context));
+    SAIL_TRY(fetch_global_context_guarded(&context));
 
-    /* Find the codec in the cache. */
-    struct sail_codec_bundle *found_codec_bundle = NULL;
+    struct sail_codec_bundle *codec_bundle = find_codec_bundle(context, codec_info);
 
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
+    /* Something weird. The pointer to the codec info is not found in the cache. */
+    if (codec_bundle == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+    }
 
-        if (codec_bundle->codec_info == codec_info) {
-            if (codec_bundle->codec != NULL) {
-                *codec = codec_bundle->codec;
-                return SAIL_OK;
-            }
+    /* Fast path: the codec is already loaded. */
+    const struct sail_codec *loaded_codec = codec_bundle_loaded_codec(codec_bundle);
 
-            found_codec_bundle = codec_bundle_node->codec_bundle;
-            break;
-        }
+    if (SAIL_LIKELY(loaded_codec != NULL)) {
+        *codec = loaded_codec;
+        return SAIL_OK;
     }
 
-    /* Something weird. The pointer to the codec info is not found in the cache. */
-    if (found_codec_bundle == NULL) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
-    }
+    SAIL_TRY(lock_context());
+
+    /* Another thread could load the codec while we were waiting for the lock. */
+    if (codec_bundle->codec == NULL) {
+        /* Codecs are shared between threads like the context. */
+        sail_private_begin_global_allocation();
+
+        struct sail_codec *new_codec;
+        SAIL_TRY_OR_CLEANUP(alloc_and_load_codec(codec_bundle->codec_info, &new_codec),
+                            /* cleanup */ sail_private_end_global_allocation(),
+                                          unlock_context());
 
-    if (found_codec_bundle->codec == NULL) {
-        SAIL_TRY(alloc_and_load_codec(found_codec_bundle->codec_info, &found_codec_bundle->codec));
+        sail_private_end_global_allocation();
+
+        codec_bundle_publish_codec(codec_bundle, new_codec);
     }
 
-    *codec = found_codec_bundle->codec;
+    *codec = codec_bundle->codec;
+
+    SAIL_TRY(unlock_context());
 
     return SAIL_OK;
 }
 
-/*
- * Public functions.
- */
+sail_status_t alloc_io_read_file_or_mmap(const char *path, struct sail_io **io) {
 
-sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info, const struct sail_codec **codec) {
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(io);
 
-    SAIL_CHECK_PTR(codec_info);
-    SAIL_CHECK_PTR(codec);
+#ifdef SAIL_MMAP_IO_THRESHOLD
+    size_t file_size = 0;
+    SAIL_TRY(sail_file_size(path, &file_size));
 
-    SAIL_TRY(lock_context());
+    if (file_size >= SAIL_MMAP_IO_THRESHOLD) {
+        if (sail_alloc_io_read_mmap(path, io) == SAIL_OK) {
+            return SAIL_OK;
+        }
 
-    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info_unsafe(codec_info, codec),
-                        /* cleanup */ unlock_context());
+        SAIL_LOG_DEBUG("Failed to map '%s'. Falling back to file I/O", path);
+    }
+#endif
 
-    SAIL_TRY(unlock_context());
+    SAIL_TRY(sail_alloc_io_read_file(path, io));
 
     return SAIL_OK;
 }
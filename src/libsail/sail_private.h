@@ -41,6 +41,7 @@
 
 struct sail_codec_info;
 struct sail_codec;
+struct sail_io;
 struct sail_save_features;
 
 struct hidden_state {
@@ -65,6 +66,12 @@ struct hidden_state {
 SAIL_HIDDEN sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info,
                                                     const struct sail_codec **codec);
 
+/*
+ * Opens the specified file for reading. Maps the file into memory if it's large enough.
+ * Falls back to regular file I/O if mapping fails.
+ */
+SAIL_HIDDEN sail_status_t alloc_io_read_file_or_mmap(const char *path, struct sail_io **io);
+
 SAIL_HIDDEN void destroy_hidden_state(struct hidden_state *state);
 
 SAIL_HIDDEN sail_status_t stop_saving(void *state, size_t *written);
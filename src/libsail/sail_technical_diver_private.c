@@ -72,6 +72,21 @@ sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
 
     *state = NULL;
 
+#ifdef SAIL_IO_BUFFER_SIZE
+    /*
+     * Codecs tend to read files in tiny chunks. Memory and memory-mapped I/O are cheap enough,
+     * so read ahead from file and custom I/O sources only.
+     */
+    if (io->id != SAIL_MEMORY_IO_ID && io->id != SAIL_MMAP_IO_ID && io->id != SAIL_BUFFERED_IO_ID) {
+        struct sail_io *buffered_io;
+        SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_buffered(io, own_io, SAIL_IO_BUFFER_SIZE, &buffered_io),
+                            /* cleanup */ if (own_io) sail_destroy_io(io));
+
+        io     = buffered_io;
+        own_io = true;
+    }
+#endif
+
     void *ptr;
     SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct hidden_state), &ptr),
                         /* cleanup */ if (own_io) sail_destroy_io(io));
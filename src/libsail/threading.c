@@ -152,3 +152,21 @@ sail_status_t threading_destroy_mutex(sail_mutex_t *mutex)
     }
 #endif
 }
+
+void* threading_load_pointer_acquire(void * const *pointer)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return ReadPointerAcquire((PVOID const volatile *)pointer);
+#else
+    return __atomic_load_n(pointer, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void threading_store_pointer_release(void **pointer, void *value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    WritePointerRelease((PVOID volatile *)pointer, value);
+#else
+    __atomic_store_n(pointer, value, __ATOMIC_RELEASE);
+#endif
+}
@@ -78,4 +78,14 @@ SAIL_HIDDEN sail_status_t threading_unlock_mutex(sail_mutex_t *mutex);
 
 SAIL_HIDDEN sail_status_t threading_destroy_mutex(sail_mutex_t *mutex);
 
+/*
+ * Atomic pointers. A pointer stored with release semantics and then loaded with acquire
+ * semantics in another thread guarantees that the other thread sees all the writes made
+ * before the store.
+ */
+
+SAIL_HIDDEN void* threading_load_pointer_acquire(void * const *pointer);
+
+SAIL_HIDDEN void threading_store_pointer_release(void **pointer, void *value);
+
 #endif
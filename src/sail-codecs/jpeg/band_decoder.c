@@ -0,0 +1,518 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <jpeglib.h>
+#include <jerror.h>
+
+#include "sail-common.h"
+
+#include "band_decoder.h"
+#include "helpers.h"
+
+/* The number of scanlines passed to libjpeg per call. */
+#define BAND_BATCH_ROWS 16
+
+struct segment {
+    size_t offset;
+    size_t length;
+};
+
+struct jpeg_private_band_plan {
+    const unsigned char *data;
+
+    /* Markers up to and including SOS without APPn and COM. */
+    unsigned char *header;
+    size_t header_length;
+    /* Offset of the image height in the SOF marker in the header. */
+    size_t sof_height_offset;
+
+    /* Entropy-coded segments between RST markers. */
+    struct segment *segments;
+    unsigned segments_length;
+
+    /* The number of pixel rows every segment but the last one decodes into. */
+    unsigned rows_per_segment;
+
+    unsigned bands;
+};
+
+struct band_task {
+    const struct jpeg_private_band_plan *band_plan;
+    const struct jpeg_decompress_struct *decompress_context;
+    struct sail_image *image;
+};
+
+/*
+ * Private functions.
+ */
+
+static void memory_init_source(j_decompress_ptr cinfo) {
+    (void)cinfo;
+}
+
+/* Band streams are complete, so running out of data means a corrupted band. Insert a fake EOI. */
+static boolean memory_fill_input_buffer(j_decompress_ptr cinfo) {
+
+    static const JOCTET EOI_BUFFER[2] = { 0xFF, JPEG_EOI };
+
+    WARNMS(cinfo, JWRN_JPEG_EOF);
+
+    cinfo->src->next_input_byte = EOI_BUFFER;
+    cinfo->src->bytes_in_buffer = 2;
+
+    return TRUE;
+}
+
+static void memory_skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
+
+    struct jpeg_source_mgr *src = cinfo->src;
+
+    if (num_bytes <= 0) {
+        return;
+    }
+
+    while (num_bytes > (long)src->bytes_in_buffer) {
+        num_bytes -= (long)src->bytes_in_buffer;
+        (void)(*src->fill_input_buffer)(cinfo);
+    }
+
+    src->next_input_byte += (size_t)num_bytes;
+    src->bytes_in_buffer -= (size_t)num_bytes;
+}
+
+static void memory_term_source(j_decompress_ptr cinfo) {
+    (void)cinfo;
+}
+
+static void init_memory_source(struct jpeg_source_mgr *src, const unsigned char *data, size_t data_size) {
+
+    src->init_source       = memory_init_source;
+    src->fill_input_buffer = memory_fill_input_buffer;
+    src->skip_input_data   = memory_skip_input_data;
+    src->resync_to_restart = jpeg_resync_to_restart;
+    src->term_source       = memory_term_source;
+    src->next_input_byte   = data;
+    src->bytes_in_buffer   = data_size;
+}
+
+static unsigned read_be16(const unsigned char *data) {
+    return ((unsigned)data[0] << 8) | data[1];
+}
+
+/*
+ * Walks the markers up to SOS and copies them into 'header' if it's not NULL. Returns the header length
+ * and the offset of the entropy-coded data. Returns false if the stream is not a baseline Huffman JPEG.
+ */
+static bool parse_header(const unsigned char *data, size_t data_size, unsigned char *header,
+                         size_t *header_length, size_t *sof_height_offset, size_t *entropy_offset) {
+
+    if (data_size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+
+    if (header != NULL) {
+        header[0] = 0xFF;
+        header[1] = 0xD8;
+    }
+
+    size_t length_local = 2;
+    bool sof_found = false;
+    size_t pos = 2;
+
+    for (;;) {
+        if (pos >= data_size || data[pos] != 0xFF) {
+            return false;
+        }
+
+        /* Skip fill bytes. */
+        while (pos < data_size && data[pos] == 0xFF) {
+            pos++;
+        }
+
+        if (pos + 3 > data_size) {
+            return false;
+        }
+
+        const unsigned marker = data[pos++];
+
+        /* Standalone markers are not expected before SOS. */
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) {
+            return false;
+        }
+
+        const size_t length = read_be16(data + pos);
+
+        if (length < 2 || pos + length > data_size) {
+            return false;
+        }
+
+        /* Only baseline and extended sequential Huffman frames. */
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            if ((marker != 0xC0 && marker != 0xC1) || length < 8) {
+                return false;
+            }
+
+            *sof_height_offset = length_local + 5;
+            sof_found = true;
+        }
+
+        /* Bands don't need application data and comments. Keep the Adobe marker with the color transform. */
+        const bool skip = ((marker >= 0xE0 && marker <= 0xEF) && marker != 0xEE) || marker == 0xFE;
+
+        if (!skip) {
+            if (header != NULL) {
+                header[length_local]     = 0xFF;
+                header[length_local + 1] = (unsigned char)marker;
+                memcpy(header + length_local + 2, data + pos, length);
+            }
+
+            length_local += 2 + length;
+        }
+
+        pos += length;
+
+        if (marker == 0xDA) {
+            break;
+        }
+    }
+
+    *header_length  = length_local;
+    *entropy_offset = pos;
+
+    return sof_found;
+}
+
+/* Splits the entropy-coded data at RST markers. Returns false if the scan is not followed by EOI. */
+static sail_status_t split_segments(struct jpeg_private_band_plan *band_plan, size_t data_size, size_t entropy_offset,
+                                    unsigned expected_segments, bool *split) {
+
+    *split = false;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct segment) * expected_segments, &ptr));
+    band_plan->segments = ptr;
+
+    const unsigned char *data = band_plan->data;
+    size_t segment_start = entropy_offset;
+    size_t pos = entropy_offset;
+
+    for (;;) {
+        const unsigned char *ff = memchr(data + pos, 0xFF, data_size - pos);
+
+        if (ff == NULL || (size_t)(ff - data) + 1 >= data_size) {
+            /* Truncated file. Let the serial decoder deal with it. */
+            return SAIL_OK;
+        }
+
+        pos = (size_t)(ff - data);
+        const unsigned byte = data[pos + 1];
+
+        if (byte == 0x00) {
+            /* Stuffed byte. */
+            pos += 2;
+            continue;
+        } else if (byte == 0xFF) {
+            /* Fill byte. */
+            pos++;
+            continue;
+        }
+
+        if (band_plan->segments_length == expected_segments) {
+            return SAIL_OK;
+        }
+
+        band_plan->segments[band_plan->segments_length].offset = segment_start;
+        band_plan->segments[band_plan->segments_length].length = pos - segment_start;
+        band_plan->segments_length++;
+
+        if (byte >= 0xD0 && byte <= 0xD7) {
+            pos += 2;
+            segment_start = pos;
+        } else {
+            /* Multiple scans are not supported. */
+            *split = (byte == 0xD9 && band_plan->segments_length == expected_segments);
+            return SAIL_OK;
+        }
+    }
+}
+
+/* Builds a standalone JPEG from the segments in the range [first, last). */
+static sail_status_t build_band_stream(const struct jpeg_private_band_plan *band_plan, unsigned first, unsigned last,
+                                       unsigned height, unsigned char **stream, size_t *stream_length) {
+
+    size_t length = band_plan->header_length + 2 /* EOI */;
+
+    for (unsigned i = first; i < last; i++) {
+        length += band_plan->segments[i].length + 2 /* RST */;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(length, &ptr));
+    unsigned char *output = ptr;
+
+    memcpy(output, band_plan->header, band_plan->header_length);
+    output[band_plan->sof_height_offset]     = (unsigned char)(height >> 8);
+    output[band_plan->sof_height_offset + 1] = (unsigned char)(height & 0xFF);
+
+    size_t pos = band_plan->header_length;
+
+    for (unsigned i = first; i < last; i++) {
+        /* Restart markers are numbered from RST0 in every band. */
+        if (i > first) {
+            output[pos++] = 0xFF;
+            output[pos++] = (unsigned char)(0xD0 + ((i - first - 1) & 7));
+        }
+
+        memcpy(output + pos, band_plan->data + band_plan->segments[i].offset, band_plan->segments[i].length);
+        pos += band_plan->segments[i].length;
+    }
+
+    output[pos++] = 0xFF;
+    output[pos++] = 0xD9;
+
+    *stream        = output;
+    *stream_length = pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t decode_band(unsigned band, void *user_data) {
+
+    const struct band_task *band_task = user_data;
+    const struct jpeg_private_band_plan *band_plan = band_task->band_plan;
+    const struct jpeg_decompress_struct *main_context = band_task->decompress_context;
+    struct sail_image *image = band_task->image;
+
+    /* Segments of this band plus one segment of context on every side. */
+    const unsigned first_segment = (unsigned)((unsigned long long)band * band_plan->segments_length / band_plan->bands);
+    const unsigned last_segment  = (unsigned)((unsigned long long)(band + 1) * band_plan->segments_length / band_plan->bands);
+
+    const unsigned first_decoded_segment = first_segment > 0 ? first_segment - 1 : 0;
+    const unsigned last_decoded_segment  = last_segment < band_plan->segments_length ? last_segment + 1 : last_segment;
+
+    const unsigned first_decoded_row = first_decoded_segment * band_plan->rows_per_segment;
+    const unsigned first_row         = first_segment * band_plan->rows_per_segment;
+    const unsigned last_row          = SAIL_MIN(last_segment * band_plan->rows_per_segment, image->height);
+    const unsigned decoded_height    = SAIL_MIN(last_decoded_segment * band_plan->rows_per_segment, image->height) - first_decoded_row;
+
+    unsigned char *stream;
+    size_t stream_length;
+    SAIL_TRY(build_band_stream(band_plan, first_decoded_segment, last_decoded_segment, decoded_height, &stream, &stream_length));
+
+    /* Context rows are decoded into a scratch row and dropped. */
+    void *scratch_row;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(image->bytes_per_line, &scratch_row),
+                        /* cleanup */ sail_free(stream));
+
+    struct jpeg_decompress_struct decompress_context;
+    struct jpeg_private_my_error_context error_context;
+    struct jpeg_source_mgr source_manager;
+
+    memset(&decompress_context, 0, sizeof(decompress_context));
+
+    decompress_context.err = jpeg_std_error(&error_context.jpeg_error_mgr);
+    error_context.jpeg_error_mgr.error_exit = jpeg_private_my_error_exit;
+    error_context.jpeg_error_mgr.output_message = jpeg_private_my_output_message;
+
+    if (setjmp(error_context.setjmp_buffer) != 0) {
+        jpeg_destroy_decompress(&decompress_context);
+        sail_free(scratch_row);
+        sail_free(stream);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpeg_create_decompress(&decompress_context);
+    init_memory_source(&source_manager, stream, stream_length);
+    decompress_context.src = &source_manager;
+    jpeg_read_header(&decompress_context, true);
+
+    decompress_context.jpeg_color_space    = main_context->jpeg_color_space;
+    decompress_context.out_color_space     = main_context->out_color_space;
+    decompress_context.dct_method          = main_context->dct_method;
+    decompress_context.do_fancy_upsampling = main_context->do_fancy_upsampling;
+    decompress_context.do_block_smoothing  = main_context->do_block_smoothing;
+    decompress_context.quantize_colors     = false;
+
+    jpeg_start_decompress(&decompress_context);
+
+    if (decompress_context.output_width != image->width || decompress_context.output_height != decoded_height) {
+        SAIL_LOG_ERROR("JPEG: Band %u has unexpected dimensions", band);
+        jpeg_destroy_decompress(&decompress_context);
+        sail_free(scratch_row);
+        sail_free(stream);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    JSAMPROW samprows[BAND_BATCH_ROWS];
+    const unsigned rows_to_decode = (last_row - first_row) + (first_row - first_decoded_row);
+
+    for (unsigned row = 0; row < rows_to_decode;) {
+        const unsigned rows_to_read = SAIL_MIN(rows_to_decode - row, BAND_BATCH_ROWS);
+
+        for (unsigned i = 0; i < rows_to_read; i++) {
+            const unsigned image_row = first_decoded_row + row + i;
+
+            samprows[i] = (image_row < first_row)
+                            ? (JSAMPROW)scratch_row
+                            : (JSAMPROW)((unsigned char *)image->pixels + (size_t)image_row * image->bytes_per_line);
+        }
+
+        const JDIMENSION rows_read = jpeg_read_scanlines(&decompress_context, samprows, rows_to_read);
+
+        if (rows_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scanlines");
+            jpeg_destroy_decompress(&decompress_context);
+            sail_free(scratch_row);
+            sail_free(stream);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += rows_read;
+    }
+
+    /* The bottom context rows are not needed. */
+    jpeg_abort_decompress(&decompress_context);
+    jpeg_destroy_decompress(&decompress_context);
+
+    sail_free(scratch_row);
+    sail_free(stream);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t jpeg_private_alloc_band_plan(const struct jpeg_decompress_struct *decompress_context,
+                                            const void *data, size_t data_size,
+                                            unsigned threads,
+                                            struct jpeg_private_band_plan **band_plan) {
+
+    SAIL_CHECK_PTR(decompress_context);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(band_plan);
+
+    *band_plan = NULL;
+
+    /* Single interleaved baseline scan, restarts aligned to MCU rows, no scaling. */
+    if (decompress_context->progressive_mode ||
+            decompress_context->arith_code ||
+            decompress_context->restart_interval == 0 ||
+            decompress_context->comps_in_scan != decompress_context->num_components ||
+            decompress_context->MCUs_per_row == 0 ||
+            decompress_context->restart_interval % decompress_context->MCUs_per_row != 0 ||
+            decompress_context->output_width != decompress_context->image_width ||
+            decompress_context->output_height != decompress_context->image_height) {
+        SAIL_LOG_DEBUG("JPEG: The image is not suitable for parallel decoding");
+        return SAIL_OK;
+    }
+
+    const unsigned mcu_rows_per_segment = decompress_context->restart_interval / decompress_context->MCUs_per_row;
+    const unsigned expected_segments = (decompress_context->MCU_rows_in_scan + mcu_rows_per_segment - 1) / mcu_rows_per_segment;
+
+    if (expected_segments < 2) {
+        return SAIL_OK;
+    }
+
+    /* Pixel rows per MCU row. */
+    const unsigned mcu_height = (decompress_context->comps_in_scan == 1)
+                                    ? DCTSIZE * decompress_context->max_v_samp_factor / decompress_context->comp_info[0].v_samp_factor
+                                    : DCTSIZE * decompress_context->max_v_samp_factor;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct jpeg_private_band_plan), &ptr));
+    struct jpeg_private_band_plan *band_plan_local = ptr;
+
+    band_plan_local->data              = data;
+    band_plan_local->header            = NULL;
+    band_plan_local->header_length     = 0;
+    band_plan_local->sof_height_offset = 0;
+    band_plan_local->segments          = NULL;
+    band_plan_local->segments_length   = 0;
+    band_plan_local->rows_per_segment  = mcu_rows_per_segment * mcu_height;
+    band_plan_local->bands             = SAIL_MIN(threads, expected_segments);
+
+    /* Measure the markers first, so the header buffer is not larger than the markers up to SOS. */
+    size_t entropy_offset;
+    if (!parse_header(data, data_size, NULL, &band_plan_local->header_length, &band_plan_local->sof_height_offset, &entropy_offset)) {
+        SAIL_LOG_DEBUG("JPEG: Failed to parse the markers for parallel decoding");
+        jpeg_private_destroy_band_plan(band_plan_local);
+        return SAIL_OK;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(band_plan_local->header_length, &ptr),
+                        /* cleanup */ jpeg_private_destroy_band_plan(band_plan_local));
+    band_plan_local->header = ptr;
+
+    parse_header(data, data_size, band_plan_local->header, &band_plan_local->header_length, &band_plan_local->sof_height_offset, &entropy_offset);
+
+    bool split;
+    SAIL_TRY_OR_CLEANUP(split_segments(band_plan_local, data_size, entropy_offset, expected_segments, &split),
+                        /* cleanup */ jpeg_private_destroy_band_plan(band_plan_local));
+
+    if (!split) {
+        SAIL_LOG_DEBUG("JPEG: Failed to split the image into restart segments");
+        jpeg_private_destroy_band_plan(band_plan_local);
+        return SAIL_OK;
+    }
+
+    SAIL_LOG_DEBUG("JPEG: Decoding %u restart segments in %u bands", band_plan_local->segments_length, band_plan_local->bands);
+
+    *band_plan = band_plan_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t jpeg_private_decode_bands(const struct jpeg_private_band_plan *band_plan,
+                                         const struct jpeg_decompress_struct *decompress_context,
+                                         struct sail_image *image) {
+
+    SAIL_CHECK_PTR(band_plan);
+    SAIL_CHECK_PTR(decompress_context);
+    SAIL_CHECK_PTR(image);
+
+    struct band_task band_task = { band_plan, decompress_context, image };
+
+    SAIL_TRY(sail_parallel_for(band_plan->bands, band_plan->bands, decode_band, &band_task));
+
+    return SAIL_OK;
+}
+
+void jpeg_private_destroy_band_plan(struct jpeg_private_band_plan *band_plan) {
+
+    if (band_plan == NULL) {
+        return;
+    }
+
+    sail_free(band_plan->header);
+    sail_free(band_plan->segments);
+    sail_free(band_plan);
+}
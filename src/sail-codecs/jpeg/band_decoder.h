@@ -0,0 +1,76 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_BAND_DECODER_H
+#define SAIL_JPEG_BAND_DECODER_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <jpeglib.h>
+
+#include "common.h"
+#include "error.h"
+#include "export.h"
+
+struct sail_image;
+
+/*
+ * Parallel decoding of baseline JPEGs with restart markers.
+ *
+ * The entropy-coded data is split at RST markers into horizontal bands. Every band is repacked
+ * into a standalone JPEG with the original tables and decoded with its own libjpeg context
+ * on a separate thread. Bands are decoded with one extra restart segment above and below,
+ * so chroma upsampling at band edges sees the same neighbours as in serial decoding,
+ * and the output is identical.
+ */
+struct jpeg_private_band_plan;
+
+/*
+ * Checks if the image that is being decoded with the specified context can be decoded in bands.
+ * 'data' must hold the whole JPEG file and stay valid until the plan is destroyed.
+ * Assigns NULL to the plan if the image is not suitable, for example, if it has no restart
+ * markers, is progressive, or is scaled.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_alloc_band_plan(const struct jpeg_decompress_struct *decompress_context,
+                                                        const void *data, size_t data_size,
+                                                        unsigned threads,
+                                                        struct jpeg_private_band_plan **band_plan);
+
+/*
+ * Decodes all the bands into the image pixels on up to the planned number of threads.
+ * The decoding parameters like the output color space and DCT method are taken from the specified context.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_decode_bands(const struct jpeg_private_band_plan *band_plan,
+                                                     const struct jpeg_decompress_struct *decompress_context,
+                                                     struct sail_image *image);
+
+SAIL_HIDDEN void jpeg_private_destroy_band_plan(struct jpeg_private_band_plan *band_plan);
+
+#endif
@@ -63,6 +63,11 @@ enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLOR_SPACE colo
         case JCS_EXT_BGRA:  return SAIL_PIXEL_FORMAT_BPP32_BGRA;
         case JCS_EXT_ABGR:  return SAIL_PIXEL_FORMAT_BPP32_ABGR;
         case JCS_EXT_ARGB:  return SAIL_PIXEL_FORMAT_BPP32_ARGB;
+
+        case JCS_EXT_RGBX:  return SAIL_PIXEL_FORMAT_BPP32_RGBX;
+        case JCS_EXT_BGRX:  return SAIL_PIXEL_FORMAT_BPP32_BGRX;
+        case JCS_EXT_XRGB:  return SAIL_PIXEL_FORMAT_BPP32_XRGB;
+        case JCS_EXT_XBGR:  return SAIL_PIXEL_FORMAT_BPP32_XBGR;
 #endif
 
         case JCS_YCbCr:     return SAIL_PIXEL_FORMAT_BPP24_YCBCR;
@@ -96,6 +101,62 @@ J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixe
     }
 }
 
+J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format) {
+
+    J_COLOR_SPACE color_space;
+
+    switch (pixel_format) {
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: color_space = JCS_EXT_RGBX; break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: color_space = JCS_EXT_BGRX; break;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB: color_space = JCS_EXT_XRGB; break;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR: color_space = JCS_EXT_XBGR; break;
+#endif
+        default: color_space = jpeg_private_pixel_format_to_color_space(pixel_format); break;
+    }
+
+    /* Color conversions supported by the decompressor. */
+    switch (jpeg_color_space) {
+        case JCS_GRAYSCALE:
+        case JCS_YCbCr:
+        case JCS_RGB: {
+            switch (color_space) {
+                case JCS_GRAYSCALE:
+                case JCS_RGB:
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+                case JCS_RGB565:
+                case JCS_EXT_RGB:
+                case JCS_EXT_BGR:
+                case JCS_EXT_RGBA:
+                case JCS_EXT_BGRA:
+                case JCS_EXT_ABGR:
+                case JCS_EXT_ARGB:
+                case JCS_EXT_RGBX:
+                case JCS_EXT_BGRX:
+                case JCS_EXT_XRGB:
+                case JCS_EXT_XBGR:
+#endif
+                {
+                    return color_space;
+                }
+                case JCS_YCbCr: {
+                    return (jpeg_color_space == JCS_YCbCr) ? color_space : JCS_UNKNOWN;
+                }
+                default: {
+                    return JCS_UNKNOWN;
+                }
+            }
+        }
+        case JCS_CMYK:
+        case JCS_YCCK: {
+            return (color_space == JCS_CMYK || color_space == jpeg_color_space) ? color_space : JCS_UNKNOWN;
+        }
+        default: {
+            return JCS_UNKNOWN;
+        }
+    }
+}
+
 sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node) {
 
     SAIL_CHECK_PTR(last_meta_data_node);
@@ -219,25 +280,121 @@ sail_status_t jpeg_private_write_resolution(struct jpeg_compress_struct *compres
     return SAIL_OK;
 }
 
-bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+/* Leaves the DCT method untouched if the variant holds an unknown value. */
+static void dct_method_from_variant(const struct sail_variant *value, J_DCT_METHOD *dct_method) {
+
+    if (value->type == SAIL_VARIANT_TYPE_STRING) {
+        const char *str_value = sail_variant_to_string(value);
+
+        if (strcmp(str_value, "slow") == 0) {
+            SAIL_LOG_TRACE("JPEG: Applying SLOW DCT method");
+            *dct_method = JDCT_ISLOW;
+        } else if (strcmp(str_value, "fast") == 0) {
+            SAIL_LOG_TRACE("JPEG: Applying FAST DCT method");
+            *dct_method = JDCT_IFAST;
+        } else if (strcmp(str_value, "float") == 0) {
+            SAIL_LOG_TRACE("JPEG: Applying FLOAT DCT method");
+            *dct_method = JDCT_FLOAT;
+        }
+    }
+}
+
+/* Returns 0 if the variant doesn't hold a positive integer. */
+static unsigned variant_to_positive_unsigned(const struct sail_variant *value) {
 
-    struct jpeg_compress_struct *compress_context = user_data;
+    switch (value->type) {
+        case SAIL_VARIANT_TYPE_UNSIGNED_INT: {
+            return sail_variant_to_unsigned_int(value);
+        }
+        case SAIL_VARIANT_TYPE_INT: {
+            const int int_value = sail_variant_to_int(value);
+            return int_value > 0 ? (unsigned)int_value : 0;
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
+/*
+ * libjpeg decodes at 1/1, 1/2, 1/4, or 1/8 of the size by skipping the high frequency DCT
+ * coefficients which is much cheaper than decoding at full size and downscaling.
+ * When several scales are requested, the smaller output wins.
+ */
+static void apply_scale_denominator(struct jpeg_decompress_struct *decompress_context, unsigned scale_denom) {
+
+    if (scale_denom > 1 && scale_denom * decompress_context->scale_num > decompress_context->scale_denom) {
+        SAIL_LOG_TRACE("JPEG: Scaling the image down by %u", scale_denom);
+        decompress_context->scale_num   = 1;
+        decompress_context->scale_denom = scale_denom;
+    }
+}
+
+bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct jpeg_decompress_struct *decompress_context = user_data;
 
     if (strcmp(key, "jpeg-dct-method") == 0) {
-        if (value->type == SAIL_VARIANT_TYPE_STRING) {
-            const char *str_value = sail_variant_to_string(value);
-
-            if (strcmp(str_value, "slow") == 0) {
-                SAIL_LOG_TRACE("JPEG: Applying SLOW DCT method");
-                compress_context->dct_method = JDCT_ISLOW;
-            } else if (strcmp(str_value, "fast") == 0) {
-                SAIL_LOG_TRACE("JPEG: Applying FAST DCT method");
-                compress_context->dct_method = JDCT_IFAST;
-            } else if (strcmp(str_value, "float") == 0) {
-                SAIL_LOG_TRACE("JPEG: Applying FLOAT DCT method");
-                compress_context->dct_method = JDCT_FLOAT;
+        dct_method_from_variant(value, &decompress_context->dct_method);
+    } else if (strcmp(key, "jpeg-fancy-upsampling") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            SAIL_LOG_TRACE("JPEG: Fancy upsampling: %s", sail_variant_to_bool(value) ? "yes" : "no");
+            decompress_context->do_fancy_upsampling = sail_variant_to_bool(value);
+        }
+    } else if (strcmp(key, "jpeg-block-smoothing") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            SAIL_LOG_TRACE("JPEG: Block smoothing: %s", sail_variant_to_bool(value) ? "yes" : "no");
+            decompress_context->do_block_smoothing = sail_variant_to_bool(value);
+        }
+    } else if (strcmp(key, "jpeg-scale-denominator") == 0) {
+        const unsigned scale_denom = variant_to_positive_unsigned(value);
+
+        if (scale_denom == 1 || scale_denom == 2 || scale_denom == 4 || scale_denom == 8) {
+            apply_scale_denominator(decompress_context, scale_denom);
+        } else {
+            SAIL_LOG_WARNING("JPEG: Ignoring unsupported scale denominator. Possible values: 1, 2, 4, 8");
+        }
+    } else if (strcmp(key, "jpeg-max-dimension") == 0) {
+        const unsigned max_dimension = variant_to_positive_unsigned(value);
+
+        if (max_dimension > 0) {
+            const unsigned image_dimension = decompress_context->image_width > decompress_context->image_height
+                                                ? decompress_context->image_width
+                                                : decompress_context->image_height;
+
+            /* Pick the largest denominator that still keeps the larger side at least max_dimension pixels. */
+            unsigned scale_denom = 1;
+
+            while (scale_denom < 8 && (image_dimension + scale_denom * 2 - 1) / (scale_denom * 2) >= max_dimension) {
+                scale_denom *= 2;
             }
+
+            apply_scale_denominator(decompress_context, scale_denom);
         }
+    }
+
+    return true;
+}
+
+unsigned jpeg_private_load_threads(const struct sail_hash_map *tuning) {
+
+    const struct sail_variant *value = (tuning != NULL) ? sail_hash_map_value(tuning, "jpeg-threads") : NULL;
+    const unsigned threads = (value != NULL) ? variant_to_positive_unsigned(value) : 0;
+
+    if (threads > 0) {
+        SAIL_LOG_TRACE("JPEG: Threads: %u", threads);
+        return threads;
+    }
+
+    return 1;
+}
+
+bool jpeg_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct jpeg_compress_struct *compress_context = user_data;
+
+    if (strcmp(key, "jpeg-dct-method") == 0) {
+        dct_method_from_variant(value, &compress_context->dct_method);
     } else if (strcmp(key, "jpeg-optimize-coding") == 0) {
         if (value->type == SAIL_VARIANT_TYPE_BOOL) {
             const bool optimize_coding = sail_variant_to_bool(value);
@@ -252,6 +409,13 @@ bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_v
             SAIL_LOG_TRACE("JPEG: Smoothing the image");
             compress_context->smoothing_factor = sail_variant_to_unsigned_int(value);
         }
+    } else if (strcmp(key, "jpeg-restart-rows") == 0) {
+        const unsigned restart_rows = variant_to_positive_unsigned(value);
+
+        if (restart_rows > 0 && restart_rows <= 65535) {
+            SAIL_LOG_TRACE("JPEG: Restart interval: %u MCU rows", restart_rows);
+            compress_context->restart_in_rows = (int)restart_rows;
+        }
     }
 
     return true;
@@ -35,6 +35,7 @@
 #include "common.h"
 #include "export.h"
 
+struct sail_hash_map;
 struct sail_meta_data_node;
 struct sail_resolution;
 
@@ -51,6 +52,12 @@ SAIL_HIDDEN enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLO
 
 SAIL_HIDDEN J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixel_format);
 
+/*
+ * Returns the color space to decode images in 'jpeg_color_space' into to output 'pixel_format',
+ * or JCS_UNKNOWN if the decompressor cannot do that.
+ */
+SAIL_HIDDEN J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format);
+
 SAIL_HIDDEN sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node);
 
 SAIL_HIDDEN sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node);
@@ -63,6 +70,14 @@ SAIL_HIDDEN sail_status_t jpeg_private_fetch_resolution(struct jpeg_decompress_s
 
 SAIL_HIDDEN sail_status_t jpeg_private_write_resolution(struct jpeg_compress_struct *compress_context, const struct sail_resolution *resolution);
 
-SAIL_HIDDEN bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+SAIL_HIDDEN bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+/*
+ * Returns the number of threads to decode the image with based on the "jpeg-threads" tuning key.
+ * Parallel decoding is opt-in, so 1 is returned without the key.
+ */
+SAIL_HIDDEN unsigned jpeg_private_load_threads(const struct sail_hash_map *tuning);
+
+SAIL_HIDDEN bool jpeg_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
 
 #endif
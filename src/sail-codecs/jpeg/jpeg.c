@@ -33,6 +33,7 @@
 
 #include "sail-common.h"
 
+#include "band_decoder.h"
 #include "helpers.h"
 #include "io_dest.h"
 #include "io_src.h"
@@ -45,6 +46,13 @@ static const double COMPRESSION_MIN     = 0;
 static const double COMPRESSION_MAX     = 100;
 static const double COMPRESSION_DEFAULT = 15;
 
+/*
+ * The number of scanlines passed to libjpeg per call. Covers a whole iMCU row
+ * of common 2x2 subsampled images, so libjpeg can upsample full row groups
+ * straight into the image instead of buffering them.
+ */
+#define JPEG_BATCH_ROWS 16
+
 /*
  * Codec-specific state.
  */
@@ -59,6 +67,9 @@ struct jpeg_state {
     bool frame_loaded;
     bool frame_saved;
     bool started_compress;
+
+    /* Not NULL when the image is decoded in parallel bands. */
+    struct jpeg_private_band_plan *band_plan;
 };
 
 static sail_status_t alloc_jpeg_state(struct jpeg_state **jpeg_state) {
@@ -75,6 +86,7 @@ static sail_status_t alloc_jpeg_state(struct jpeg_state **jpeg_state) {
     (*jpeg_state)->frame_loaded       = false;
     (*jpeg_state)->frame_saved        = false;
     (*jpeg_state)->started_compress   = false;
+    (*jpeg_state)->band_plan          = NULL;
 
     return SAIL_OK;
 }
@@ -88,6 +100,8 @@ static void destroy_jpeg_state(struct jpeg_state *jpeg_state) {
     sail_free(jpeg_state->decompress_context);
     sail_free(jpeg_state->compress_context);
 
+    jpeg_private_destroy_band_plan(jpeg_state->band_plan);
+
     sail_destroy_load_options(jpeg_state->load_options);
     sail_destroy_save_options(jpeg_state->save_options);
 
@@ -116,6 +130,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
     SAIL_TRY(sail_malloc(sizeof(struct jpeg_decompress_struct), &ptr));
     jpeg_state->decompress_context = ptr;
 
+    /* Borrow the whole file before libjpeg starts reading it. Needed for parallel decoding. */
+    const void *data = NULL;
+    size_t data_size = 0;
+
+    if (io->features & SAIL_IO_FEATURE_BORROWABLE) {
+        if (io->borrow(io->stream, &data, &data_size) != SAIL_OK) {
+            data = NULL;
+        }
+    }
+
     /* Error handling setup. */
     jpeg_state->decompress_context->err = jpeg_std_error(&jpeg_state->error_context.jpeg_error_mgr);
     jpeg_state->error_context.jpeg_error_mgr.error_exit = jpeg_private_my_error_exit;
@@ -146,12 +170,41 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
         jpeg_state->decompress_context->out_color_space = jpeg_state->decompress_context->jpeg_color_space;
     }
 
+    /* Decode directly into the requested output pixel format if possible. */
+    if (jpeg_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        const J_COLOR_SPACE output_color_space = jpeg_private_output_color_space(jpeg_state->decompress_context->jpeg_color_space,
+                                                                                 jpeg_state->load_options->output_pixel_format);
+
+        if (output_color_space == JCS_UNKNOWN) {
+            SAIL_LOG_TRACE("JPEG: Cannot output %s pixels, falling back to the native pixel format",
+                            sail_pixel_format_to_string(jpeg_state->load_options->output_pixel_format));
+        } else {
+            jpeg_state->decompress_context->out_color_space = output_color_space;
+        }
+    }
+
     /* We don't want colormapped output. */
     jpeg_state->decompress_context->quantize_colors = false;
 
+    /* Handle tuning. */
+    if (jpeg_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpeg_state->load_options->tuning, jpeg_private_load_tuning_key_value_callback, jpeg_state->decompress_context);
+    }
+
     /* Launch decompression! */
     jpeg_start_decompress(jpeg_state->decompress_context);
 
+    /*
+     * Decode in parallel bands when requested, the whole file is in memory, and it has restart markers.
+     * Any failure to plan the bands falls back to serial decoding.
+     */
+    const unsigned threads = jpeg_private_load_threads(jpeg_state->load_options->tuning);
+
+    if (threads > 1 && data != NULL) {
+        SAIL_TRY_OR_EXECUTE(jpeg_private_alloc_band_plan(jpeg_state->decompress_context, data, data_size, threads, &jpeg_state->band_plan),
+                            /* on error */ SAIL_LOG_DEBUG("JPEG: Failed to plan parallel decoding. Decoding serially"));
+    }
+
     return SAIL_OK;
 }
 
@@ -220,11 +273,28 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        unsigned char *scanline = (unsigned char *)image->pixels + row * image->bytes_per_line;
+    if (jpeg_state->band_plan != NULL) {
+        SAIL_TRY(jpeg_private_decode_bands(jpeg_state->band_plan, jpeg_state->decompress_context, image));
+        return SAIL_OK;
+    }
+
+    JSAMPROW samprows[JPEG_BATCH_ROWS];
+
+    for (unsigned row = 0; row < image->height;) {
+        const unsigned rows_to_read = (image->height - row < JPEG_BATCH_ROWS) ? image->height - row : JPEG_BATCH_ROWS;
 
-        JSAMPROW samprow = (JSAMPROW)scanline;
-        (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+        for (unsigned i = 0; i < rows_to_read; i++) {
+            samprows[i] = (JSAMPROW)((unsigned char *)image->pixels + (size_t)(row + i) * image->bytes_per_line);
+        }
+
+        const JDIMENSION rows_read = jpeg_read_scanlines(jpeg_state->decompress_context, samprows, rows_to_read);
+
+        if (rows_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scanlines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += rows_read;
     }
 
     return SAIL_OK;
@@ -341,7 +411,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_jpeg(void *state, c
 
     /* Handle tuning. */
     if (jpeg_state->save_options->tuning != NULL) {
-        sail_traverse_hash_map_with_user_data(jpeg_state->save_options->tuning, jpeg_private_tuning_key_value_callback, jpeg_state->compress_context);
+        sail_traverse_hash_map_with_user_data(jpeg_state->save_options->tuning, jpeg_private_save_tuning_key_value_callback, jpeg_state->compress_context);
     }
 
     /* Start compression. */
@@ -378,9 +448,23 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_jpeg(void *state, const struc
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        JSAMPROW samprow = (JSAMPROW)((const unsigned char *)image->pixels + row * image->bytes_per_line);
-        jpeg_write_scanlines(jpeg_state->compress_context, &samprow, 1);
+    JSAMPROW samprows[JPEG_BATCH_ROWS];
+
+    for (unsigned row = 0; row < image->height;) {
+        const unsigned rows_to_write = (image->height - row < JPEG_BATCH_ROWS) ? image->height - row : JPEG_BATCH_ROWS;
+
+        for (unsigned i = 0; i < rows_to_write; i++) {
+            samprows[i] = (JSAMPROW)((const unsigned char *)image->pixels + (size_t)(row + i) * image->bytes_per_line);
+        }
+
+        const JDIMENSION rows_written = jpeg_write_scanlines(jpeg_state->compress_context, samprows, rows_to_write);
+
+        if (rows_written == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to write scanlines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += rows_written;
     }
 
     return SAIL_OK;
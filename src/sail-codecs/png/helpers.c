@@ -109,10 +109,10 @@ static sail_status_t hex_string_to_meta_data_node(const char *hex_str, enum Sail
                         /* cleanup */ sail_free(data));
     SAIL_TRY_OR_CLEANUP(sail_alloc_variant(&meta_data_node_local->meta_data->value),
                         /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local),
-                                      free(data));
+                                      sail_free(data));
     SAIL_TRY_OR_CLEANUP(sail_set_variant_data(meta_data_node_local->meta_data->value, data, data_size),
                         /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local),
-                                      free(data));
+                                      sail_free(data));
 
     meta_data_node_local->meta_data->key = key;
 
@@ -374,9 +374,9 @@ sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_pt
         png_text *lines = ptr;
 
         /* Indexes in 'lines' that must be freed. 1 = free, 0 = don't free. */
-        SAIL_TRY(sail_malloc(count * sizeof(bool), &ptr));
+        SAIL_TRY(sail_malloc(count * sizeof(int), &ptr));
         int *lines_to_free = ptr;
-        memset(lines_to_free, 0, count);
+        memset(lines_to_free, 0, count * sizeof(int));
 
         unsigned index = 0;
 
@@ -692,6 +692,84 @@ sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_p
     return SAIL_OK;
 }
 
+bool png_private_set_output_pixel_format(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format) {
+
+    bool want_alpha;
+    bool alpha_first = false;
+    bool bgr = false;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            /* Don't lose colors or alpha silently. */
+            if (color_type != PNG_COLOR_TYPE_GRAY) {
+                return false;
+            }
+
+            if (bit_depth < 8) {
+                png_set_expand_gray_1_2_4_to_8(png_ptr);
+            } else if (bit_depth == 16) {
+                png_set_scale_16(png_ptr);
+            }
+
+            return true;
+        }
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { want_alpha = false;                                 break; }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  { want_alpha = false;                     bgr = true; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { want_alpha = true;                                  break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: { want_alpha = true;                      bgr = true; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: { want_alpha = true;  alpha_first = true;             break; }
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: { want_alpha = true;  alpha_first = true; bgr = true; break; }
+
+        default: {
+            return false;
+        }
+    }
+
+    const bool has_trns = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0;
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png_ptr);
+    } else if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    bool has_alpha = (color_type & PNG_COLOR_MASK_ALPHA) != 0 || (color_type == PNG_COLOR_TYPE_PALETTE && has_trns);
+
+    if (want_alpha) {
+        if (has_trns) {
+            png_set_tRNS_to_alpha(png_ptr);
+            has_alpha = true;
+        }
+    } else if (has_alpha) {
+        png_set_strip_alpha(png_ptr);
+    }
+
+    if (bit_depth == 16) {
+        png_set_scale_16(png_ptr);
+    }
+
+    if ((color_type & PNG_COLOR_MASK_COLOR) == 0) {
+        png_set_gray_to_rgb(png_ptr);
+    }
+
+    if (bgr) {
+        png_set_bgr(png_ptr);
+    }
+
+    if (want_alpha) {
+        if (has_alpha) {
+            if (alpha_first) {
+                png_set_swap_alpha(png_ptr);
+            }
+        } else {
+            png_set_add_alpha(png_ptr, 0xFF, alpha_first ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
+        }
+    }
+
+    return true;
+}
+
 bool png_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
 
     png_structp png_ptr = user_data;
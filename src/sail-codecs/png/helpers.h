@@ -73,6 +73,12 @@ SAIL_HIDDEN sail_status_t png_private_fetch_resolution(png_structp png_ptr, png_
 
 SAIL_HIDDEN sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_ptr, const struct sail_resolution *resolution);
 
+/*
+ * Sets up libpng transformations to output 'pixel_format' directly. Returns false
+ * if the pixel format is not supported for the source image.
+ */
+SAIL_HIDDEN bool png_private_set_output_pixel_format(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format);
+
 SAIL_HIDDEN bool png_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
 
 #endif
@@ -64,6 +64,9 @@ struct png_state {
     int frames;
     int current_frame;
 
+    /* Row pointers to pass the whole image to libpng at once. */
+    png_bytep *row_pointers;
+
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
     bool is_apng;
@@ -106,6 +109,7 @@ static sail_status_t alloc_png_state(struct png_state **png_state) {
     (*png_state)->frame_saved       = false;
     (*png_state)->frames            = 0;
     (*png_state)->current_frame     = 0;
+    (*png_state)->row_pointers      = NULL;
 
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
@@ -139,6 +143,8 @@ static void destroy_png_state(struct png_state *png_state) {
     sail_destroy_load_options(png_state->load_options);
     sail_destroy_save_options(png_state->save_options);
 
+    sail_free(png_state->row_pointers);
+
 #ifdef PNG_APNG_SUPPORTED
     sail_free(png_state->temp_scanline);
     sail_free(png_state->scanline_for_skipping);
@@ -153,6 +159,19 @@ static void destroy_png_state(struct png_state *png_state) {
     sail_free(png_state);
 }
 
+static sail_status_t fill_row_pointers(struct png_state *png_state, const struct sail_image *image) {
+
+    void *ptr = png_state->row_pointers;
+    SAIL_TRY(sail_realloc(sizeof(png_bytep) * image->height, &ptr));
+    png_state->row_pointers = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        png_state->row_pointers[row] = (png_bytep)image->pixels + (size_t)row * image->bytes_per_line;
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -234,6 +253,28 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
     png_state->frames = 1;
 #endif
 
+    /* Decode directly into the requested output pixel format if possible. APNG frames are blended in the native format. */
+    if (png_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN
+#ifdef PNG_APNG_SUPPORTED
+            && !png_state->is_apng
+#endif
+            ) {
+        if (png_private_set_output_pixel_format(png_state->png_ptr, png_state->info_ptr,
+                                                png_state->color_type, png_state->bit_depth,
+                                                png_state->load_options->output_pixel_format)) {
+            png_read_update_info(png_state->png_ptr, png_state->info_ptr);
+
+            png_state->first_image->pixel_format   = png_state->load_options->output_pixel_format;
+            png_state->first_image->bytes_per_line = sail_bytes_per_line(png_state->first_image->width, png_state->first_image->pixel_format);
+
+            sail_destroy_palette(png_state->first_image->palette);
+            png_state->first_image->palette = NULL;
+        } else {
+            SAIL_LOG_TRACE("PNG: Cannot output %s pixels, falling back to the native pixel format",
+                            sail_pixel_format_to_string(png_state->load_options->output_pixel_format));
+        }
+    }
+
     png_state->first_image->source_image->pixel_format = png_private_png_color_type_to_pixel_format(png_state->color_type, png_state->bit_depth);
     png_state->first_image->source_image->compression = SAIL_COMPRESSION_DEFLATE;
 
@@ -361,14 +402,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_png(void *state, struct sail_
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    SAIL_TRY(fill_row_pointers(png_state, image));
+
     if (setjmp(png_jmpbuf(png_state->png_ptr))) {
         png_state->libpng_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
-    #ifdef PNG_APNG_SUPPORTED
-        if (png_state->is_apng) {
+#ifdef PNG_APNG_SUPPORTED
+    if (png_state->is_apng) {
+        for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
             for (unsigned row = 0; row < image->height; row++) {
                 unsigned char *scanline = (unsigned char *)image->pixels + row * image->bytes_per_line;
 
@@ -404,17 +447,14 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_png(void *state, struct sail_
                     }
                 }
             }
-        } else {
-            for (unsigned row = 0; row < image->height; row++) {
-                png_read_row(png_state->png_ptr, (unsigned char *)image->pixels + row * image->bytes_per_line, NULL);
-            }
         }
-    #else
-        for (unsigned row = 0; row < image->height; row++) {
-            png_read_row(png_state->png_ptr, (unsigned char *)image->pixels + row * image->bytes_per_line, NULL);
-        }
-    #endif
+
+        return SAIL_OK;
     }
+#endif
+
+    /* libpng walks all the rows and interlaced passes itself. */
+    png_read_image(png_state->png_ptr, png_state->row_pointers);
 
     return SAIL_OK;
 }
@@ -606,17 +646,16 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_png(void *state, const struct
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    SAIL_TRY(fill_row_pointers(png_state, image));
+
     /* Error handling setup. */
     if (setjmp(png_jmpbuf(png_state->png_ptr))) {
         png_state->libpng_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
-        for (unsigned row = 0; row < image->height; row++) {
-            png_write_row(png_state->png_ptr, (const unsigned char *)image->pixels + row * image->bytes_per_line);
-        }
-    }
+    /* libpng walks all the rows and interlaced passes itself. */
+    png_write_image(png_state->png_ptr, png_state->row_pointers);
 
     return SAIL_OK;
 }
@@ -44,8 +44,9 @@ struct qoi_state {
     bool frame_loaded;
     bool frame_saved;
 
-    void *image_data;
+    const void *image_data;
     size_t image_data_size;
+    void *allocated_image_data;
     void *pixels;
 
     qoi_desc qoi_desc;
@@ -64,9 +65,10 @@ static sail_status_t alloc_qoi_state(struct qoi_state **qoi_state) {
     (*qoi_state)->frame_loaded = false;
     (*qoi_state)->frame_saved  = false;
 
-    (*qoi_state)->image_data      = NULL;
-    (*qoi_state)->image_data_size = 0;
-    (*qoi_state)->pixels          = NULL;
+    (*qoi_state)->image_data           = NULL;
+    (*qoi_state)->image_data_size      = 0;
+    (*qoi_state)->allocated_image_data = NULL;
+    (*qoi_state)->pixels               = NULL;
 
     return SAIL_OK;
 }
@@ -80,7 +82,7 @@ static void destroy_qoi_state(struct qoi_state *qoi_state) {
     sail_destroy_load_options(qoi_state->load_options);
     sail_destroy_save_options(qoi_state->save_options);
 
-    sail_free(qoi_state->image_data);
+    sail_free(qoi_state->allocated_image_data);
     sail_free(qoi_state->pixels);
 
     sail_free(qoi_state);
@@ -102,8 +104,9 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_qoi(struct sail_io *io, const
     /* Deep copy load options. */
     SAIL_TRY(sail_copy_load_options(load_options, &qoi_state->load_options));
 
-    /* Cache the entire file as the QOI API requires. */
-    SAIL_TRY(sail_alloc_data_from_io_contents(io, &qoi_state->image_data, &qoi_state->image_data_size));
+    /* Cache the entire file as the QOI API requires. Memory and memory-mapped sources are used without copying. */
+    SAIL_TRY(sail_alloc_or_borrow_data_from_io_contents(io, &qoi_state->image_data, &qoi_state->image_data_size,
+                                                        &qoi_state->allocated_image_data));
 
     return SAIL_OK;
 }
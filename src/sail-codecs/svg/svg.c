@@ -95,15 +95,19 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_svg(struct sail_io *io, const
     /* Deep copy load options. */
     SAIL_TRY(sail_copy_load_options(load_options, &svg_state->load_options));
 
-    /* Read the entire image as the resvg API requires. */
-    void *image_data;
+    /* Read the entire image as the resvg API requires. Memory and memory-mapped sources are used without copying. */
+    const void *image_data;
     size_t image_size;
-    SAIL_TRY(sail_alloc_data_from_io_contents(io, &image_data, &image_size));
+    void *allocated_image_data;
+    SAIL_TRY(sail_alloc_or_borrow_data_from_io_contents(io, &image_data, &image_size, &allocated_image_data));
 
     svg_state->resvg_options = resvg_options_create();
 
     const int result = resvg_parse_tree_from_data(image_data, image_size, svg_state->resvg_options, &svg_state->resvg_tree);
 
+    /* The parsed tree doesn't reference the data. */
+    sail_free(allocated_image_data);
+
     if (result != RESVG_OK) {
         SAIL_LOG_ERROR("SVG: Failed to load image");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
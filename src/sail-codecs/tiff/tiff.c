@@ -326,9 +326,26 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_tiff(void *state, const struc
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        if (TIFFWriteScanline(tiff_state->tiff, (unsigned char *)image->pixels + row * image->bytes_per_line, tiff_state->line++, 0) < 0) {
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    uint32_t rows_per_strip = 0;
+    TIFFGetFieldDefaulted(tiff_state->tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
+
+    if (rows_per_strip > 0 && (size_t)TIFFScanlineSize(tiff_state->tiff) == image->bytes_per_line) {
+        /* Rows are contiguous, so encode whole strips at once. */
+        for (unsigned row = 0, strip = 0; row < image->height; row += rows_per_strip, strip++) {
+            const unsigned rows_in_strip = (image->height - row < rows_per_strip) ? image->height - row : rows_per_strip;
+
+            if (TIFFWriteEncodedStrip(tiff_state->tiff,
+                                        strip,
+                                        (unsigned char *)image->pixels + (size_t)row * image->bytes_per_line,
+                                        (tmsize_t)rows_in_strip * image->bytes_per_line) < 0) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+        }
+    } else {
+        for (unsigned row = 0; row < image->height; row++) {
+            if (TIFFWriteScanline(tiff_state->tiff, (unsigned char *)image->pixels + row * image->bytes_per_line, tiff_state->line++, 0) < 0) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
         }
     }
 
@@ -57,8 +57,9 @@ struct webp_state {
     WebPMuxAnimDispose frame_dispose_method;
     WebPMuxAnimBlend frame_blend_method;
 
-    void *image_data;
+    const void *image_data;
     size_t image_data_size;
+    void *allocated_image_data;
 };
 
 static sail_status_t alloc_webp_state(struct webp_state **webp_state) {
@@ -84,8 +85,9 @@ static sail_status_t alloc_webp_state(struct webp_state **webp_state) {
     (*webp_state)->frame_dispose_method  = WEBP_MUX_DISPOSE_NONE;
     (*webp_state)->frame_blend_method    = WEBP_MUX_NO_BLEND;
 
-    (*webp_state)->image_data      = NULL;
-    (*webp_state)->image_data_size = 0;
+    (*webp_state)->image_data           = NULL;
+    (*webp_state)->image_data_size      = 0;
+    (*webp_state)->allocated_image_data = NULL;
 
     return SAIL_OK;
 }
@@ -101,7 +103,7 @@ static void destroy_webp_state(struct webp_state *webp_state) {
         sail_free(webp_state->webp_iterator);
     }
 
-    sail_free(webp_state->image_data);
+    sail_free(webp_state->allocated_image_data);
 
     WebPDemuxDelete(webp_state->webp_demux);
 
@@ -135,17 +137,23 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
 
     SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
 
-    void *ptr;
-    SAIL_TRY(sail_malloc(webp_state->image_data_size, &ptr));
-    webp_state->image_data = ptr;
+    /* Memory and memory-mapped sources are used without copying. */
+    size_t available_size;
+    SAIL_TRY(sail_alloc_or_borrow_data_from_io_contents(io, &webp_state->image_data, &available_size,
+                                                        &webp_state->allocated_image_data));
 
-    SAIL_TRY(io->strict_read(io->stream, webp_state->image_data, webp_state->image_data_size));
+    if (available_size < webp_state->image_data_size) {
+        SAIL_LOG_ERROR("WEBP: Image is truncated. Expected %lu bytes, got %lu bytes",
+                        (unsigned long)webp_state->image_data_size, (unsigned long)available_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
 
     /* Construct a WebP demuxer. */
     const WebPData data = { webp_state->image_data, webp_state->image_data_size };
 
     webp_state->webp_demux = WebPDemux(&data);
 
+    void *ptr;
     SAIL_TRY(sail_malloc(sizeof(WebPIterator), &ptr));
     webp_state->webp_iterator = ptr;
 
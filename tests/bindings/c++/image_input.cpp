@@ -0,0 +1,138 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sail-c++.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static const SailPixelFormat OUTPUT_PIXEL_FORMAT = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+/* Returns the first BMP test image. BMP doesn't support output pixel formats natively. */
+static std::string bmp_test_image() {
+    for (std::size_t i = 0; SAIL_TEST_IMAGES[i] != nullptr; i++) {
+        const std::string path = SAIL_TEST_IMAGES[i];
+
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bmp") == 0) {
+            return path;
+        }
+    }
+
+    return {};
+}
+
+static sail::load_options bmp_load_options() {
+    const sail::codec_info codec_info = sail::codec_info::from_extension("bmp");
+    munit_assert(codec_info.is_valid());
+
+    sail::load_options load_options;
+    munit_assert(codec_info.load_features().to_options(&load_options) == SAIL_OK);
+    load_options.set_output_pixel_format(OUTPUT_PIXEL_FORMAT);
+
+    return load_options;
+}
+
+static MunitResult test_next_frame_into_buffer_converts(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const std::string path = bmp_test_image();
+    munit_assert(!path.empty());
+
+    sail::image native_image = sail::image_input(path).next_frame();
+    munit_assert(native_image.is_valid());
+    munit_assert(native_image.pixel_format() != OUTPUT_PIXEL_FORMAT);
+
+    sail::image expected_image;
+    munit_assert(native_image.convert_to(OUTPUT_PIXEL_FORMAT, &expected_image) == SAIL_OK);
+
+    std::vector<unsigned char> buffer(expected_image.pixels_size() > native_image.pixels_size()
+                                          ? expected_image.pixels_size()
+                                          : native_image.pixels_size());
+
+    sail::image_input input(path);
+    input.with(bmp_load_options());
+
+    sail::image image;
+    munit_assert(input.next_frame(&image, buffer.data(), buffer.size()) == SAIL_OK);
+
+    /* The frame is converted back into the caller buffer. */
+    munit_assert(image.pixel_format() == OUTPUT_PIXEL_FORMAT);
+    munit_assert_ptr_equal(image.pixels(), buffer.data());
+    munit_assert_uint(image.pixels_size(), ==, expected_image.pixels_size());
+    munit_assert_memory_equal(expected_image.pixels_size(), buffer.data(), expected_image.pixels());
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_next_frame_into_buffer_too_small(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const std::string path = bmp_test_image();
+    munit_assert(!path.empty());
+
+    sail::image native_image = sail::image_input(path).next_frame();
+    munit_assert(native_image.is_valid());
+
+    sail::image expected_image;
+    munit_assert(native_image.convert_to(OUTPUT_PIXEL_FORMAT, &expected_image) == SAIL_OK);
+    munit_assert_uint(expected_image.pixels_size(), >, native_image.pixels_size());
+
+    /* Fits the native frame, but not the converted one. */
+    std::vector<unsigned char> buffer(native_image.pixels_size());
+
+    sail::image_input input(path);
+    input.with(bmp_load_options());
+
+    sail::image image;
+    munit_assert(input.next_frame(&image, buffer.data(), buffer.size()) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/image-input/next-frame-into-buffer/converts",  test_next_frame_into_buffer_converts,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/image-input/next-frame-into-buffer/too-small", test_next_frame_into_buffer_too_small, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
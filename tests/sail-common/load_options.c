@@ -36,6 +36,7 @@ static MunitResult test_alloc_options(const MunitParameter params[], void *user_
     munit_assert_not_null(load_options);
     munit_assert(load_options->options == 0);
     munit_assert_null(load_options->tuning);
+    munit_assert(load_options->output_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN);
 
     sail_destroy_load_options(load_options);
 
@@ -49,13 +50,15 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     struct sail_load_options *load_options = NULL;
     munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
 
-    load_options->options = SAIL_OPTION_ICCP;
+    load_options->options             = SAIL_OPTION_ICCP;
+    load_options->output_pixel_format = SAIL_PIXEL_FORMAT_BPP32_BGRA;
 
     struct sail_load_options *load_options_copy = NULL;
     munit_assert(sail_copy_load_options(load_options, &load_options_copy) == SAIL_OK);
     munit_assert_not_null(load_options_copy);
 
     munit_assert(load_options_copy->options == load_options->options);
+    munit_assert(load_options_copy->output_pixel_format == load_options->output_pixel_format);
     munit_assert_null(load_options_copy->tuning);
 
     sail_destroy_load_options(load_options_copy);
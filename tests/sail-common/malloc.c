@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "sail-common.h"
@@ -93,11 +94,138 @@ static MunitResult test_realloc(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+struct tracking_stats {
+    int allocations;
+    int frees;
+};
+
+static void* tracking_malloc(void *user_data, size_t size) {
+
+    ((struct tracking_stats *)user_data)->allocations++;
+    return malloc(size);
+}
+
+static void* tracking_realloc(void *user_data, void *ptr, size_t size) {
+
+    if (ptr == NULL) {
+        ((struct tracking_stats *)user_data)->allocations++;
+    }
+
+    return realloc(ptr, size);
+}
+
+static void tracking_free(void *user_data, void *ptr) {
+
+    if (ptr != NULL) {
+        ((struct tracking_stats *)user_data)->frees++;
+    }
+
+    free(ptr);
+}
+
+static MunitResult test_allocator(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct tracking_stats stats = { 0, 0 };
+
+    /* calloc_func is optional. */
+    const struct sail_allocator allocator = { tracking_malloc, tracking_realloc, NULL, tracking_free, &stats };
+
+    /* Incomplete allocators are rejected. */
+    const struct sail_allocator invalid_allocator = { tracking_malloc, NULL, NULL, tracking_free, &stats };
+    munit_assert(sail_set_allocator(&invalid_allocator) == SAIL_ERROR_NULL_PTR);
+
+    munit_assert(sail_set_thread_allocator(&allocator) == SAIL_OK);
+
+    void *ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    ptr = NULL;
+    munit_assert(sail_realloc(16, &ptr) == SAIL_OK);
+    munit_assert(sail_realloc(32, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    ptr = NULL;
+    munit_assert(sail_calloc(4, 4, &ptr) == SAIL_OK);
+
+    const unsigned char *cptr = ptr;
+
+    for (size_t i = 0; i < 16; i++) {
+        munit_assert(cptr[i] == 0);
+    }
+
+    sail_free(ptr);
+
+    munit_assert(sail_set_thread_allocator(NULL) == SAIL_OK);
+
+    munit_assert_int(stats.allocations, ==, 3);
+    munit_assert_int(stats.frees, ==, 3);
+
+    /* The global allocator is used when no thread allocator is set. */
+    munit_assert(sail_set_allocator(&allocator) == SAIL_OK);
+
+    ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    munit_assert(sail_set_allocator(NULL) == SAIL_OK);
+
+    munit_assert_int(stats.allocations, ==, 4);
+    munit_assert_int(stats.frees, ==, 4);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_global_allocation(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct tracking_stats stats = { 0, 0 };
+    const struct sail_allocator allocator = { tracking_malloc, tracking_realloc, NULL, tracking_free, &stats };
+
+    munit_assert(sail_set_thread_allocator(&allocator) == SAIL_OK);
+
+    /* Nested global allocations ignore the thread allocator. */
+    sail_private_begin_global_allocation();
+    sail_private_begin_global_allocation();
+
+    void *ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    sail_private_end_global_allocation();
+
+    ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    sail_private_end_global_allocation();
+
+    munit_assert_int(stats.allocations, ==, 0);
+    munit_assert_int(stats.frees, ==, 0);
+
+    ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    munit_assert(sail_set_thread_allocator(NULL) == SAIL_OK);
+
+    munit_assert_int(stats.allocations, ==, 1);
+    munit_assert_int(stats.frees, ==, 1);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/malloc",  test_malloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/calloc",  test_calloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/realloc", test_realloc, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
+    { (char *)"/allocator",         test_allocator,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/global-allocation", test_global_allocation, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
 
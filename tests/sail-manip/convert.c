@@ -0,0 +1,527 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sail-common.h"
+#include "sail-manip.h"
+
+#include "munit.h"
+
+static const unsigned WIDTH  = 37;
+static const unsigned HEIGHT = 5;
+
+struct rgb_layout {
+    enum SailPixelFormat pixel_format;
+    unsigned pixel_size; /* In components. */
+    bool is_16bit;
+    int r, g, b, a;      /* -1 when there is no alpha. */
+};
+
+static const struct rgb_layout RGB_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  3, false, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,  3, false, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, 4, false, 0, 1, 2, 3  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, 4, false, 2, 1, 0, 3  },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB, 4, false, 1, 2, 3, 0  },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR, 4, false, 3, 2, 1, 0  },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX, 4, false, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRX, 4, false, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,  3, true,  0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,  3, true,  2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA, 4, true,  0, 1, 2, 3  },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA, 4, true,  2, 1, 0, 3  },
+};
+
+static const size_t RGB_LAYOUTS_LENGTH = sizeof(RGB_LAYOUTS) / sizeof(RGB_LAYOUTS[0]);
+
+static struct sail_image* create_image_with_size(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+    munit_assert(sail_malloc(pixels_size, &image->pixels) == SAIL_OK);
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        ((uint8_t *)image->pixels)[i] = (uint8_t)(i * 37 + i / 7);
+    }
+
+    return image;
+}
+
+static struct sail_image* create_image(enum SailPixelFormat pixel_format) {
+
+    return create_image_with_size(pixel_format, WIDTH, HEIGHT);
+}
+
+static unsigned component_as_uint8(const struct sail_image *image, const struct rgb_layout *layout,
+                                   unsigned row, unsigned column, int index) {
+
+    if (index < 0) {
+        return 255;
+    }
+
+    const uint8_t *scan = (uint8_t *)image->pixels + (size_t)image->bytes_per_line * row;
+
+    if (layout->is_16bit) {
+        return ((const uint16_t *)scan)[column * layout->pixel_size + (unsigned)index] / 257;
+    } else {
+        return scan[column * layout->pixel_size + (unsigned)index];
+    }
+}
+
+static MunitResult test_rgb_to_rgb(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < RGB_LAYOUTS_LENGTH; i++) {
+        const struct rgb_layout *input_layout = &RGB_LAYOUTS[i];
+        struct sail_image *image = create_image(input_layout->pixel_format);
+
+        /* Outputs are 8-bit only. */
+        for (size_t k = 0; k < RGB_LAYOUTS_LENGTH; k++) {
+            const struct rgb_layout *output_layout = &RGB_LAYOUTS[k];
+
+            if (output_layout->is_16bit || output_layout->pixel_format == input_layout->pixel_format) {
+                continue;
+            }
+
+            struct sail_image *image_output;
+            munit_assert(sail_convert_image(image, output_layout->pixel_format, &image_output) == SAIL_OK);
+
+            for (unsigned row = 0; row < HEIGHT; row++) {
+                for (unsigned column = 0; column < WIDTH; column++) {
+                    munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->r), ==,
+                                      component_as_uint8(image, input_layout, row, column, input_layout->r));
+                    munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->g), ==,
+                                      component_as_uint8(image, input_layout, row, column, input_layout->g));
+                    munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->b), ==,
+                                      component_as_uint8(image, input_layout, row, column, input_layout->b));
+
+                    if (output_layout->a >= 0) {
+                        munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->a), ==,
+                                          component_as_uint8(image, input_layout, row, column, input_layout->a));
+                    }
+                }
+            }
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_gray_to_rgb(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    for (size_t k = 0; k < RGB_LAYOUTS_LENGTH; k++) {
+        const struct rgb_layout *output_layout = &RGB_LAYOUTS[k];
+
+        if (output_layout->is_16bit) {
+            continue;
+        }
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, output_layout->pixel_format, &image_output) == SAIL_OK);
+
+        for (unsigned row = 0; row < HEIGHT; row++) {
+            const uint8_t *scan = (uint8_t *)image->pixels + (size_t)image->bytes_per_line * row;
+
+            for (unsigned column = 0; column < WIDTH; column++) {
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->r), ==, scan[column]);
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->g), ==, scan[column]);
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->b), ==, scan[column]);
+
+                if (output_layout->a >= 0) {
+                    munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->a), ==, 255);
+                }
+            }
+        }
+
+        sail_destroy_image(image_output);
+    }
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_ycbcr_to_rgb(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+
+    /* RGBX output goes through the generic per-pixel conversion. Use it as a reference. */
+    struct sail_image *reference;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBX, &reference) == SAIL_OK);
+
+    for (size_t k = 0; k < RGB_LAYOUTS_LENGTH; k++) {
+        const struct rgb_layout *output_layout = &RGB_LAYOUTS[k];
+
+        if (output_layout->is_16bit) {
+            continue;
+        }
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, output_layout->pixel_format, &image_output) == SAIL_OK);
+
+        for (unsigned row = 0; row < HEIGHT; row++) {
+            const uint8_t *scan = (uint8_t *)reference->pixels + (size_t)reference->bytes_per_line * row;
+
+            for (unsigned column = 0; column < WIDTH; column++) {
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->r), ==, scan[column * 4 + 0]);
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->g), ==, scan[column * 4 + 1]);
+                munit_assert_uint(component_as_uint8(image_output, output_layout, row, column, output_layout->b), ==, scan[column * 4 + 2]);
+            }
+        }
+
+        sail_destroy_image(image_output);
+    }
+
+    sail_destroy_image(reference);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_update_in_place(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_image(SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    struct sail_image *expected;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA, &expected) == SAIL_OK);
+
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA) == SAIL_OK);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP32_BGRA);
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image->pixels, expected->pixels);
+
+    sail_destroy_image(expected);
+
+    /* Smaller pixels are packed with the new stride. */
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &expected) == SAIL_OK);
+
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE) == SAIL_OK);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+    munit_assert_uint(image->bytes_per_line, ==, expected->bytes_per_line);
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image->pixels, expected->pixels);
+
+    sail_destroy_image(expected);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_indexed_to_rgb(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const struct {
+        enum SailPixelFormat pixel_format;
+        unsigned bits_per_pixel;
+    } INDEXED_FORMATS[] = {
+        { SAIL_PIXEL_FORMAT_BPP1_INDEXED, 1 },
+        { SAIL_PIXEL_FORMAT_BPP2_INDEXED, 2 },
+        { SAIL_PIXEL_FORMAT_BPP4_INDEXED, 4 },
+        { SAIL_PIXEL_FORMAT_BPP8_INDEXED, 8 },
+    };
+
+    /* Wide rows are unpacked in several chunks. */
+    const unsigned WIDTHS[] = { WIDTH, 2061 };
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+        for (size_t i = 0; i < sizeof(INDEXED_FORMATS) / sizeof(INDEXED_FORMATS[0]); i++) {
+            const unsigned bits_per_pixel = INDEXED_FORMATS[i].bits_per_pixel;
+            const unsigned color_count = 1u << bits_per_pixel;
+
+            struct sail_image *image = create_image_with_size(INDEXED_FORMATS[i].pixel_format, WIDTHS[w], HEIGHT);
+            munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &image->palette) == SAIL_OK);
+
+            uint8_t *palette_data = image->palette->data;
+            for (unsigned color = 0; color < color_count * 3; color++) {
+                palette_data[color] = (uint8_t)(color * 7 + 3);
+            }
+
+            /* BPP24-RGB and BPP32-RGBA copy the palette colors directly. */
+            for (size_t l = 0; l < RGB_LAYOUTS_LENGTH; l++) {
+                const struct rgb_layout *layout = &RGB_LAYOUTS[l];
+
+                if (layout->pixel_format != SAIL_PIXEL_FORMAT_BPP24_RGB &&
+                        layout->pixel_format != SAIL_PIXEL_FORMAT_BPP32_RGBA &&
+                        layout->pixel_format != SAIL_PIXEL_FORMAT_BPP32_BGRA) {
+                    continue;
+                }
+
+                struct sail_image *image_output;
+                munit_assert(sail_convert_image(image, layout->pixel_format, &image_output) == SAIL_OK);
+
+                for (unsigned row = 0; row < image->height; row++) {
+                    const uint8_t *scan_input = (const uint8_t *)image->pixels + (size_t)image->bytes_per_line * row;
+
+                    for (unsigned column = 0; column < image->width; column++) {
+                        const unsigned bit_offset = column * bits_per_pixel;
+                        const unsigned index = (scan_input[bit_offset / 8] >> (8 - bits_per_pixel - bit_offset % 8)) & (color_count - 1);
+                        const uint8_t *color = palette_data + index * 3;
+
+                        munit_assert_uint(component_as_uint8(image_output, layout, row, column, layout->r), ==, color[0]);
+                        munit_assert_uint(component_as_uint8(image_output, layout, row, column, layout->g), ==, color[1]);
+                        munit_assert_uint(component_as_uint8(image_output, layout, row, column, layout->b), ==, color[2]);
+                        munit_assert_uint(component_as_uint8(image_output, layout, row, column, layout->a), ==, 255);
+                    }
+                }
+
+                sail_destroy_image(image_output);
+            }
+
+            struct sail_image *image_output;
+
+            /* Indexes out of the palette range. */
+            image->palette->color_count = 1;
+            munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_output) == SAIL_ERROR_BROKEN_IMAGE);
+            munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_output) == SAIL_ERROR_BROKEN_IMAGE);
+
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_blend_alpha(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_image(SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options      = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+    options->background24 = (sail_rgb24_t){ 10, 128, 250 };
+
+    struct sail_image *rgb;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &rgb) == SAIL_OK);
+
+    struct sail_image *gray;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &gray) == SAIL_OK);
+
+    const uint8_t background[3] = { options->background24.component1, options->background24.component2, options->background24.component3 };
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *input = (const uint8_t *)image->pixels + (size_t)image->bytes_per_line * row;
+        const uint8_t *rgb_scan = (const uint8_t *)rgb->pixels + (size_t)rgb->bytes_per_line * row;
+        const uint8_t *gray_scan = (const uint8_t *)gray->pixels + (size_t)gray->bytes_per_line * row;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint8_t *pixel = input + column * 4;
+            const unsigned alpha = pixel[3];
+
+            /* Blending is exact. */
+            unsigned blended[3];
+            for (unsigned i = 0; i < 3; i++) {
+                blended[i] = (alpha == 255) ? pixel[i] : (pixel[i] * alpha + background[i] * (255 - alpha)) / 255;
+                munit_assert_uint8(rgb_scan[column * 3 + i], ==, blended[i]);
+            }
+
+            /* Grayscale differs from the floating-point weighted sum by at most 1. */
+            const int expected_gray = (int)(0.299 * blended[0] + 0.587 * blended[1] + 0.114 * blended[2]);
+            munit_assert_int(gray_scan[column], >=, expected_gray - 1);
+            munit_assert_int(gray_scan[column], <=, expected_gray + 1);
+        }
+    }
+
+    sail_destroy_image(gray);
+    sail_destroy_image(rgb);
+    sail_destroy_conversion_options(options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_multi_threaded(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Large enough to be split into bands. */
+    static const unsigned width  = 1031;
+    static const unsigned height = 1017;
+
+    static const enum SailPixelFormat PIXEL_FORMATS[][2] = {
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP32_BGRA      }, /* Row kernel. */
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP64_RGBA      }, /* Generic path. */
+        { SAIL_PIXEL_FORMAT_BPP32_CMYK, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE  },
+    };
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->threads = 4;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image = create_image_with_size(PIXEL_FORMATS[i][0], width, height);
+
+        struct sail_image *expected;
+        munit_assert(sail_convert_image(image, PIXEL_FORMATS[i][1], &expected) == SAIL_OK);
+
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image_with_options(image, PIXEL_FORMATS[i][1], options, &image_output) == SAIL_OK);
+        munit_assert_memory_equal((size_t)expected->height * expected->bytes_per_line, image_output->pixels, expected->pixels);
+
+        sail_destroy_image(image_output);
+
+        if (sail_greater_equal_bits_per_pixel(PIXEL_FORMATS[i][0], PIXEL_FORMATS[i][1])) {
+            munit_assert(sail_update_image_with_options(image, PIXEL_FORMATS[i][1], options) == SAIL_OK);
+
+            for (unsigned row = 0; row < height; row++) {
+                munit_assert_memory_equal(expected->bytes_per_line,
+                                          (uint8_t *)image->pixels + (size_t)image->bytes_per_line * row,
+                                          (uint8_t *)expected->pixels + (size_t)expected->bytes_per_line * row);
+            }
+        }
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_row_converter(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const enum SailPixelFormat PIXEL_FORMATS[][2] = {
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA,   SAIL_PIXEL_FORMAT_BPP32_BGRA },    /* Row kernel. */
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,    SAIL_PIXEL_FORMAT_BPP64_RGBA },    /* Generic path. */
+        { SAIL_PIXEL_FORMAT_BPP4_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    };
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image = create_image(PIXEL_FORMATS[i][0]);
+
+        if (sail_is_indexed(image->pixel_format)) {
+            munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, &image->palette) == SAIL_OK);
+
+            for (unsigned color = 0; color < 16 * 3; color++) {
+                ((uint8_t *)image->palette->data)[color] = (uint8_t)(color * 5);
+            }
+        }
+
+        struct sail_image *expected;
+        munit_assert(sail_convert_image(image, PIXEL_FORMATS[i][1], &expected) == SAIL_OK);
+
+        struct sail_row_converter *row_converter;
+        munit_assert(sail_alloc_row_converter(image->pixel_format, PIXEL_FORMATS[i][1], image->palette, NULL, &row_converter) == SAIL_OK);
+
+        /* Row by row into a single-row buffer. */
+        void *row;
+        munit_assert(sail_malloc(expected->bytes_per_line, &row) == SAIL_OK);
+
+        for (unsigned r = 0; r < image->height; r++) {
+            munit_assert(sail_convert_row(row_converter, image->width,
+                                          (uint8_t *)image->pixels + (size_t)image->bytes_per_line * r, row) == SAIL_OK);
+            munit_assert_memory_equal(expected->bytes_per_line, row, (uint8_t *)expected->pixels + (size_t)expected->bytes_per_line * r);
+        }
+
+        sail_free(row);
+
+        /* All rows at once into a buffer with a padded stride. */
+        const unsigned output_bytes_per_line = expected->bytes_per_line + 5;
+        void *rows;
+        munit_assert(sail_malloc((size_t)output_bytes_per_line * image->height, &rows) == SAIL_OK);
+
+        munit_assert(sail_convert_rows(row_converter, image->width, image->height,
+                                       image->pixels, image->bytes_per_line,
+                                       rows, output_bytes_per_line) == SAIL_OK);
+
+        for (unsigned r = 0; r < image->height; r++) {
+            munit_assert_memory_equal(expected->bytes_per_line,
+                                      (uint8_t *)rows + (size_t)output_bytes_per_line * r,
+                                      (uint8_t *)expected->pixels + (size_t)expected->bytes_per_line * r);
+        }
+
+        /* Too small strides. */
+        munit_assert(sail_convert_rows(row_converter, image->width, image->height,
+                                       image->pixels, image->bytes_per_line,
+                                       rows, expected->bytes_per_line - 1) == SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+
+        sail_free(rows);
+        sail_destroy_row_converter(row_converter);
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    struct sail_row_converter *row_converter;
+
+    /* Indexed images require a palette. */
+    munit_assert(sail_alloc_row_converter(SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP24_RGB,
+                                          NULL, NULL, &row_converter) == SAIL_ERROR_MISSING_PALETTE);
+
+    /* Unsupported output pixel formats. */
+    munit_assert(sail_alloc_row_converter(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+                                          NULL, NULL, &row_converter) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/rgb-to-rgb",     test_rgb_to_rgb,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gray-to-rgb",    test_gray_to_rgb,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/ycbcr-to-rgb",   test_ycbcr_to_rgb,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/update-in-place", test_update_in_place, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/indexed-to-rgb",  test_indexed_to_rgb,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-alpha",     test_blend_alpha,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/multi-threaded",  test_multi_threaded,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/row-converter",   test_row_converter,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/convert",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
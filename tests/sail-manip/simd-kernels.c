@@ -0,0 +1,260 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+#include "sail-manip.h"
+
+#include "munit.h"
+
+static const unsigned MAX_WIDTH = 67;
+#define EXHAUSTIVE_WIDTH 256
+
+struct rgb_layout {
+    enum SailPixelFormat pixel_format;
+    unsigned pixel_size; /* In components. */
+    bool is_16bit;
+    int r, g, b, a;      /* -1 when there is no alpha. */
+};
+
+static const struct rgb_layout RGB_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  3, false, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,  3, false, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, 4, false, 0, 1, 2, 3  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, 4, false, 2, 1, 0, 3  },
+    { SAIL_PIXEL_FORMAT_BPP32_ARGB, 4, false, 1, 2, 3, 0  },
+    { SAIL_PIXEL_FORMAT_BPP32_ABGR, 4, false, 3, 2, 1, 0  },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBX, 4, false, 0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRX, 4, false, 2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,  3, true,  0, 1, 2, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,  3, true,  2, 1, 0, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA, 4, true,  0, 1, 2, 3  },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA, 4, true,  2, 1, 0, 3  },
+};
+
+static const size_t RGB_LAYOUTS_LENGTH = sizeof(RGB_LAYOUTS) / sizeof(RGB_LAYOUTS[0]);
+
+/* Color spaces converted to RGB with the scalar pixel functions. Components are not used. */
+static const struct rgb_layout COLOR_LAYOUTS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR, 3, false, -1, -1, -1, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,  4, false, -1, -1, -1, -1 },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,  4, false, -1, -1, -1, -1 },
+};
+
+static const size_t COLOR_LAYOUTS_LENGTH = sizeof(COLOR_LAYOUTS) / sizeof(COLOR_LAYOUTS[0]);
+
+static const struct rgb_layout* find_layout(enum SailPixelFormat pixel_format) {
+
+    for (size_t i = 0; i < RGB_LAYOUTS_LENGTH; i++) {
+        if (RGB_LAYOUTS[i].pixel_format == pixel_format) {
+            return &RGB_LAYOUTS[i];
+        }
+    }
+
+    for (size_t i = 0; i < COLOR_LAYOUTS_LENGTH; i++) {
+        if (COLOR_LAYOUTS[i].pixel_format == pixel_format) {
+            return &COLOR_LAYOUTS[i];
+        }
+    }
+
+    munit_errorf("Pixel format %s has no layout", sail_pixel_format_to_string(pixel_format));
+    return NULL;
+}
+
+static void fill_input(uint8_t *input, size_t size, unsigned seed) {
+
+    for (size_t i = 0; i < size; i++) {
+        input[i] = (uint8_t)(i * 37 + i / 7 + seed * 101);
+    }
+}
+
+/* Every component takes all the 8-bit values in a 256-pixel row. */
+static void fill_input_exhaustive(uint8_t *input, unsigned pixel_size) {
+
+    for (unsigned pixel = 0; pixel < 256; pixel++) {
+        for (unsigned i = 0; i < pixel_size; i++) {
+            input[pixel * pixel_size + i] = (uint8_t)(pixel * (2 * i + 1) + i * 64);
+        }
+    }
+}
+
+static sail_rgba32_t color_to_rgba32(enum SailPixelFormat pixel_format, const uint8_t *pixel) {
+
+    sail_rgba32_t rgba32;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: convert_ycbcr24_to_rgba32(pixel[0], pixel[1], pixel[2], &rgba32);          break;
+        case SAIL_PIXEL_FORMAT_BPP32_YCCK:  convert_ycck32_to_rgba32(pixel[0], pixel[1], pixel[2], pixel[3], &rgba32); break;
+        case SAIL_PIXEL_FORMAT_BPP32_CMYK:  convert_cmyk32_to_rgba32(pixel[0], pixel[1], pixel[2], pixel[3], &rgba32); break;
+        default: munit_errorf("Unexpected pixel format %s", sail_pixel_format_to_string(pixel_format));
+    }
+
+    return rgba32;
+}
+
+/* Converts with the scalar pixel functions used by the generic conversion path. */
+static void convert_reference(const struct rgb_layout *input_layout, const struct rgb_layout *output_layout,
+                                const uint8_t *input, uint8_t *output, unsigned width) {
+
+    const unsigned output_pixel_size = output_layout->pixel_size;
+
+    /* X bytes are not touched by the pixel functions and SIMD kernels write 255 there. */
+    memset(output, 255, (size_t)width * output_pixel_size);
+
+    for (unsigned column = 0; column < width; column++) {
+        uint8_t *scan = output + (size_t)column * output_pixel_size;
+
+        if (output_layout->r < 0) {
+            const uint8_t *pixel = input + (size_t)column * input_layout->pixel_size;
+            const sail_rgba32_t rgba32 = { pixel[input_layout->r], pixel[input_layout->g], pixel[input_layout->b], 255 };
+
+            fill_ycbcr_pixel_from_uint8_values(&rgba32, scan, NULL);
+        } else if (input_layout->r < 0) {
+            const sail_rgba32_t rgba32 = color_to_rgba32(input_layout->pixel_format, input + (size_t)column * input_layout->pixel_size);
+
+            if (output_pixel_size == 4) {
+                fill_rgba32_pixel_from_uint8_values(&rgba32, scan, output_layout->r, output_layout->g, output_layout->b, output_layout->a, NULL);
+            } else {
+                fill_rgb24_pixel_from_uint8_values(&rgba32, scan, output_layout->r, output_layout->g, output_layout->b, NULL);
+            }
+        } else if (input_layout->is_16bit) {
+            const uint16_t *pixel = (const uint16_t *)input + (size_t)column * input_layout->pixel_size;
+            const sail_rgba64_t rgba64 = {
+                pixel[input_layout->r],
+                pixel[input_layout->g],
+                pixel[input_layout->b],
+                (input_layout->a >= 0) ? pixel[input_layout->a] : 0xFFFF
+            };
+
+            if (output_pixel_size == 4) {
+                fill_rgba32_pixel_from_uint16_values(&rgba64, scan, output_layout->r, output_layout->g, output_layout->b, output_layout->a, NULL);
+            } else {
+                fill_rgb24_pixel_from_uint16_values(&rgba64, scan, output_layout->r, output_layout->g, output_layout->b, NULL);
+            }
+        } else {
+            const uint8_t *pixel = input + (size_t)column * input_layout->pixel_size;
+            const sail_rgba32_t rgba32 = {
+                pixel[input_layout->r],
+                pixel[input_layout->g],
+                pixel[input_layout->b],
+                (input_layout->a >= 0) ? pixel[input_layout->a] : 255
+            };
+
+            if (output_pixel_size == 4) {
+                fill_rgba32_pixel_from_uint8_values(&rgba32, scan, output_layout->r, output_layout->g, output_layout->b, output_layout->a, NULL);
+            } else {
+                fill_rgb24_pixel_from_uint8_values(&rgba32, scan, output_layout->r, output_layout->g, output_layout->b, NULL);
+            }
+        }
+    }
+}
+
+/* Converts the input row with the kernel and compares the result with the reference conversion. */
+static void check_kernel(const struct simd_row_kernel *kernel, const struct rgb_layout *input_layout, const struct rgb_layout *output_layout,
+                         uint8_t *input, unsigned width) {
+
+    const unsigned input_pixel_size  = input_layout->pixel_size * (input_layout->is_16bit ? 2 : 1);
+    const unsigned output_pixel_size = output_layout->pixel_size;
+
+    uint8_t output[EXHAUSTIVE_WIDTH * 4 + 1];
+    uint8_t expected[EXHAUSTIVE_WIDTH * 4];
+
+    convert_reference(input_layout, output_layout, input, expected, width);
+
+    /* Kernels must not write past the row. */
+    memset(output, 0x5A, sizeof(output));
+    kernel->kernel(input, output, width);
+
+    munit_assert_memory_equal((size_t)width * output_pixel_size, output, expected);
+    munit_assert_uint8(output[(size_t)width * output_pixel_size], ==, 0x5A);
+
+    /* Conversions that don't grow pixels are also used to update images in place. */
+    if (output_pixel_size <= input_pixel_size) {
+        kernel->kernel(input, input, width);
+        munit_assert_memory_equal((size_t)width * output_pixel_size, input, expected);
+    }
+}
+
+static MunitResult test_kernels(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    size_t length;
+    const struct simd_row_kernel *kernels = simd_row_kernels(&length);
+
+    unsigned tested = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        const struct simd_row_kernel *kernel = &kernels[i];
+
+        if (!simd_level_supported(kernel->level)) {
+            continue;
+        }
+
+        const struct rgb_layout *input_layout  = find_layout(kernel->input_pixel_format);
+        const struct rgb_layout *output_layout = find_layout(kernel->output_pixel_format);
+
+        /* Every SIMD kernel must have a scalar counterpart. */
+        munit_assert_not_null(find_row_kernel(kernel->input_pixel_format, kernel->output_pixel_format, NULL));
+
+        const unsigned input_pixel_size = input_layout->pixel_size * (input_layout->is_16bit ? 2 : 1);
+        uint8_t input[EXHAUSTIVE_WIDTH * 8];
+
+        for (unsigned width = 1; width <= MAX_WIDTH; width++) {
+            fill_input(input, (size_t)width * input_pixel_size, width);
+            check_kernel(kernel, input_layout, output_layout, input, width);
+        }
+
+        fill_input_exhaustive(input, input_pixel_size);
+        check_kernel(kernel, input_layout, output_layout, input, EXHAUSTIVE_WIDTH);
+
+        tested++;
+    }
+
+    munit_logf(MUNIT_LOG_INFO, "Tested %u SIMD kernels out of %u", tested, (unsigned)length);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/kernels", test_kernels, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/simd-kernels",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
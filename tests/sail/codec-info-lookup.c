@@ -0,0 +1,188 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+static bool has_string(const struct sail_string_node *string_node, const char *str) {
+
+    for (; string_node != NULL; string_node = string_node->next) {
+        if (strcmp(string_node->string, str) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void to_upper(const char *str, char *result, size_t result_size) {
+
+    size_t i = 0;
+
+    for (; str[i] != '\0' && i < result_size - 1; i++) {
+        result[i] = (char)toupper((unsigned char)str[i]);
+    }
+
+    result[i] = '\0';
+}
+
+static MunitResult test_all_extensions(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list(); codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        for (const struct sail_string_node *extension_node = codec_bundle_node->codec_bundle->codec_info->extension_node; extension_node != NULL; extension_node = extension_node->next) {
+            char extension[64];
+            to_upper(extension_node->string, extension, sizeof(extension));
+
+            const struct sail_codec_info *codec_info;
+            munit_assert(sail_codec_info_from_extension(extension, &codec_info) == SAIL_OK);
+            munit_assert(has_string(codec_info->extension_node, extension_node->string));
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_all_mime_types(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list(); codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        for (const struct sail_string_node *mime_type_node = codec_bundle_node->codec_bundle->codec_info->mime_type_node; mime_type_node != NULL; mime_type_node = mime_type_node->next) {
+            char mime_type[128];
+            to_upper(mime_type_node->string, mime_type, sizeof(mime_type));
+
+            const struct sail_codec_info *codec_info;
+            munit_assert(sail_codec_info_from_mime_type(mime_type, &codec_info) == SAIL_OK);
+            munit_assert(has_string(codec_info->mime_type_node, mime_type_node->string));
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_path(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *expected_codec_info;
+    if (sail_codec_info_from_extension("png", &expected_codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path("/home/user/image.PnG", &codec_info) == SAIL_OK);
+    munit_assert_ptr_equal(codec_info, expected_codec_info);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unknown(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info = NULL;
+
+    munit_assert(sail_codec_info_from_extension("unknown-extension", &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert(sail_codec_info_from_extension("", &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert(sail_codec_info_from_mime_type("image/unknown", &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert_null(codec_info);
+
+    return MUNIT_OK;
+}
+
+static void* counting_malloc(void *user_data, size_t size) {
+
+    (*(int *)user_data)++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void *user_data, void *ptr, size_t size) {
+
+    if (ptr == NULL) {
+        (*(int *)user_data)++;
+    }
+
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *user_data, void *ptr) {
+
+    (void)user_data;
+
+    free(ptr);
+}
+
+static MunitResult test_thread_allocator(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    int allocations = 0;
+    const struct sail_allocator allocator = { counting_malloc, counting_realloc, NULL, counting_free, &allocations };
+
+    munit_assert(sail_set_thread_allocator(&allocator) == SAIL_OK);
+
+    /* The context is shared between threads, so it's allocated with the global allocator. */
+    munit_assert(sail_init() == SAIL_OK);
+    munit_assert_not_null(sail_codec_bundle_list());
+
+    munit_assert(sail_set_thread_allocator(NULL) == SAIL_OK);
+
+    munit_assert_int(allocations, ==, 0);
+
+    sail_finish();
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/all-extensions", test_all_extensions, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/all-mime-types", test_all_mime_types, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/path",           test_path,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unknown",        test_unknown,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { (char *)"/thread-allocator", test_thread_allocator, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/codec-info-lookup",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,432 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#define CODECS_PATH TEST_DIR "/codecs"
+#define CACHE_PATH  TEST_DIR "/registry.cache"
+
+/* Offset of the first SAIL version character: magic(8) + format version(4) + byte order(4) + length(4). */
+#define CACHE_VERSION_OFFSET 20
+
+static void write_file(const char *path, const void *data, size_t data_size) {
+
+    FILE *f = fopen(path, "wb");
+    munit_assert_not_null(f);
+    munit_assert_size(fwrite(data, 1, data_size, f), ==, data_size);
+    munit_assert_int(fclose(f), ==, 0);
+}
+
+static void *read_file(const char *path, size_t *data_size) {
+
+    FILE *f = fopen(path, "rb");
+    munit_assert_not_null(f);
+
+    munit_assert_int(fseek(f, 0, SEEK_END), ==, 0);
+    const long size = ftell(f);
+    munit_assert_long(size, >, 0);
+    munit_assert_int(fseek(f, 0, SEEK_SET), ==, 0);
+
+    void *data = munit_malloc((size_t)size);
+    munit_assert_size(fread(data, 1, (size_t)size, f), ==, (size_t)size);
+    fclose(f);
+
+    *data_size = (size_t)size;
+
+    return data;
+}
+
+static void write_codec_info(const char *file_name, const char *name, const char *priority, const char *description) {
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", CODECS_PATH, file_name);
+
+    char info[512];
+    const int info_length = snprintf(info, sizeof(info),
+                                     "[codec]\n"
+                                     "layout=8\n"
+                                     "version=1.0.0\n"
+                                     "priority=%s\n"
+                                     "name=%s\n"
+                                     "description=%s\n"
+                                     "extensions=%s\n"
+                                     "\n"
+                                     "[load-features]\n"
+                                     "features=STATIC\n"
+                                     "\n"
+                                     "[save-features]\n"
+                                     "features=\n",
+                                     priority, name, description, name);
+
+    write_file(path, info, (size_t)info_length);
+}
+
+static void set_mtime(const char *path, time_t seconds_ago) {
+
+    const time_t t = time(NULL) - seconds_ago;
+    struct utimbuf times = { t, t };
+
+    munit_assert_int(utime(path, &times), ==, 0);
+}
+
+/* Sets the codecs directory mtime in the past so the cache writer doesn't consider it racy. */
+static void set_codecs_path_mtime(time_t seconds_ago) {
+
+    set_mtime(CODECS_PATH, seconds_ago);
+}
+
+static void prepare_codecs(void) {
+
+    unlink(CACHE_PATH);
+    unlink(CODECS_PATH "/sail-codec-ccc.codec.info");
+
+    write_codec_info("sail-codec-aaa.codec.info", "AAA", "HIGHEST", "Codec A");
+    write_codec_info("sail-codec-bbb.codec.info", "BBB", "MEDIUM",  "Codec B");
+
+    /* Codec info files modified during the current second are racy too. */
+    set_mtime(CODECS_PATH "/sail-codec-aaa.codec.info", 100);
+    set_mtime(CODECS_PATH "/sail-codec-bbb.codec.info", 100);
+
+    set_codecs_path_mtime(100);
+}
+
+/* Initializes SAIL and prints the found codecs into the buffer. */
+static void list_codecs(const char *cache_path, char *buffer, size_t buffer_size) {
+
+    if (cache_path == NULL) {
+        munit_assert_int(unsetenv("SAIL_CODECS_CACHE"), ==, 0);
+    } else {
+        munit_assert_int(setenv("SAIL_CODECS_CACHE", cache_path, 1), ==, 0);
+    }
+
+    munit_assert(sail_init() == SAIL_OK);
+
+    buffer[0] = '\0';
+    size_t offset = 0;
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        const int written = snprintf(buffer + offset, buffer_size - offset, "%s|%s|%s\n",
+                                     codec_info->name, codec_info->description, codec_info->path);
+        munit_assert_int(written, >, 0);
+        munit_assert_size((size_t)written, <, buffer_size - offset);
+        offset += (size_t)written;
+    }
+
+    sail_finish();
+}
+
+/* Checks that the broken cache is ignored and replaced with a freshly scanned one. */
+static void check_fallback_to_scan(void *data, size_t data_size) {
+
+    char expected[1024];
+    list_codecs(NULL, expected, sizeof(expected));
+
+    char cached[1024];
+    list_codecs(CACHE_PATH, cached, sizeof(cached));
+
+    size_t reference_size;
+    void *reference = read_file(CACHE_PATH, &reference_size);
+
+    write_file(CACHE_PATH, data, data_size);
+
+    char actual[1024];
+    list_codecs(CACHE_PATH, actual, sizeof(actual));
+    munit_assert_string_equal(actual, expected);
+
+    size_t rebuilt_size;
+    void *rebuilt = read_file(CACHE_PATH, &rebuilt_size);
+    munit_assert_size(rebuilt_size, ==, reference_size);
+    munit_assert_memory_equal(rebuilt_size, rebuilt, reference);
+
+    free(rebuilt);
+    free(reference);
+}
+
+/* Builds a valid cache and returns its contents. */
+static void *build_cache(size_t *data_size) {
+
+    char buffer[1024];
+    list_codecs(CACHE_PATH, buffer, sizeof(buffer));
+
+    return read_file(CACHE_PATH, data_size);
+}
+
+static MunitResult test_round_trip(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    char scanned[1024];
+    list_codecs(NULL, scanned, sizeof(scanned));
+    munit_assert_not_null(strstr(scanned, "AAA|Codec A|"));
+    munit_assert_not_null(strstr(scanned, "BBB|Codec B|"));
+
+    char saved[1024];
+    list_codecs(CACHE_PATH, saved, sizeof(saved));
+    munit_assert_string_equal(saved, scanned);
+
+    char loaded[1024];
+    list_codecs(CACHE_PATH, loaded, sizeof(loaded));
+    munit_assert_string_equal(loaded, scanned);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_rewritten_codec_info(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    free(build_cache(&data_size));
+
+    /* Rewriting a file in place doesn't touch the directory mtime, but changes the file mtime. */
+    write_codec_info("sail-codec-aaa.codec.info", "AAA", "HIGHEST", "Codec X");
+    set_mtime(CODECS_PATH "/sail-codec-aaa.codec.info", 50);
+    set_codecs_path_mtime(100);
+
+    char loaded[1024];
+    list_codecs(CACHE_PATH, loaded, sizeof(loaded));
+    munit_assert_not_null(strstr(loaded, "AAA|Codec X|"));
+
+    /* Subsequent loads see the new description too. */
+    list_codecs(CACHE_PATH, loaded, sizeof(loaded));
+    munit_assert_not_null(strstr(loaded, "AAA|Codec X|"));
+
+    /* A file with a restored mtime is still detected by its size. */
+    write_codec_info("sail-codec-aaa.codec.info", "AAA", "HIGHEST", "Codec A changed");
+    set_mtime(CODECS_PATH "/sail-codec-aaa.codec.info", 50);
+    set_codecs_path_mtime(100);
+
+    list_codecs(CACHE_PATH, loaded, sizeof(loaded));
+    munit_assert_not_null(strstr(loaded, "AAA|Codec A changed|"));
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_stale_mtime(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    free(build_cache(&data_size));
+
+    write_codec_info("sail-codec-ccc.codec.info", "CCC", "LOW", "Codec C");
+    set_codecs_path_mtime(50);
+
+    char scanned[1024];
+    list_codecs(NULL, scanned, sizeof(scanned));
+    munit_assert_not_null(strstr(scanned, "CCC|Codec C|"));
+
+    char loaded[1024];
+    list_codecs(CACHE_PATH, loaded, sizeof(loaded));
+    munit_assert_string_equal(loaded, scanned);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_different_codecs_paths(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    unsigned char *data = build_cache(&data_size);
+
+    /* The codecs paths list precedes the codec records, so the first match is the recorded codecs path. */
+    const size_t codecs_path_length = strlen(CODECS_PATH);
+    unsigned char *recorded_path = NULL;
+
+    for (size_t i = 0; i + codecs_path_length <= data_size; i++) {
+        if (memcmp(data + i, CODECS_PATH, codecs_path_length) == 0) {
+            recorded_path = data + i;
+            break;
+        }
+    }
+
+    munit_assert_not_null(recorded_path);
+    recorded_path[codecs_path_length - 1] = 'X';
+
+    check_fallback_to_scan(data, data_size);
+
+    free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_wrong_magic(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    unsigned char *data = build_cache(&data_size);
+
+    data[0] ^= 0xFF;
+    check_fallback_to_scan(data, data_size);
+
+    free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_wrong_version(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    unsigned char *data = build_cache(&data_size);
+
+    munit_assert_size(data_size, >, CACHE_VERSION_OFFSET);
+    data[CACHE_VERSION_OFFSET] = 'X';
+    check_fallback_to_scan(data, data_size);
+
+    free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_truncated(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    void *data = build_cache(&data_size);
+
+    check_fallback_to_scan(data, data_size / 2);
+
+    free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_corrupted_record_path(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    size_t data_size;
+    unsigned char *data = build_cache(&data_size);
+
+    /* Point the cached codec info outside of the codecs path keeping the string length. */
+    static const char NAME[]     = "sail-codec-aaa";
+    static const char OUTSIDE[]  = "x/../../evil/a";
+    unsigned char *record_path = NULL;
+
+    for (size_t i = 0; i + sizeof(NAME) - 1 <= data_size; i++) {
+        if (memcmp(data + i, NAME, sizeof(NAME) - 1) == 0) {
+            record_path = data + i;
+            break;
+        }
+    }
+
+    munit_assert_not_null(record_path);
+    memcpy(record_path, OUTSIDE, sizeof(OUTSIDE) - 1);
+
+    check_fallback_to_scan(data, data_size);
+
+    free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_non_writable_cache(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    prepare_codecs();
+
+    char scanned[1024];
+    list_codecs(NULL, scanned, sizeof(scanned));
+
+    char actual[1024];
+    list_codecs(TEST_DIR "/missing/registry.cache", actual, sizeof(actual));
+    munit_assert_string_equal(actual, scanned);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/round-trip",              test_round_trip,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/rewritten-codec-info",    test_rewritten_codec_info,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/stale-mtime",             test_stale_mtime,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/different-codecs-paths",  test_different_codecs_paths, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/wrong-magic",             test_wrong_magic,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/wrong-version",           test_wrong_version,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/truncated",               test_truncated,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/corrupted-record-path",   test_corrupted_record_path,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/non-writable-cache",      test_non_writable_cache,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/codec-registry-cache",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+
+    /* The codecs paths are read once per thread, so set them up before running the tests. */
+    mkdir(TEST_DIR, 0755);
+    mkdir(CODECS_PATH, 0755);
+
+    if (setenv("SAIL_CODECS_PATH", CODECS_PATH, 1) != 0 || unsetenv("SAIL_THIRD_PARTY_CODECS_PATH") != 0) {
+        return EXIT_FAILURE;
+    }
+
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,204 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+#define THREADS 16
+#define MAX_IMAGES 64
+
+struct thread_result {
+
+    sail_status_t status;
+
+    const struct sail_codec_info *codec_infos[MAX_IMAGES];
+    const struct sail_codec *codecs[MAX_IMAGES];
+};
+
+static pthread_mutex_t loads_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned loads;
+
+/* Counts codec loads. See alloc_and_load_codec(). */
+static void counting_logger(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
+    (void)level;
+    (void)file;
+    (void)line;
+    (void)args;
+
+    if (strcmp(format, "Loading %s codec from %s") == 0 || strcmp(format, "Fetching V%d functions for %s codec") == 0) {
+        pthread_mutex_lock(&loads_mutex);
+        loads++;
+        pthread_mutex_unlock(&loads_mutex);
+    }
+}
+
+static const struct sail_codec *loaded_codec(const struct sail_codec_info *codec_info) {
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        if (node->codec_bundle->codec_info == codec_info) {
+            return node->codec_bundle->codec;
+        }
+    }
+
+    return NULL;
+}
+
+/* munit assertions are not thread-safe, so threads only collect the results. */
+static void *thread_func(void *user_data) {
+
+    struct thread_result *result = user_data;
+
+    for (size_t i = 0; SAIL_TEST_IMAGES[i] != NULL; i++) {
+        const char *path = SAIL_TEST_IMAGES[i];
+        const char *extension = strrchr(path, '.');
+
+        const struct sail_codec_info *codec_info;
+        SAIL_TRY_OR_EXECUTE(sail_codec_info_from_extension(extension + 1, &codec_info),
+                            /* on error */ result->status = __sail_error_result; return NULL);
+
+        struct sail_image *image;
+        const struct sail_codec_info *probe_codec_info;
+        SAIL_TRY_OR_EXECUTE(sail_probe_file(path, &image, &probe_codec_info),
+                            /* on error */ result->status = __sail_error_result; return NULL);
+        sail_destroy_image(image);
+
+        if (probe_codec_info != codec_info) {
+            result->status = SAIL_ERROR_CODEC_NOT_FOUND;
+            return NULL;
+        }
+
+        result->codec_infos[i] = codec_info;
+        result->codecs[i]      = loaded_codec(codec_info);
+    }
+
+    result->status = SAIL_OK;
+
+    return NULL;
+}
+
+/* Probes the test images from many threads and checks every codec is shared and loaded once. */
+static void run_threads(void) {
+
+    static struct thread_result results[THREADS];
+    pthread_t threads[THREADS];
+
+    memset(results, 0, sizeof(results));
+    loads = 0;
+
+    sail_set_logger(counting_logger);
+
+    for (unsigned t = 0; t < THREADS; t++) {
+        munit_assert_int(pthread_create(&threads[t], NULL, thread_func, &results[t]), ==, 0);
+    }
+
+    for (unsigned t = 0; t < THREADS; t++) {
+        munit_assert_int(pthread_join(threads[t], NULL), ==, 0);
+    }
+
+    sail_set_logger(NULL);
+
+    const struct sail_codec_info *distinct_codec_infos[MAX_IMAGES];
+    unsigned distinct = 0;
+
+    for (size_t i = 0; SAIL_TEST_IMAGES[i] != NULL; i++) {
+        munit_assert_size(i, <, MAX_IMAGES);
+
+        for (unsigned t = 0; t < THREADS; t++) {
+            munit_assert(results[t].status == SAIL_OK);
+            munit_assert_not_null(results[t].codecs[i]);
+            munit_assert_ptr_equal(results[t].codec_infos[i], results[0].codec_infos[i]);
+            munit_assert_ptr_equal(results[t].codecs[i], results[0].codecs[i]);
+        }
+
+        bool found = false;
+
+        for (unsigned d = 0; d < distinct; d++) {
+            if (distinct_codec_infos[d] == results[0].codec_infos[i]) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            distinct_codec_infos[distinct++] = results[0].codec_infos[i];
+        }
+    }
+
+    munit_assert_uint(loads, ==, distinct);
+}
+
+static MunitResult test_fresh_context(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail_finish();
+
+    run_threads();
+
+    sail_finish();
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unloaded_codecs(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_init_with_flags(SAIL_FLAG_PRELOAD_CODECS) == SAIL_OK);
+    munit_assert(sail_unload_codecs() == SAIL_OK);
+
+    run_threads();
+
+    sail_finish();
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/fresh-context",   test_fresh_context,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unloaded-codecs", test_unloaded_codecs, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/context-threads",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
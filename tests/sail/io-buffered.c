@@ -0,0 +1,222 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#define DATA_SIZE 1000
+
+static void fill_data(unsigned char *data) {
+
+    for (unsigned i = 0; i < DATA_SIZE; i++) {
+        data[i] = (unsigned char)(i * 7 + 3);
+    }
+}
+
+static MunitResult test_io_buffered_read(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char data[DATA_SIZE];
+    fill_data(data);
+
+    struct sail_io *memory_io;
+    munit_assert(sail_alloc_io_read_memory(data, sizeof(data), &memory_io) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_buffered(memory_io, true, 16, &io) == SAIL_OK);
+    munit_assert(io->id == SAIL_BUFFERED_IO_ID);
+
+    unsigned char buf[100];
+    size_t offset = 0;
+
+    /* Tiny reads spanning multiple blocks. */
+    for (unsigned i = 0; i < 40; i++) {
+        munit_assert(io->strict_read(io->stream, buf, 1) == SAIL_OK);
+        munit_assert_uint8(buf[0], ==, data[offset]);
+        offset++;
+    }
+
+    /* A read larger than the block size. */
+    munit_assert(io->strict_read(io->stream, buf, sizeof(buf)) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(buf), buf, data + offset);
+    offset += sizeof(buf);
+
+    size_t tell;
+    munit_assert(io->tell(io->stream, &tell) == SAIL_OK);
+    munit_assert_size(tell, ==, offset);
+
+    /* Seek within and outside the buffer. */
+    munit_assert(io->strict_read(io->stream, buf, 3) == SAIL_OK);
+    munit_assert(io->seek(io->stream, -2, SEEK_CUR) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 5) == SAIL_OK);
+    munit_assert_memory_equal(5, buf, data + offset + 1);
+
+    munit_assert(io->seek(io->stream, 900, SEEK_SET) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 10) == SAIL_OK);
+    munit_assert_memory_equal(10, buf, data + 900);
+
+    munit_assert(io->seek(io->stream, 905, SEEK_SET) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &tell) == SAIL_OK);
+    munit_assert_size(tell, ==, 905);
+
+    munit_assert(io->seek(io->stream, -5, SEEK_END) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 5) == SAIL_OK);
+    munit_assert_memory_equal(5, buf, data + DATA_SIZE - 5);
+
+    /* EOF. */
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert(eof);
+    munit_assert(io->strict_read(io->stream, buf, 1) != SAIL_OK);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_io_buffered_seek_after_large_read(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char data[DATA_SIZE];
+    fill_data(data);
+
+    struct sail_io *memory_io;
+    munit_assert(sail_alloc_io_read_memory(data, sizeof(data), &memory_io) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_buffered(memory_io, true, 16, &io) == SAIL_OK);
+
+    /* Consume the whole block, then bypass the buffer with a large read. */
+    unsigned char buf[100];
+    munit_assert(io->strict_read(io->stream, buf, 1) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 15) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 100) == SAIL_OK);
+    munit_assert_memory_equal(100, buf, data + 16);
+
+    /* Seeking back must not be served from the stale block. */
+    munit_assert(io->seek(io->stream, -2, SEEK_CUR) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 1) == SAIL_OK);
+    munit_assert_uint8(buf[0], ==, data[114]);
+
+    munit_assert(io->strict_read(io->stream, buf, 1) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 100) == SAIL_OK);
+    munit_assert_memory_equal(100, buf, data + 116);
+
+    munit_assert(io->seek(io->stream, 214, SEEK_SET) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, 1) == SAIL_OK);
+    munit_assert_uint8(buf[0], ==, data[214]);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_io_buffered_rewind(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char data[DATA_SIZE];
+    fill_data(data);
+
+    struct sail_io *memory_io;
+    munit_assert(sail_alloc_io_read_memory(data, sizeof(data), &memory_io) == SAIL_OK);
+    memory_io->features = SAIL_IO_FEATURE_SEEKABLE;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_buffered(memory_io, false, 64, &io) == SAIL_OK);
+
+    unsigned char buf[10];
+    munit_assert(io->strict_read(io->stream, buf, sizeof(buf)) == SAIL_OK);
+
+    /* Not owned I/O is rewound to the consumed position. */
+    sail_destroy_io(io);
+
+    size_t tell;
+    munit_assert(memory_io->tell(memory_io->stream, &tell) == SAIL_OK);
+    munit_assert_size(tell, ==, sizeof(buf));
+
+    sail_destroy_io(memory_io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_io_buffered_borrow(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char data[DATA_SIZE];
+    fill_data(data);
+
+    struct sail_io *memory_io;
+    munit_assert(sail_alloc_io_read_memory(data, sizeof(data), &memory_io) == SAIL_OK);
+    munit_assert(memory_io->features & SAIL_IO_FEATURE_BORROWABLE);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_buffered(memory_io, true, 64, &io) == SAIL_OK);
+    munit_assert(io->features & SAIL_IO_FEATURE_BORROWABLE);
+
+    unsigned char buf[10];
+    munit_assert(io->strict_read(io->stream, buf, sizeof(buf)) == SAIL_OK);
+
+    /* Borrowed data starts at the consumed position, not at the buffered one. */
+    const void *borrowed_data;
+    size_t borrowed_data_size;
+    void *allocated_data;
+    munit_assert(sail_alloc_or_borrow_data_from_io_contents(io, &borrowed_data, &borrowed_data_size, &allocated_data) == SAIL_OK);
+    munit_assert_null(allocated_data);
+    munit_assert_ptr_equal(borrowed_data, data + sizeof(buf));
+    munit_assert_size(borrowed_data_size, ==, DATA_SIZE - sizeof(buf));
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read",                  test_io_buffered_read,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/seek-after-large-read", test_io_buffered_seek_after_large_read, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/rewind",                test_io_buffered_rewind,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/borrow",                test_io_buffered_borrow,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/io-buffered",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
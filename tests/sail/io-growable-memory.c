@@ -0,0 +1,194 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_io_growable_memory_write(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer = (void *)&buffer;
+    size_t buffer_length = 1;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(16, &buffer, &buffer_length, &io) == SAIL_OK);
+    munit_assert_null(buffer);
+    munit_assert_size(buffer_length, ==, 0);
+
+    /* Grow far beyond the size hint. */
+    unsigned char data[1000];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 7 + 3);
+    }
+
+    for (unsigned i = 0; i < 10; i++) {
+        munit_assert(io->strict_write(io->stream, data, sizeof(data)) == SAIL_OK);
+    }
+
+    /* Overwrite the header and read it back. */
+    munit_assert(io->seek(io->stream, 0, SEEK_SET) == SAIL_OK);
+    munit_assert(io->strict_write(io->stream, "SAIL", 4) == SAIL_OK);
+
+    unsigned char buf[4];
+    munit_assert(io->seek(io->stream, 0, SEEK_SET) == SAIL_OK);
+    munit_assert(io->strict_read(io->stream, buf, sizeof(buf)) == SAIL_OK);
+    munit_assert_memory_equal(4, buf, "SAIL");
+
+    /* Seeking past the end leaves a zeroed gap. */
+    munit_assert(io->seek(io->stream, 10, SEEK_END) == SAIL_OK);
+    munit_assert(io->strict_write(io->stream, "!", 1) == SAIL_OK);
+
+    size_t tell;
+    munit_assert(io->tell(io->stream, &tell) == SAIL_OK);
+    munit_assert_size(tell, ==, 10 * sizeof(data) + 11);
+
+    munit_assert(io->seek(io->stream, -5, SEEK_SET) != SAIL_OK);
+
+    /* Closing transfers the data. */
+    sail_destroy_io(io);
+
+    munit_assert_not_null(buffer);
+    munit_assert_size(buffer_length, ==, 10 * sizeof(data) + 11);
+
+    const unsigned char *output = buffer;
+    munit_assert_memory_equal(4, output, "SAIL");
+    munit_assert_memory_equal(sizeof(data) - 4, output + 4, data + 4);
+    munit_assert_memory_equal(sizeof(data), output + 9 * sizeof(data), data);
+
+    for (unsigned i = 0; i < 10; i++) {
+        munit_assert_uint8(output[10 * sizeof(data) + i], ==, 0);
+    }
+
+    munit_assert_uint8(output[buffer_length - 1], ==, '!');
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_io_growable_memory_empty(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer;
+    size_t buffer_length;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(0, &buffer, &buffer_length, &io) == SAIL_OK);
+
+    sail_destroy_io(io);
+
+    munit_assert_null(buffer);
+    munit_assert_size(buffer_length, ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_into_growable_memory(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    bool can_save = false;
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == image->pixel_format) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_length;
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(&buffer, &buffer_length, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+
+    munit_assert_not_null(buffer);
+    munit_assert(buffer_length > 0);
+
+    /* The encoded data must load back into the same image. */
+    struct sail_image *image_mem = NULL;
+    munit_assert(sail_start_loading_from_memory(buffer, buffer_length, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image_mem) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_uint(image_mem->width, ==, image->width);
+    munit_assert_uint(image_mem->height, ==, image->height);
+    munit_assert_int(image_mem->pixel_format, ==, image->pixel_format);
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image_mem->pixels, image->pixels);
+
+    sail_free(buffer);
+    sail_destroy_image(image_mem);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/write",                    test_io_growable_memory_write,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/empty",                    test_io_growable_memory_empty,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save-into-growable-memory", test_save_into_growable_memory, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/io-growable-memory",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -70,13 +70,91 @@ static MunitResult test_io_produce_same_images(const MunitParameter params[], vo
     return MUNIT_OK;
 }
 
+static MunitResult test_mmap_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_mmap(path, &io) == SAIL_OK);
+    munit_assert(io->id == SAIL_MMAP_IO_ID);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_mmap = NULL;
+    munit_assert(sail_load_next_frame(state, &image_mmap) == SAIL_OK);
+    munit_assert_not_null(image_mmap);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    sail_destroy_io(io);
+
+    munit_assert(sail_test_compare_images(image_file, image_mmap) == SAIL_OK);
+
+    sail_destroy_image(image_mmap);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_buffer_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const size_t pixels_size = (size_t)image_file->height * image_file->bytes_per_line;
+
+    /* Too small buffer. */
+    void *state;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image_buffer = NULL;
+    unsigned char small_buffer[1];
+    munit_assert(sail_load_next_frame_into_buffer(state, small_buffer, sizeof(small_buffer), &image_buffer) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert_null(image_buffer);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    /* Enough space. */
+    void *buffer;
+    munit_assert(sail_malloc(pixels_size, &buffer) == SAIL_OK);
+
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame_into_buffer(state, buffer, pixels_size, &image_buffer) == SAIL_OK);
+    munit_assert_not_null(image_buffer);
+    munit_assert_null(image_buffer->pixels);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    image_buffer->pixels = buffer;
+    munit_assert(sail_test_compare_images(image_file, image_buffer) == SAIL_OK);
+
+    sail_destroy_image(image_buffer);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
 static MunitParameterEnum test_params[] = {
     { (char *)"path", (char **)SAIL_TEST_IMAGES },
     { NULL, NULL },
 };
 
 static MunitTest test_suite_tests[] = {
-    { (char *)"/io-produce-same-images", test_io_produce_same_images, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/io-produce-same-images",      test_io_produce_same_images,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/mmap-produces-same-images",   test_mmap_produces_same_images,   NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/buffer-produces-same-images", test_buffer_produces_same_images, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,290 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sail.h"
+
+#include "munit.h"
+
+static const unsigned WIDTH  = 64;
+static const unsigned HEIGHT = 48;
+
+/* Encodes a synthetic RGB image into JPEG. */
+static void encode_jpeg(const struct sail_codec_info *codec_info, void **buffer, size_t *buffer_length) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+    munit_assert(sail_malloc(pixels_size, &image->pixels) == SAIL_OK);
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        ((unsigned char *)image->pixels)[i] = (unsigned char)(i * 13);
+    }
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(buffer, buffer_length, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static void load_with_tuning_options(const struct sail_codec_info *codec_info, const void *buffer, size_t buffer_length,
+                                     struct sail_load_options *load_options, struct sail_image **image) {
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_length, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_size((size_t)(*image)->bytes_per_line, ==, sail_bytes_per_line((*image)->width, (*image)->pixel_format));
+}
+
+static void load_with_tuning(const struct sail_codec_info *codec_info, const void *buffer, size_t buffer_length,
+                             const char *key, unsigned value, struct sail_image **image) {
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    munit_assert(sail_alloc_hash_map(&load_options->tuning) == SAIL_OK);
+
+    struct sail_variant *variant;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+    munit_assert(sail_set_variant_unsigned_int(variant, value) == SAIL_OK);
+    munit_assert(sail_put_hash_map(load_options->tuning, key, variant) == SAIL_OK);
+    sail_destroy_variant(variant);
+
+    load_with_tuning_options(codec_info, buffer, buffer_length, load_options, image);
+
+    sail_destroy_load_options(load_options);
+}
+
+static MunitResult test_scale_denominator(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_length;
+    encode_jpeg(codec_info, &buffer, &buffer_length);
+
+    const unsigned denominators[] = { 1, 2, 4, 8 };
+
+    for (unsigned i = 0; i < sizeof(denominators) / sizeof(denominators[0]); i++) {
+        struct sail_image *image;
+        load_with_tuning(codec_info, buffer, buffer_length, "jpeg-scale-denominator", denominators[i], &image);
+
+        munit_assert_uint(image->width,  ==, WIDTH  / denominators[i]);
+        munit_assert_uint(image->height, ==, HEIGHT / denominators[i]);
+
+        sail_destroy_image(image);
+    }
+
+    /* Unsupported denominators are ignored. */
+    struct sail_image *image;
+    load_with_tuning(codec_info, buffer, buffer_length, "jpeg-scale-denominator", 3, &image);
+    munit_assert_uint(image->width,  ==, WIDTH);
+    munit_assert_uint(image->height, ==, HEIGHT);
+    sail_destroy_image(image);
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_max_dimension(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_length;
+    encode_jpeg(codec_info, &buffer, &buffer_length);
+
+    /* The larger side never gets smaller than the requested dimension. */
+    const unsigned max_dimensions[]   = { 100, 64, 33, 32, 20, 8, 1 };
+    const unsigned expected_widths[]  = { 64,  64, 64, 32, 32, 8, 8 };
+
+    for (unsigned i = 0; i < sizeof(max_dimensions) / sizeof(max_dimensions[0]); i++) {
+        struct sail_image *image;
+        load_with_tuning(codec_info, buffer, buffer_length, "jpeg-max-dimension", max_dimensions[i], &image);
+
+        munit_assert_uint(image->width,  ==, expected_widths[i]);
+        munit_assert_uint(image->height, ==, HEIGHT * expected_widths[i] / WIDTH);
+
+        sail_destroy_image(image);
+    }
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_parallel_decoding(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    /* Odd sizes to check partial MCUs at the right and bottom edges. */
+    image->width          = 211;
+    image->height         = 397;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+    munit_assert(sail_malloc(pixels_size, &image->pixels) == SAIL_OK);
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        ((unsigned char *)image->pixels)[i] = (unsigned char)((i * 7) ^ (i / image->bytes_per_line));
+    }
+
+    /* Restart markers every MCU row. */
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    munit_assert(sail_alloc_hash_map(&save_options->tuning) == SAIL_OK);
+
+    struct sail_variant *variant;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+    munit_assert(sail_set_variant_unsigned_int(variant, 1) == SAIL_OK);
+    munit_assert(sail_put_hash_map(save_options->tuning, "jpeg-restart-rows", variant) == SAIL_OK);
+    sail_destroy_variant(variant);
+
+    void *buffer;
+    size_t buffer_length;
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(0, &buffer, &buffer_length, codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    /* Parallel decoding produces exactly the same pixels as serial decoding. */
+    struct sail_image *serial_image;
+    load_with_tuning(codec_info, buffer, buffer_length, "jpeg-threads", 1, &serial_image);
+
+    const unsigned threads[] = { 2, 3, 8, 64 };
+
+    for (unsigned i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        struct sail_image *parallel_image;
+        load_with_tuning(codec_info, buffer, buffer_length, "jpeg-threads", threads[i], &parallel_image);
+
+        munit_assert_uint(parallel_image->width,  ==, serial_image->width);
+        munit_assert_uint(parallel_image->height, ==, serial_image->height);
+        munit_assert_memory_equal((size_t)serial_image->height * serial_image->bytes_per_line,
+                                  parallel_image->pixels, serial_image->pixels);
+
+        sail_destroy_image(parallel_image);
+    }
+
+    sail_destroy_image(serial_image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_fast_decoding(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_length;
+    encode_jpeg(codec_info, &buffer, &buffer_length);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    munit_assert(sail_alloc_hash_map(&load_options->tuning) == SAIL_OK);
+
+    struct sail_variant *variant;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+
+    munit_assert(sail_set_variant_string(variant, "fast") == SAIL_OK);
+    munit_assert(sail_put_hash_map(load_options->tuning, "jpeg-dct-method", variant) == SAIL_OK);
+
+    munit_assert(sail_set_variant_bool(variant, false) == SAIL_OK);
+    munit_assert(sail_put_hash_map(load_options->tuning, "jpeg-fancy-upsampling", variant) == SAIL_OK);
+    munit_assert(sail_put_hash_map(load_options->tuning, "jpeg-block-smoothing", variant) == SAIL_OK);
+
+    sail_destroy_variant(variant);
+
+    /* The fast path changes the pixels slightly, but never the geometry. */
+    struct sail_image *image;
+    load_with_tuning_options(codec_info, buffer, buffer_length, load_options, &image);
+
+    munit_assert_uint(image->width,  ==, WIDTH);
+    munit_assert_uint(image->height, ==, HEIGHT);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/scale-denominator", test_scale_denominator, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/max-dimension",     test_max_dimension,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/parallel-decoding", test_parallel_decoding, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/fast-decoding",     test_fast_decoding,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/jpeg-load-tuning",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,247 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "sail.h"
+#include "sail-manip.h"
+
+#include "munit.h"
+
+static const unsigned WIDTH  = 37;
+static const unsigned HEIGHT = 23;
+
+static void create_image(enum SailPixelFormat pixel_format, struct sail_image **image) {
+
+    munit_assert(sail_alloc_image(image) == SAIL_OK);
+
+    (*image)->width          = WIDTH;
+    (*image)->height         = HEIGHT;
+    (*image)->pixel_format   = pixel_format;
+    (*image)->bytes_per_line = sail_bytes_per_line((*image)->width, (*image)->pixel_format);
+
+    const size_t pixels_size = (size_t)(*image)->height * (*image)->bytes_per_line;
+    munit_assert(sail_malloc(pixels_size, &(*image)->pixels) == SAIL_OK);
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        ((unsigned char *)(*image)->pixels)[i] = (unsigned char)(i * 13 + i / 7);
+    }
+
+    if (pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED) {
+        munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, &(*image)->palette) == SAIL_OK);
+
+        for (unsigned i = 0; i < 256 * 3; i++) {
+            ((unsigned char *)(*image)->palette->data)[i] = (unsigned char)(i * 5);
+        }
+    }
+}
+
+static void encode(const struct sail_codec_info *codec_info, enum SailPixelFormat pixel_format, void **buffer, size_t *buffer_length) {
+
+    struct sail_image *image;
+    create_image(pixel_format, &image);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(buffer, buffer_length, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static void load(const struct sail_codec_info *codec_info, const void *buffer, size_t buffer_length,
+                 enum SailPixelFormat output_pixel_format, struct sail_image **image) {
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->output_pixel_format = output_pixel_format;
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_length, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+
+    munit_assert_size((size_t)(*image)->bytes_per_line, ==, sail_bytes_per_line((*image)->width, (*image)->pixel_format));
+}
+
+/* Loads the image in the output pixel format and checks it against converting the native image. */
+static void assert_output_pixel_format(const struct sail_codec_info *codec_info, const void *buffer, size_t buffer_length,
+                                       const struct sail_image *native_image, enum SailPixelFormat output_pixel_format) {
+
+    struct sail_image *image;
+    load(codec_info, buffer, buffer_length, output_pixel_format, &image);
+
+    munit_assert_int(image->pixel_format, ==, output_pixel_format);
+    munit_assert_uint(image->width,  ==, native_image->width);
+    munit_assert_uint(image->height, ==, native_image->height);
+    munit_assert_null(image->palette);
+
+    struct sail_image *converted_image;
+    munit_assert(sail_convert_image(native_image, output_pixel_format, &converted_image) == SAIL_OK);
+
+    /* Rounding may differ by 1. */
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan1 = (const unsigned char *)image->pixels + (size_t)row * image->bytes_per_line;
+        const unsigned char *scan2 = (const unsigned char *)converted_image->pixels + (size_t)row * converted_image->bytes_per_line;
+
+        for (unsigned i = 0; i < image->bytes_per_line; i++) {
+            munit_assert_int(abs(scan1[i] - scan2[i]), <=, 1);
+        }
+    }
+
+    sail_destroy_image(converted_image);
+    sail_destroy_image(image);
+}
+
+static MunitResult test_jpeg(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_length;
+    encode(codec_info, SAIL_PIXEL_FORMAT_BPP24_RGB, &buffer, &buffer_length);
+
+    struct sail_image *native_image;
+    load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_UNKNOWN, &native_image);
+    munit_assert_int(native_image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    assert_output_pixel_format(codec_info, buffer, buffer_length, native_image, SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    /* Extended color spaces are available with libjpeg-turbo only. */
+    struct sail_image *image;
+    load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image);
+    const bool have_jcs_ext = image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    sail_destroy_image(image);
+
+    const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP24_BGR,
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+        SAIL_PIXEL_FORMAT_BPP32_ARGB,
+        SAIL_PIXEL_FORMAT_BPP32_ABGR,
+    };
+
+    for (unsigned i = 0; have_jcs_ext && i < sizeof(pixel_formats) / sizeof(pixel_formats[0]); i++) {
+        assert_output_pixel_format(codec_info, buffer, buffer_length, native_image, pixel_formats[i]);
+    }
+
+    /* Padding bytes are undefined, so check the pixel format only. */
+    load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_BPP32_XBGR, &image);
+    munit_assert_int(image->pixel_format, ==, have_jcs_ext ? SAIL_PIXEL_FORMAT_BPP32_XBGR : SAIL_PIXEL_FORMAT_BPP24_RGB);
+    sail_destroy_image(image);
+
+    /* Grayscale is taken from the luma channel. */
+    load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &image);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+    sail_destroy_image(image);
+
+    /* Unsupported output pixel formats fall back to the native pixel format. */
+    load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image);
+    munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+    sail_destroy_image(image);
+
+    sail_destroy_image(native_image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_png(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    const enum SailPixelFormat input_pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    };
+
+    const enum SailPixelFormat output_pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP24_BGR,
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+        SAIL_PIXEL_FORMAT_BPP32_ARGB,
+        SAIL_PIXEL_FORMAT_BPP32_ABGR,
+    };
+
+    for (unsigned i = 0; i < sizeof(input_pixel_formats) / sizeof(input_pixel_formats[0]); i++) {
+        void *buffer;
+        size_t buffer_length;
+        encode(codec_info, input_pixel_formats[i], &buffer, &buffer_length);
+
+        struct sail_image *native_image;
+        load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_UNKNOWN, &native_image);
+        munit_assert_int(native_image->pixel_format, ==, input_pixel_formats[i]);
+
+        for (unsigned j = 0; j < sizeof(output_pixel_formats) / sizeof(output_pixel_formats[0]); j++) {
+            assert_output_pixel_format(codec_info, buffer, buffer_length, native_image, output_pixel_formats[j]);
+        }
+
+        /* Grayscale is supported for grayscale images only. */
+        struct sail_image *image;
+        load(codec_info, buffer, buffer_length, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &image);
+        munit_assert_int(image->pixel_format, ==, input_pixel_formats[i]);
+        sail_destroy_image(image);
+
+        sail_destroy_image(native_image);
+        sail_free(buffer);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/jpeg", test_jpeg, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/png",  test_png,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-output-pixel-format",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,121 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2022 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+/* Returns MUNIT_SKIP if the codec is not enabled. */
+static MunitResult check_magic_number(const unsigned char *magic_number, size_t magic_number_length, const char *expected_extension) {
+
+    const struct sail_codec_info *expected_codec_info;
+    if (sail_codec_info_from_extension(expected_extension, &expected_codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* The magic number buffer is read completely, so pad the data. */
+    unsigned char buffer[64] = { 0 };
+    memcpy(buffer, magic_number, magic_number_length);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_by_magic_number_from_memory(buffer, sizeof(buffer), &codec_info) == SAIL_OK);
+    munit_assert_ptr_equal(codec_info, expected_codec_info);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_png(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const unsigned char MAGIC_NUMBER[] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    return check_magic_number(MAGIC_NUMBER, sizeof(MAGIC_NUMBER), "png");
+}
+
+static MunitResult test_jpeg(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const unsigned char MAGIC_NUMBER[] = { 0xFF, 0xD8, 0xFF, 0xE0 };
+
+    return check_magic_number(MAGIC_NUMBER, sizeof(MAGIC_NUMBER), "jpg");
+}
+
+static MunitResult test_second_magic_number(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* ICO has "00 00 01 00" and "00 00 02 00" for cursors. */
+    static const unsigned char MAGIC_NUMBER[] = { 0x00, 0x00, 0x02, 0x00 };
+
+    return check_magic_number(MAGIC_NUMBER, sizeof(MAGIC_NUMBER), "cur");
+}
+
+static MunitResult test_wildcard(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* WEBP is "52 49 46 46 ?? ?? ?? ?? 57 45 42 50". */
+    static const unsigned char MAGIC_NUMBER[] = { 0x52, 0x49, 0x46, 0x46, 0x12, 0x34, 0x56, 0x78, 0x57, 0x45, 0x42, 0x50 };
+
+    return check_magic_number(MAGIC_NUMBER, sizeof(MAGIC_NUMBER), "webp");
+}
+
+static MunitResult test_unknown(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const unsigned char buffer[64] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0B };
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_by_magic_number_from_memory(buffer, sizeof(buffer), &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/png",                 test_png,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jpeg",                test_jpeg,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/second-magic-number", test_second_magic_number, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/wildcard",            test_wildcard,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unknown",             test_unknown,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/magic-numbers",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}